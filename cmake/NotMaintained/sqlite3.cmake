@@ -50,6 +50,9 @@ else()
 	)
 endif()
 
+# public, the app read sqlite3_stmt_scanstatus_v2 and the column origins only when they are available
+target_compile_definitions(sqlite3 PUBLIC SQLITE_ENABLE_STMT_SCANSTATUS SQLITE_ENABLE_COLUMN_METADATA)
+
 if(USE_SHARED_LIBS)
 	set_target_properties(sqlite3 PROPERTIES FOLDER 3rdparty/Shared)
 else()
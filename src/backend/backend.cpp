@@ -44,6 +44,14 @@
 #include <LayoutManager.h>
 
 #include <backend/helpers/dbHelper.h>
+#include <backend/helpers/dbBackup.h>
+#include <backend/helpers/blobTransfer.h>
+#include <backend/helpers/queryProfiler.h>
+#include <backend/helpers/csvImporter.h>
+#include <backend/helpers/resultExporter.h>
+#include <backend/helpers/indexAdvisor.h>
+#include <backend/managers/jobManager.h>
+#include <backend/helpers/frameScheduler.h>
 #include <backend/controller/controller.h>
 
 #include <imguipack.h>
@@ -57,6 +65,7 @@
 #include <frontend/panes/MessagePane.h>
 
 #include <backend/managers/dbManager.h>
+#include <backend/managers/queryManager.h>
 
 // we include the cpp just for embedded fonts
 #include <resources/fontIcons.cpp>
@@ -92,6 +101,7 @@ bool Backend::init(const ez::App& vApp) {
 #endif
     m_InitModels();
     if (m_InitWindow() && m_InitImGui()) {
+        FrameScheduler::ref().setWakeUpFunctor([]() { glfwPostEmptyEvent(); });
         m_InitSystems();
         m_InitPanes();
         LoadConfigFile("config.xml", "app");
@@ -104,14 +114,24 @@ void Backend::run() {
     int display_w, display_h;
     ImRect viewRect;
     while (!glfwWindowShouldClose(m_MainWindowPtr)) {
+        // wait the inputs, or the end of a background work who wake up the loop
+        const double waitTimeoutSec = FrameScheduler::ref().getWaitTimeoutSec(m_isBackgroundWorkRunning(), m_isImGuiAnimating());
+        if (waitTimeoutSec > 0.0) {
+            glfwWaitEventsTimeout(waitTimeoutSec);
+        } else {
+            glfwPollEvents();
+        }
+        if (!ImGui::GetCurrentContext()->InputEventsQueue.empty()) {
+            FrameScheduler::ref().onInputs();
+        }
+
         DBManager::ref().newFrame();
+        QueryManager::ref().newFrame();  // apply the results of the finished queries
 
         // maintain active, prevent user change via imgui dialog
         ImGui::GetIO().ConfigFlags |= ImGuiConfigFlags_DockingEnable;    // Enable Docking
         ImGui::GetIO().ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;  // Disable Viewport
 
-        glfwPollEvents();
-
         glfwGetFramebufferSize(m_MainWindowPtr, &display_w, &display_h);
 
         m_update();  // to do absolutly before imgui rendering
@@ -154,9 +174,6 @@ void Backend::run() {
         PostRenderingActions();
 
         ++m_CurrentFrame;
-
-        // will pause the view until we move the mouse or press keys
-        // glfwWaitEvents();
     }
 }
 
@@ -164,6 +181,7 @@ void Backend::run() {
 void Backend::unit() {
     SaveConfigFile("config.xml", "app", "config");
     m_UnitSystems();
+    FrameScheduler::ref().setWakeUpFunctor(nullptr);  // glfw will be terminated
     m_UnitImGui();
     m_UnitWindow();
     m_UnitModels();
@@ -183,6 +201,15 @@ void Backend::NeedToLoadDatabase(const std::string& vFilePathName) {
     m_DatabaseFileToLoad = vFilePathName;
 }
 
+void Backend::NeedToNewMemoryDatabase() {
+    m_NeedToNewMemoryDatabase = true;
+}
+
+void Backend::NeedToLoadDatabaseInMemory(const std::string& vFilePathName) {
+    m_NeedToLoadDatabaseInMemory = true;
+    m_DatabaseFileToLoad = vFilePathName;
+}
+
 void Backend::NeedToCloseDatabase() {
     m_NeedToCloseDatabase = true;
 }
@@ -201,6 +228,25 @@ void Backend::PostRenderingActions() {
             setAppTitle(m_DatabaseFileToLoad);
         }
     }
+    if (m_NeedToNewMemoryDatabase) {
+        m_NeedToNewMemoryDatabase = false;
+        if (DBManager::ref().newDatabaseFromMemory()) {
+            setAppTitle();
+        }
+    }
+    if (m_NeedToLoadDatabaseInMemory) {
+        m_NeedToLoadDatabaseInMemory = false;
+        if (DBManager::ref().loadDatabaseInMemory(m_DatabaseFileToLoad)) {
+            setAppTitle();
+        }
+    }
+    if (m_NeedToCloseDatabase) {
+        m_NeedToCloseDatabase = false;
+        DBManager::ref().clear();  // will close the db connection
+        Controller::ref().clearAnalyze();
+        setAppTitle();
+    }
+    JobManager::ref().processCompletions();
     Controller::ref().doActions();
 }
 
@@ -274,6 +320,8 @@ bool Backend::GetConsoleVisibility() {
 ez::xml::Nodes Backend::getXmlNodes(const std::string& vUserDatas) {
     ez::xml::Node node;
     node.addChild("database").setContent(DBManager::ref().getDatabaseFilepathName());
+    node.addChild("event_driven_rendering").setContent(FrameScheduler::ref().isEventDriven());
+    node.addChild("busy_fps").setContent(FrameScheduler::ref().getBusyFps());
     node.addChilds(Controller::ref().getXmlNodes(vUserDatas));
     node.addChilds(Frontend::ref().getXmlNodes(vUserDatas));
     return node.getChildren();
@@ -285,6 +333,10 @@ bool Backend::setFromXmlNodes(const ez::xml::Node& vNode, const ez::xml::Node& v
     const auto& strParentName = vParent.getName();
     if (strName == "database") {
         NeedToLoadDatabase(strValue);
+    } else if (strName == "event_driven_rendering") {
+        FrameScheduler::ref().setEventDriven(ez::ivariant(strValue).GetB());
+    } else if (strName == "busy_fps") {
+        FrameScheduler::ref().setBusyFps(ez::ivariant(strValue).GetI());
     }
     Controller::ref().setFromXmlNodes(vNode, vParent, vUserDatas);
     Frontend::ref().setFromXmlNodes(vNode, vParent, vUserDatas);
@@ -303,6 +355,20 @@ void Backend::m_IncFrame() {
     ++m_CurrentFrame;
 }
 
+// the imports, exports, backups, transfers and advisors are jobs of the JobManager
+bool Backend::m_isBackgroundWorkRunning() const {
+    return QueryManager::ref().isBusy() || JobManager::ref().isBusy();
+}
+
+// imgui draw some changes without inputs
+bool Backend::m_isImGuiAnimating() const {
+    const auto& io = ImGui::GetIO();
+    return io.WantTextInput ||              // text cursor blinking
+        ImGui::IsAnyItemActive() ||         // dragging
+        ImGui::IsAnyItemHovered() ||        // tooltip delay
+        ImGui::IsAnyMouseDown();
+}
+
 //////////////////////////////////////////////////////////////////////////////////
 //// PRIVATE /////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////
@@ -405,16 +471,58 @@ bool Backend::m_InitImGui() {
 }
 
 void Backend::m_InitModels() {
+    FrameScheduler::initSingleton();
+    FrameScheduler::ref().init();
+    QueryProfiler::initSingleton();  // before the db, who attach its connections to it
+    QueryProfiler::ref().init();
     DBHelper::initSingleton();
 }
 
 void Backend::m_UnitModels() {
+    DBHelper::ref().unit();
     DBHelper::unitSingleton();
+    QueryProfiler::ref().unit();
+    QueryProfiler::unitSingleton();
+    FrameScheduler::ref().unit();
+    FrameScheduler::unitSingleton();
 }
 
-void Backend::m_InitSystems() {}
+void Backend::m_InitSystems() {
+    QueryManager::initSingleton();
+    QueryManager::ref().init();
+    JobManager::initSingleton();
+    JobManager::ref().init();
+    CsvImporter::initSingleton();
+    CsvImporter::ref().init();
+    ResultExporter::initSingleton();
+    ResultExporter::ref().init();
+    DBBackup::initSingleton();
+    DBBackup::ref().init();
+    IndexAdvisor::initSingleton();
+    IndexAdvisor::ref().init();
+    BlobTransfer::initSingleton();
+    BlobTransfer::ref().init();
+    Controller::ref().init();
+}
 
-void Backend::m_UnitSystems() {}
+void Backend::m_UnitSystems() {
+    Controller::ref().unit();
+    // before the JobManager, their jobs are canceled
+    BlobTransfer::ref().unit();
+    BlobTransfer::unitSingleton();
+    IndexAdvisor::ref().unit();
+    IndexAdvisor::unitSingleton();
+    DBBackup::ref().unit();
+    DBBackup::unitSingleton();
+    ResultExporter::ref().unit();
+    ResultExporter::unitSingleton();
+    CsvImporter::ref().unit();
+    CsvImporter::unitSingleton();
+    JobManager::ref().unit();
+    JobManager::unitSingleton();
+    QueryManager::ref().unit();
+    QueryManager::unitSingleton();
+}
 
 void Backend::m_InitPanes() {
     if (LayoutManager::ref().InitPanes()) {
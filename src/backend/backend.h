@@ -63,6 +63,8 @@ private:
 
     bool m_NeedToNewDatabase = false;
     bool m_NeedToLoadDatabase = false;
+    bool m_NeedToNewMemoryDatabase = false;
+    bool m_NeedToLoadDatabaseInMemory = false;
     bool m_NeedToCloseDatabase = false;
     std::string m_DatabaseFileToLoad;
 
@@ -84,6 +86,8 @@ public:
 
     void NeedToNewDatabase(const std::string& vFilePathName);
     void NeedToLoadDatabase(const std::string& vFilePathName);
+    void NeedToNewMemoryDatabase();
+    void NeedToLoadDatabaseInMemory(const std::string& vFilePathName);
     void NeedToCloseDatabase();
 
     void PostRenderingActions();
@@ -123,4 +127,6 @@ private:
 
     void m_update();
     void m_IncFrame();
+    bool m_isBackgroundWorkRunning() const;
+    bool m_isImGuiAnimating() const;
 };
@@ -19,33 +19,138 @@
 
 #include "controller.h"
 #include <resources/fontIcons.h>
+#include <frontend/frontend.h>
 #include <frontend/components/codeEditor.h>
 #include <backend/managers/dbManager.h>
+#include <backend/helpers/csvImporter.h>
+#include <backend/helpers/blobTransfer.h>
+#include <backend/managers/jobManager.h>
 #include <ezlibs/ezSqlite.hpp>
 #include <ezlibs/ezFile.hpp>
 #include <ezlibs/ezLog.hpp>
+#include <ezlibs/ezTools.hpp>
 #include <filesystem>
+#include <algorithm>
+#include <cmath>
 
 namespace fs = std::filesystem;
 
+const int32_t Controller::s_prefetchRowsMargin = 64;
+const int32_t Controller::s_maxTableColumns = 256;
+const int32_t Controller::s_frozenColumnsCount = 1;
+const size_t Controller::s_maxQueryPlans = 20U;
+const size_t Controller::s_slowestQueriesCount = 5U;
+
 bool Controller::init() {
-        return true;
+    for (const auto type : {SqliteType::TYPE_INTEGER, SqliteType::TYPE_REAL, SqliteType::TYPE_TEXT, SqliteType::TYPE_BLOB, SqliteType::TYPE_NULL}) {
+        m_cellTextCache.setTypeColor(type, m_getSqliteTypeColor(type));
+    }
+    return true;
 }
 
-void Controller::unit() {}
+void Controller::unit() {
+    m_stopCursorFetch();
+    m_valueViewer.clearImages();  // before the end of the gl context
+}
+
+size_t Database::mergeTables(std::vector<TableDatas>&& vTables) {
+    size_t changesCount = 0U;
+    auto itOld = tables.begin();
+    for (auto& table : vTables) {
+        while (itOld != tables.end() && itOld->name < table.name) {
+            ++changesCount;  // removed
+            ++itOld;
+        }
+        if (itOld != tables.end() && itOld->name == table.name) {
+            if (itOld->sql == table.sql) {
+                table = std::move(*itOld);
+            } else {
+                table.expanded = itOld->expanded;  // the fields will be loaded again
+                ++changesCount;
+            }
+            ++itOld;
+        } else {
+            ++changesCount;  // added
+        }
+    }
+    changesCount += static_cast<size_t>(std::distance(itOld, tables.end()));
+    tables = std::move(vTables);  // always, the unchanged tables were moved in it
+    return changesCount;
+}
 
 void Controller::clearAnalyze() {
      m_databases.clear();
+     m_schemaVersion = -1;
+     m_analyzeAgain = false;
+     ++m_analyzeGeneration;
+     m_structureRows.clear();
+     m_structureRowsDirty = true;
+}
+
+// the cursor hold an opened statement, it must be closed before the db
+void Controller::clearResults() {
+    m_stopCursorFetch();
+    m_queryCursor.reset();
+    m_resultSql.clear();
+    m_scriptResult.clear();
+    m_scriptStatementIdx = -1;
+    m_scriptStatementToSelect = -1;
+    m_selRow = -1;
+    m_selCol = -1;
+    m_valueViewer.clear();
+    m_valueViewer.clearImages();
+    m_cellTextCache.clear();
+    m_wideGridColumnOffsets.clear();
 }
 
 bool Controller::drawMenu(float& vOutWidth) {
     bool needQueryExecution = false;
     float last_cur_pos = ImGui::GetCursorPosX();
-    if (ImGui::MenuItem(ICON_FONT_PLAY " Execute query (F9)", "Execute query")) {
-        needQueryExecution = true;
+    const bool isRunning = isQueryRunning();
+    if (isRunning) {
+        if (m_queryJob != nullptr && !m_queryJob->isFinished()) {
+            ImGui::Text("Running... %zu rows (%.1f s)", m_queryJob->getRowsCount(), m_queryJob->getElapsedMs() / 1000.0);
+        } else {
+            ImGui::Text("Creating the index... (%.1f s)", m_indexJob->getElapsedMs() / 1000.0);
+        }
+        if (ImGui::MenuItem(ICON_FONT_STOP " Stop", "Stop query")) {
+            cancelQuery();
+        }
+    } else {
+        if (ImGui::MenuItem(ICON_FONT_PLAY " Execute query (F9)", "Execute query")) {
+            needQueryExecution = true;
+        }
+        if (ImGui::MenuItem(ICON_FONT_SITEMAP " Explain", "Explain query plan", false, m_explainJob == nullptr)) {
+            explainQuery(CodeEditor::ref().getCode());
+        }
+        if (ImGui::BeginMenu(ICON_FONT_TUNE " Advise indexes")) {
+            const bool advising = IndexAdvisor::ref().isRunning();
+            if (ImGui::MenuItem("For the editor query", nullptr, false, !advising)) {
+                adviseIndexes({CodeEditor::ref().getCode()});
+            }
+            const auto label = ez::str::toStr("For the %zu slowest executed queries", s_slowestQueriesCount);
+            if (ImGui::MenuItem(label.c_str(), nullptr, false, !advising)) {
+                adviseIndexes(m_getSlowestQueries(s_slowestQueriesCount));
+            }
+            ImGui::EndMenu();
+        }
+    }
+    if (ImGui::BeginMenu(ICON_FONT_CLOCK_OUTLINE " Timeout")) {
+        ImGui::SetNextItemWidth(150.0f);
+        if (ImGui::InputInt("ms (0 for none)", &m_queryTimeoutMs, 100, 1000)) {
+            m_queryTimeoutMs = std::max(m_queryTimeoutMs, 0);
+        }
+        ImGui::EndMenu();
+    }
+    if (ImGui::BeginMenu(ICON_FONT_SCRIPT_TEXT " Script")) {
+        ImGui::MenuItem("Run in a single transaction", nullptr, &m_scriptInTransaction);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("All the statements are rollbacked if one fail.\nThe script must not contain its own BEGIN/COMMIT");
+        }
+        ImGui::EndMenu();
     }
     vOutWidth = ImGui::GetCursorPosX() - last_cur_pos + ImGui::GetStyle().FramePadding.x;
-    if (ImGui::IsKeyPressed(ImGuiKey_F9)) {
+    if (!isRunning && ImGui::IsKeyPressed(ImGuiKey_F9)) {
         needQueryExecution = true;
     }
     bool ret = false;
@@ -59,68 +164,118 @@ bool Controller::drawMenu(float& vOutWidth) {
 }
 
 bool Controller::analyzeDatabase(const std::string& vDatabaseFilePathName) {
-    bool ret = false;
-    if (fs::exists(vDatabaseFilePathName)) {
-        if (DBHelper::ref().openDBFile(vDatabaseFilePathName)) {
-            const auto& results = DBHelper::ref().executeQuery("SELECT name FROM sqlite_schema WHERE type='table' AND name NOT LIKE 'sqlite_%';");
-            if (results.isValid() && results.columns.size() == 1U) {
-                Database database;
-                database.name = fs::path(vDatabaseFilePathName).stem().string();
-                for (const auto& row : results.rows) {
-                    if (row.values.size() == 1U) {
-                        const auto& table_name = std::get<std::string>(row.values.at(0));
-                        const auto& table_datas = DBHelper::ref().executeQuery(ez::str::toStr("PRAGMA table_info(%s)", table_name.c_str()));
-                        if (table_datas.isValid()) {
-                            TableDatas tblDatas;
-                            for (size_t r = 0; r < table_datas.rows.size(); ++r) {
-                                const auto& row = table_datas.rows.at(r);
-                                TableFieldDatas fldDatas;
-                                for (size_t c = 0; c < table_datas.columns.size(); ++c) {
-                                    const auto& column = table_datas.columns.at(c).name;
-                                    if (c < row.values.size()) {
-                                        const auto& value = row.values.at(c);
-                                        if (column == "cid") {
-                                            fldDatas.cid = static_cast<RowID>(std::get<int64_t>(value));
-                                        } else if (column == "name") {
-                                            fldDatas.name = std::get<std::string>(value);
-                                        } else if (column == "type") {
-                                            fldDatas.type = std::get<std::string>(value);
-                                            if (fldDatas.type == "INTEGER") {
-                                                fldDatas.type = "INT"; // fro compact table column display
-                                            }
-                                        } else if (column == "notnull") {
-                                            fldDatas.notNull = static_cast<bool>(!!std::get<int64_t>(value));
-                                        } else if (column == "dflt_value") {
-                                            if (std::holds_alternative<std::string>(value)) {  // not std::nullptr_t
-                                                fldDatas.defaultValue = std::get<std::string>(value);
-                                            }
-                                        } else if (column == "pk") {
-                                            fldDatas.primaryKey = static_cast<bool>(!!std::get<int64_t>(value));
-                                        }
-                                    }
-                                }
-                                tblDatas.name = table_name;
-                                tblDatas.fields.push_back(fldDatas);
-                            }
-                            database.tables.tryAdd(table_name, tblDatas);
-                        }
-                    }
-                }
-                if (database.isValid()) {
-                    m_databases.databases.tryAdd(database.name, database);
-                    ret = true;
+    const bool inMemory = DBHelper::ref().isInMemory();  // no file, the connection is already opened
+    if (!inMemory && (!fs::exists(vDatabaseFilePathName) || !DBHelper::ref().openDBFile(vDatabaseFilePathName))) {
+        return false;
+    }
+    int64_t schemaVersion = -1;
+    std::vector<TableDatas> tables;
+    std::string errorMsg;
+    if (!m_readSchema(m_schemaVersion, schemaVersion, tables, errorMsg)) {
+        LogVarError("%s", errorMsg.c_str());
+        return false;
+    }
+    return m_applySchema(vDatabaseFilePathName, schemaVersion, std::move(tables));
+}
+
+// the db is already opened by the query. one analyze at a time, a request during it is done after
+void Controller::reanalyzeDatabase() {
+    if (m_analyzeJob != nullptr) {
+        m_analyzeAgain = true;
+        return;
+    }
+    struct SchemaLoading {
+        int64_t version{-1};
+        std::vector<TableDatas> tables;
+        std::string errorMsg;
+        bool ok{false};
+    };
+    auto pLoading = std::make_shared<SchemaLoading>();
+    const auto knownVersion = m_schemaVersion;
+    const auto generation = m_analyzeGeneration;
+    const auto filePathName = DBManager::ref().getDatabaseFilepathName();
+    m_analyzeJob = JobManager::ref().pushJob(  //
+        Job::Priority::INTERACTIVE,
+        [knownVersion, pLoading](Job& /*vJob*/) {  //
+            pLoading->ok = m_readSchema(knownVersion, pLoading->version, pLoading->tables, pLoading->errorMsg);
+        },
+        [this, generation, filePathName, pLoading](Job& vJob) {
+            m_analyzeJob.reset();
+            if (generation == m_analyzeGeneration && vJob.getState() == Job::State::DONE) {  // else the db was closed or changed
+                if (pLoading->ok) {
+                    m_applySchema(filePathName, pLoading->version, std::move(pLoading->tables));
+                } else {
+                    LogVarError("%s", pLoading->errorMsg.c_str());
                 }
             }
-            DBHelper::ref().closeDBFile();
+            if (m_analyzeAgain) {
+                m_analyzeAgain = false;
+                reanalyzeDatabase();
+            }
+        });
+}
+
+// vOutTables is filled only if the version is not vKnownVersion
+bool Controller::m_readSchema(const int64_t vKnownVersion, int64_t& vOutVersion, std::vector<TableDatas>& vOutTables, std::string& vOutErrorMsg) {
+    DBHelper::ref().updateReadPoolState();  // a query can have changed the journal mode
+    // read connections if the db is in WAL mode, so the refresh don't wait the running queries
+    std::string errorMsg;
+    const auto& version = DBHelper::ref().executeReadQuery("PRAGMA schema_version;", &errorMsg, true);
+    if (!version.isValid()) {
+        vOutErrorMsg = "Failed to read the schema version : " + errorMsg;
+        return false;
+    }
+    // incremented by sqlite at each change of the schema
+    vOutVersion = version.getInteger(0, 0);
+    if (vOutVersion == vKnownVersion) {
+        return true;
+    }
+    // only the tables, sorted like Database::tables. the fields are loaded when a table is expanded
+    const auto& results = DBHelper::ref().executeReadQuery(
+        "SELECT name, sql FROM sqlite_schema WHERE type = 'table' AND name NOT LIKE 'sqlite_%' ORDER BY name;",
+        &errorMsg,
+        true);
+    if (!errorMsg.empty()) {
+        vOutErrorMsg = "Failed to analyze the database : " + errorMsg;
+        return false;
+    }
+    vOutTables.resize(results.getRowsCount());
+    for (size_t r = 0; r < vOutTables.size(); ++r) {
+        vOutTables[r].name = results.getText(r, 0);
+        vOutTables[r].sql = results.getText(r, 1);
+    }
+    return true;
+}
+
+bool Controller::m_applySchema(const std::string& vDatabaseFilePathName, const int64_t vVersion, std::vector<TableDatas>&& vTables) {
+    if (vVersion == m_schemaVersion) {
+        return m_databases.isValid();
+    }
+    m_schemaVersion = vVersion;
+    m_structureRowsDirty = true;
+    const auto databaseName = DBHelper::ref().isInMemory() ? std::string("memory") : fs::path(vDatabaseFilePathName).stem().string();
+    for (auto& database : m_databases.databases) {
+        if (database.name == databaseName) {
+            database.mergeTables(std::move(vTables));
+            return database.isValid();
         }
     }
-    return ret;
+    Database database;
+    database.name = databaseName;
+    database.mergeTables(std::move(vTables));
+    if (database.isValid()) {
+        m_databases.databases.tryAdd(database.name, database);
+        return true;
+    }
+    return false;
 }
 
 bool Controller::executeQuery(const std::string& vQuery, const bool vSaveQuery) {
     bool ret = false;
     if (vQuery.empty()) {
         ret = true;
+    } else if (isQueryRunning()) {
+        LogVarError("A query is already running");
     } else {
         ez::sqlite::Parser parser;
         ez::sqlite::Parser::Report report;
@@ -136,35 +291,158 @@ bool Controller::executeQuery(const std::string& vQuery, const bool vSaveQuery)
                     CodeEditor::ref().addErrorMarker(marker);
                 }
             } else {
-                m_queryResult = DBHelper::ref().executeQuery(vQuery);
-                if (m_queryResult.isValid()) {
-                    ret = true;
-                } else {
-                    const auto errorMsg = DBHelper::ref().getLastErrorMsg();
-                    if (!errorMsg.empty()) {
-                        CodeEditor::ErrorMarker marker;
-                        marker.line = 0;
-                        marker.lineNumberColor = IM_COL32(200, 20, 20, 150);
-                        marker.textColor = IM_COL32(200, 20, 20, 150);
-                        marker.textTooltip = errorMsg;
-                        CodeEditor::ref().clearErrorMarkers();
-                        CodeEditor::ref().addErrorMarker(marker);
-                    } else {
-                        ret = true;
-                    }
-                }
+                // the statement of the previous result can lock the tables, the worker close it before the query.
+                // its close and the end of its fetch can wait the writer, never in the ui thread
+                auto previousCursor = std::move(m_queryCursor);
+                auto previousFetch = std::move(m_cursorFetchJob);
+                QueryManager::ref().cancelQuery(previousFetch);
+                clearResults();
+                m_queryJob = QueryManager::ref().pushCursorQuery(  //
+                    vQuery,
+                    m_queryTimeoutMs,
+                    m_scriptInTransaction,
+                    true,
+                    std::move(previousCursor),
+                    previousFetch,
+                    [this, vSaveQuery](QueryJob& vJob) { m_onQueryCompleted(vJob, vSaveQuery); });
+                ret = true;
             }
         }
     }
-    if (ret) {
-        if (vSaveQuery) {
-            m_addQueryToHistory(vQuery);
+    return ret;
+}
+
+void Controller::cancelQuery() {
+    QueryManager::ref().cancelQuery(m_queryJob);
+    QueryManager::ref().cancelQuery(m_indexJob);
+}
+
+// the index creation hold the writer, a query would wait its end
+bool Controller::isQueryRunning() const {
+    return ((m_queryJob != nullptr) && !m_queryJob->isFinished()) ||  //
+        ((m_indexJob != nullptr) && !m_indexJob->isFinished());
+}
+
+bool Controller::explainQuery(const std::string& vQuery) {
+    if (vQuery.empty()) {
+        return true;
+    }
+    if (m_explainJob != nullptr) {
+        LogVarError("A query is already being explained");
+        return false;
+    }
+    // the prepare of the plan can wait the writer
+    struct PlanLoading {
+        QueryPlan plan;
+        bool isExplained{false};
+        std::string errorMsg;
+    };
+    auto pLoading = std::make_shared<PlanLoading>();
+    m_explainJob = JobManager::ref().pushJob(  //
+        Job::Priority::INTERACTIVE,
+        [vQuery, pLoading](Job& /*vJob*/) {  //
+            pLoading->isExplained = QueryPlan::explain(vQuery, pLoading->plan, &pLoading->errorMsg);
+        },
+        [this, pLoading](Job& vJob) {
+            m_explainJob.reset();
+            if (vJob.getState() == Job::State::CANCELED) {
+                return;
+            }
+            if (!pLoading->isExplained) {
+                LogVarError("Failed to explain the query : %s", pLoading->errorMsg.c_str());
+                return;
+            }
+            m_addQueryPlan(std::move(pLoading->plan));
+        });
+    return true;
+}
+
+bool Controller::adviseIndexes(const std::vector<std::string>& vQueries) {
+    if (vQueries.empty() || (vQueries.size() == 1U && vQueries.front().empty())) {
+        LogVarError("No query to advise");
+        return false;
+    }
+    return IndexAdvisor::ref().start(vQueries, [this](IndexAdvisor& vAdvisor) {
+        if (vAdvisor.getState() == IndexAdvisor::State::DONE) {
+            m_indexAdvices = vAdvisor.getAdvices();
+            size_t indexesCount = 0U;
+            for (const auto& advice : m_indexAdvices) {
+                indexesCount += advice.createIndexes.size();
+            }
+            LogVarInfo("%zu indexes advised for %zu statements", indexesCount, m_indexAdvices.size());
+        } else {
+            LogVarError("Index advisor failed : %s", vAdvisor.getErrorMsg().c_str());
         }
-        CodeEditor::ref().clearErrorMarkers();
-        clearAnalyze();
-        analyzeDatabase(DBManager::ref().getDatabaseFilepathName());
+    });
+}
+
+bool Controller::importCsvFile(const std::string& vFilePathName) {
+    return CsvImporter::ref().start(vFilePathName, {}, [this](CsvImporter& vImporter) {
+        if (vImporter.getState() == CsvImporter::State::DONE) {
+            LogVarInfo(  //
+                "%zu rows imported in the table %s in %.2f s",
+                vImporter.getRowsCount(),
+                vImporter.getTableName().c_str(),
+                vImporter.getElapsedMs() / 1000.0);
+            if (vImporter.getMalformedRowsCount() > 0U) {
+                LogVarWarning("%zu rows had a wrong fields count", vImporter.getMalformedRowsCount());
+            }
+            reanalyzeDatabase();
+        } else {
+            LogVarError("Import of %s failed : %s", vImporter.getFilePathName().c_str(), vImporter.getErrorMsg().c_str());
+        }
+    });
+}
+
+bool Controller::exportResults(const std::string& vFilePathName, const ResultExporter::Format vFormat) {
+    // the count is known only if all the rows was reached by the cursor
+    size_t expectedRowsCount = 0U;
+    if (m_queryCursor != nullptr && m_queryCursor->isExhausted()) {
+        expectedRowsCount = m_queryCursor->getKnownRowsCount();
     }
-    return ret;
+    return ResultExporter::ref().start(m_resultSql, vFilePathName, vFormat, expectedRowsCount, [](ResultExporter& vExporter) {
+        if (vExporter.getState() == ResultExporter::State::DONE) {
+            LogVarInfo(  //
+                "%zu rows exported in %s in %.2f s",
+                vExporter.getRowsCount(),
+                vExporter.getFilePathName().c_str(),
+                vExporter.getElapsedMs() / 1000.0);
+        } else {
+            LogVarError("Export in %s failed : %s", vExporter.getFilePathName().c_str(), vExporter.getErrorMsg().c_str());
+        }
+    });
+}
+
+bool Controller::saveCellToFile(const BlobLocator& vLocator, const std::string& vFilePathName) {
+    return BlobTransfer::ref().start(BlobTransfer::Operation::SAVE_TO_FILE, vLocator, vFilePathName, [](BlobTransfer& vTransfer) {
+        if (vTransfer.getState() == BlobTransfer::State::DONE) {
+            LogVarInfo(  //
+                "Cell saved in %s (%.1f MB in %.2f s)",
+                vTransfer.getFilePathName().c_str(),
+                static_cast<double>(vTransfer.getBytesCount()) / (1024.0 * 1024.0),
+                vTransfer.getElapsedMs() / 1000.0);
+        } else {
+            LogVarError("Save of the cell in %s failed : %s", vTransfer.getFilePathName().c_str(), vTransfer.getErrorMsg().c_str());
+        }
+    });
+}
+
+bool Controller::loadFileIntoCell(const BlobLocator& vLocator, const std::string& vFilePathName) {
+    return BlobTransfer::ref().start(BlobTransfer::Operation::LOAD_FROM_FILE, vLocator, vFilePathName, [](BlobTransfer& vTransfer) {
+        if (vTransfer.getState() == BlobTransfer::State::DONE) {
+            // the shown result is not refreshed, the query must be executed again
+            LogVarInfo(  //
+                "%s loaded in the cell %s.%s of the rowid %lld (%.1f MB in %.2f s)",
+                vTransfer.getFilePathName().c_str(),
+                vTransfer.getLocator().table.c_str(),
+                vTransfer.getLocator().column.c_str(),
+                static_cast<long long>(vTransfer.getLocator().rowid),
+                static_cast<double>(vTransfer.getBytesCount()) / (1024.0 * 1024.0),
+                vTransfer.getElapsedMs() / 1000.0);
+        } else {
+            LogVarError("Load of %s in the cell failed : %s", vTransfer.getFilePathName().c_str(), vTransfer.getErrorMsg().c_str());
+        }
+    });
 }
 
 void Controller::doActions() {
@@ -172,18 +450,23 @@ void Controller::doActions() {
 }
 
 void Controller::drawQueryResultTable() {
-    if (m_queryResult.isValid()) {
-        if (m_drawQueryResultTable(m_queryResult, m_selRow, m_selCol, m_cellValue)) {
-            
+    if (m_queryCursor != nullptr && m_queryCursor->isValid()) {
+        m_drawQueryResultTable(*m_queryCursor, m_selRow, m_selCol);
+    } else if (m_scriptResult.isValid()) {  // the selected statement return no rows
+        if (ImGui::BeginMenuBar()) {
+            m_drawScriptStatementsMenu();
+            ImGui::EndMenuBar();
         }
     }
+    if (m_scriptStatementToSelect >= 0) {
+        m_selectScriptStatement(static_cast<size_t>(m_scriptStatementToSelect));
+        m_scriptStatementToSelect = -1;
+    }
 }
 
 void Controller::drawQueryResultValue() {
-    if (m_queryResult.isValid()) {
-        if (!m_cellValue.empty()) {
-            ImGui::Text(m_cellValue.c_str());
-        }
+    if (m_queryCursor != nullptr && m_queryCursor->isValid()) {
+        m_valueViewer.draw();
     }
 }
 
@@ -231,7 +514,11 @@ void Controller::drawDatabaseStructure() {
         | ImGuiTableFlags_Reorderable  //
         | ImGuiTableFlags_Hideable;
     static ImGuiTreeNodeFlags leaf = ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
-    static ImGuiTreeNodeFlags tflags = ImGuiTreeNodeFlags_OpenOnArrow;
+    // the open state is kept in the model, the rows are not nested in the imgui tree
+    static ImGuiTreeNodeFlags tflags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+    if (m_structureRowsDirty) {
+        m_buildStructureRows();
+    }
     std::string query_to_execute;
     if (ImGui::BeginTable("DBTreeTable", 5, tf)) {
         ImGui::TableSetupScrollFreeze(0, 1);
@@ -241,66 +528,81 @@ void Controller::drawDatabaseStructure() {
         ImGui::TableSetupColumn("PK", ImGuiTableColumnFlags_WidthFixed);
         ImGui::TableSetupColumn("Default", ImGuiTableColumnFlags_WidthFixed);
         ImGui::TableHeadersRow();
-        if (m_databases.isValid()) {
-            for (const auto& database : m_databases.databases) {
+        const float indentSpacing = ImGui::GetStyle().IndentSpacing;
+        m_structureTreeClipper.Begin(static_cast<int>(m_structureRows.size()));
+        while (m_structureTreeClipper.Step()) {
+            for (int i = m_structureTreeClipper.DisplayStart; i < m_structureTreeClipper.DisplayEnd; ++i) {
+                const auto& row = m_structureRows.at(i);
+                // the indent of the first column is taken at the row start
+                const float indent = (row.pTable == nullptr) ? 0.0f : ((row.fieldIdx < 0) ? indentSpacing : indentSpacing * 2.0f);
+                if (indent > 0.0f) {
+                    ImGui::Indent(indent);
+                }
                 ImGui::TableNextRow();
                 ImGui::TableSetColumnIndex(0);
-                ImGui::PushID(database.name.c_str());
-                if (ImGui::TreeNodeEx("##database", tflags | ImGuiTreeNodeFlags_DefaultOpen, "%s (%zu)", database.name.c_str(), database.tables.size())) {
-                    ImGui::Indent();
-                    for (const auto& kv : database.tables) {
-                        ImGui::TableNextRow();
-                        ImGui::TableSetColumnIndex(0);
-                        ImGui::PushID(kv.name.c_str());
-                        bool tableOpened = ImGui::TreeNodeEx("##table", tflags);
-                        ImGui::SameLine();
-                        ImGui::Selectable(ez::str::toStr("%s (%zu)", kv.name.c_str(), kv.fields.size()).c_str(), false);
-                        if (query_to_execute.empty() && ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
-                            query_to_execute = "SELECT * FROM " + kv.name + ";";
-                        }
-                        if (ImGui::BeginPopupContextItem(               //
-                                NULL,                                   //
-                                ImGuiPopupFlags_NoOpenOverItems |       //
-                                    ImGuiPopupFlags_MouseButtonRight |  //
-                                    ImGuiPopupFlags_NoOpenOverExistingPopup)) {
-                            m_drawTableContextMenu(kv);
-                            ImGui::EndPopup();
-                        }
-                        if (tableOpened) {
-                            ImGui::Indent();
-                            for (size_t i = 0; i < kv.fields.size(); ++i) {
-                                const auto& c = kv.fields.at(i);
-                                ImGui::TableNextRow();
-                                ImGui::TableSetColumnIndex(0);
-                                ImGui::TreeNodeEx((void*)(intptr_t)i, leaf, "%s", c.name.c_str());
-                                ImGui::TableSetColumnIndex(1);
-                                ImGui::TextUnformatted(c.type.c_str());
-                                ImGui::TableSetColumnIndex(2);
-                                ImGui::PushStyleColor(ImGuiCol_Text, c.notNull ? ImGui::CustomStyle::GoodColor : ImGui::CustomStyle::BadColor);
-                                ImGui::TextUnformatted(c.notNull ? "YES" : "NO");
-                                ImGui::PopStyleColor();
-                                ImGui::TableSetColumnIndex(3);
-                                ImGui::PushStyleColor(ImGuiCol_Text, c.primaryKey ? ImGui::CustomStyle::GoodColor : ImGui::CustomStyle::BadColor);
-                                ImGui::TextUnformatted(c.primaryKey ? "YES" : "NO");
-                                ImGui::PopStyleColor();
-                                ImGui::TableSetColumnIndex(4);
-                                if (!c.defaultValue.empty()) {
-                                    ImGui::TextUnformatted(c.defaultValue.c_str());
-                                } else {
-                                    ImGui::TextDisabled("NULL");
-                                }
-                            }
-                            ImGui::Unindent();
-                            ImGui::TreePop();
-                        }
-                        ImGui::PopID();
+                if (row.pTable == nullptr) {
+                    auto& database = *row.pDatabase;
+                    ImGui::PushID(database.name.c_str());
+                    ImGui::SetNextItemOpen(database.expanded);
+                    if (ImGui::TreeNodeEx("##database", tflags, "%s (%zu)", database.name.c_str(), database.tables.size()) != database.expanded) {
+                        database.expanded = !database.expanded;
+                        m_structureRowsDirty = true;
+                    }
+                    ImGui::PopID();
+                } else if (row.fieldIdx < 0) {
+                    auto& table = *row.pTable;
+                    ImGui::PushID(table.name.c_str());
+                    ImGui::SetNextItemOpen(table.expanded);
+                    if (ImGui::TreeNodeEx("##table", tflags) != table.expanded) {
+                        table.expanded = !table.expanded;
+                        m_structureRowsDirty = true;
+                    }
+                    ImGui::SameLine();
+                    if (table.fieldsLoaded) {
+                        ImGui::Selectable(ez::str::toStr("%s (%zu)", table.name.c_str(), table.fields.size()).c_str(), false);
+                    } else {
+                        ImGui::Selectable(table.name.c_str(), false);
+                    }
+                    if (query_to_execute.empty() && ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
+                        query_to_execute = "SELECT * FROM " + table.name + ";";
+                    }
+                    if (ImGui::BeginPopupContextItem(               //
+                            NULL,                                   //
+                            ImGuiPopupFlags_NoOpenOverItems |       //
+                                ImGuiPopupFlags_MouseButtonRight |  //
+                                ImGuiPopupFlags_NoOpenOverExistingPopup)) {
+                        m_drawTableContextMenu(table);
+                        ImGui::EndPopup();
+                    }
+                    ImGui::PopID();
+                } else {
+                    const auto& c = row.pTable->fields.at(row.fieldIdx);
+                    ImGui::PushID(row.pTable->name.c_str());
+                    ImGui::TreeNodeEx((void*)(intptr_t)row.fieldIdx, leaf, "%s", c.name.c_str());
+                    ImGui::PopID();
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::TextUnformatted(c.type.c_str());
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::PushStyleColor(ImGuiCol_Text, c.notNull ? ImGui::CustomStyle::GoodColor : ImGui::CustomStyle::BadColor);
+                    ImGui::TextUnformatted(c.notNull ? "YES" : "NO");
+                    ImGui::PopStyleColor();
+                    ImGui::TableSetColumnIndex(3);
+                    ImGui::PushStyleColor(ImGuiCol_Text, c.primaryKey ? ImGui::CustomStyle::GoodColor : ImGui::CustomStyle::BadColor);
+                    ImGui::TextUnformatted(c.primaryKey ? "YES" : "NO");
+                    ImGui::PopStyleColor();
+                    ImGui::TableSetColumnIndex(4);
+                    if (!c.defaultValue.empty()) {
+                        ImGui::TextUnformatted(c.defaultValue.c_str());
+                    } else {
+                        ImGui::TextDisabled("NULL");
                     }
-                    ImGui::Unindent();
-                    ImGui::TreePop();
                 }
-                ImGui::PopID();
+                if (indent > 0.0f) {
+                    ImGui::Unindent(indent);
+                }
             }
         }
+        m_structureTreeClipper.End();
         ImGui::EndTable();
     }
     if (!query_to_execute.empty()) {
@@ -308,9 +610,199 @@ void Controller::drawDatabaseStructure() {
     }
 }
 
+void Controller::drawQueryProfiler() {
+    auto& profiler = QueryProfiler::ref();
+    if (ImGui::BeginMenuBar()) {
+        bool enabled = profiler.isEnabled();
+        if (ImGui::Checkbox("Record", &enabled)) {
+            profiler.setEnabled(enabled);
+        }
+        if (ImGui::MenuItem("Clear")) {
+            profiler.clear();
+            m_selectedProfile = StatementProfile();
+        }
+        ImGui::Text("%zu statements", m_profiles.size());
+        ImGui::EndMenuBar();
+    }
+    // the generation is read before the copy, a profile added during the copy will be taken in the next frame
+    const auto generation = profiler.getGeneration();
+    if (generation != m_profilesGeneration) {
+        m_profilesGeneration = generation;
+        m_profiles = profiler.getProfiles();
+    }
+    const bool hasSelection = !m_selectedProfile.sql.empty();
+    if (ImGui::BeginTable(                     //
+            "##QueryProfilerTable",            //
+            10,                                //
+            ImGuiTableFlags_Borders            //
+                | ImGuiTableFlags_RowBg        //
+                | ImGuiTableFlags_ScrollX      //
+                | ImGuiTableFlags_ScrollY      //
+                | ImGuiTableFlags_Resizable    //
+                | ImGuiTableFlags_Reorderable  //
+                | ImGuiTableFlags_Hideable,
+            ImVec2(0.0f, hasSelection ? ImGui::GetContentRegionAvail().y * 0.5f : 0.0f))) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Time (ms)", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("VM steps", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Full scan steps", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Sorts", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Auto index rows", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Memory", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Reprepares", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Triggers", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Connection", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("SQL", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableHeadersRow();
+        m_profilerClipper.Begin(static_cast<int>(m_profiles.size()), ImGui::GetTextLineHeightWithSpacing());
+        while (m_profilerClipper.Step()) {
+            for (int r = m_profilerClipper.DisplayStart; r < m_profilerClipper.DisplayEnd; ++r) {
+                const auto& profile = m_profiles.at(m_profiles.size() - 1U - static_cast<size_t>(r));  // the most recent first
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::Text("%.3f", profile.elapsedMs);
+                ImGui::TableSetColumnIndex(1);
+                ImGui::Text("%lld", static_cast<long long>(profile.vmSteps));
+                // full scans and automatic indexes are the signs of a missing index
+                ImGui::TableSetColumnIndex(2);
+                if (profile.fullScanSteps > 0) {
+                    ImGui::TextColored(ImGui::CustomStyle::BadColor, "%lld", static_cast<long long>(profile.fullScanSteps));
+                } else {
+                    ImGui::TextDisabled("0");
+                }
+                ImGui::TableSetColumnIndex(3);
+                ImGui::Text("%lld", static_cast<long long>(profile.sortsCount));
+                ImGui::TableSetColumnIndex(4);
+                if (profile.autoIndexesCount > 0) {
+                    ImGui::TextColored(ImGui::CustomStyle::BadColor, "%lld", static_cast<long long>(profile.autoIndexesCount));
+                } else {
+                    ImGui::TextDisabled("0");
+                }
+                ImGui::TableSetColumnIndex(5);
+                ImGui::Text("%.1f KB", static_cast<double>(profile.memUsed) / 1024.0);
+                ImGui::TableSetColumnIndex(6);
+                ImGui::Text("%lld", static_cast<long long>(profile.repreparesCount));
+                ImGui::TableSetColumnIndex(7);
+                ImGui::Text("%lld", static_cast<long long>(profile.triggersCount));
+                ImGui::TableSetColumnIndex(8);
+                ImGui::TextUnformatted(profile.onReadConnection ? "read" : "writer");
+                ImGui::TableSetColumnIndex(9);
+                // a click show the scan status of the statement
+                ImGui::PushID(r);
+                if (ImGui::Selectable("##profile", false, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowOverlap)) {
+                    m_selectedProfile = profile;
+                }
+                ImGui::PopID();
+                ImGui::SameLine();
+                // only the first line, the full sql in the tooltip
+                const auto lineEnd = profile.sql.find('\n');
+                ImGui::TextUnformatted(profile.sql.c_str(), profile.sql.c_str() + std::min(lineEnd, profile.sql.size()));
+                if (lineEnd != std::string::npos && ImGui::IsItemHovered()) {
+                    ImGui::SetTooltip("%s", profile.sql.c_str());
+                }
+            }
+        }
+        ImGui::EndTable();
+    }
+    if (hasSelection) {
+        m_drawScanStatus(m_selectedProfile);
+    }
+}
+
+void Controller::drawQueryPlans() {
+    if (ImGui::BeginMenuBar()) {
+        m_drawQueryPlanSelector("Left", m_leftPlanNumber);
+        m_drawQueryPlanSelector("Right", m_rightPlanNumber);
+        if (ImGui::MenuItem("Clear")) {
+            m_queryPlans.clear();
+            m_leftPlanNumber = 0U;
+            m_rightPlanNumber = 0U;
+        }
+        ImGui::EndMenuBar();
+    }
+    if (ImGui::BeginTable("##QueryPlansTable", 2, ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY)) {
+        const size_t planNumbers[2] = {m_leftPlanNumber, m_rightPlanNumber};
+        ImGui::TableNextRow();
+        for (int32_t c = 0; c < 2; ++c) {
+            ImGui::TableSetColumnIndex(c);
+            ImGui::PushID(c);
+            const auto* pPlan = m_getQueryPlan(planNumbers[c]);
+            if (pPlan != nullptr) {
+                m_drawQueryPlan(*pPlan);
+            } else {
+                ImGui::TextDisabled("Explain or execute a query to get its plan");
+            }
+            ImGui::PopID();
+        }
+        ImGui::EndTable();
+    }
+}
+
+void Controller::drawIndexAdvisor() {
+    auto& advisor = IndexAdvisor::ref();
+    if (ImGui::BeginMenuBar()) {
+        if (advisor.isRunning()) {
+            ImGui::Text("Advising...");
+            if (ImGui::MenuItem("Cancel")) {
+                advisor.cancel();
+            }
+        } else if (ImGui::MenuItem("Clear")) {
+            m_indexAdvices.clear();
+        }
+        ImGui::EndMenuBar();
+    }
+    if (m_indexAdvices.empty()) {
+        ImGui::TextDisabled("Use the Advise indexes menu of the editor");
+        return;
+    }
+    const bool creating = (m_indexJob != nullptr) && !m_indexJob->isFinished();
+    for (size_t idx = 0; idx < m_indexAdvices.size(); ++idx) {
+        const auto& advice = m_indexAdvices.at(idx);
+        ImGui::PushID(static_cast<int>(idx));
+        const auto sqlFirstLine = advice.sql.substr(0, advice.sql.find('\n'));
+        if (ImGui::CollapsingHeader(ez::str::toStr("%s###advice", sqlFirstLine.c_str()).c_str(), ImGuiTreeNodeFlags_DefaultOpen)) {
+            if (!advice.errorMsg.empty()) {
+                ImGui::TextColored(ImGui::CustomStyle::BadColor, "%s", advice.errorMsg.c_str());
+            } else if (advice.createIndexes.empty()) {
+                ImGui::TextDisabled("No index to advise");
+            }
+            for (const auto& createSql : advice.createIndexes) {
+                ImGui::PushID(createSql.c_str());
+                ImGui::BeginDisabled(creating);
+                if (ImGui::SmallContrastedButton("Create")) {
+                    m_createAdvisedIndex(createSql, advice.readOnly ? advice.sql : std::string());
+                }
+                ImGui::EndDisabled();
+                ImGui::PopID();
+                ImGui::SameLine();
+                ImGui::TextUnformatted(createSql.c_str());
+            }
+            if (advice.afterPlan.isValid() && ImGui::BeginTable("##AdvicePlans", 2, ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable)) {
+                ImGui::TableSetupColumn("Current plan");
+                ImGui::TableSetupColumn("Plan with the candidate indexes");
+                ImGui::TableHeadersRow();
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::PushID(0);
+                m_drawQueryPlan(advice.beforePlan);
+                ImGui::PopID();
+                ImGui::TableSetColumnIndex(1);
+                ImGui::PushID(1);
+                m_drawQueryPlan(advice.afterPlan);
+                ImGui::PopID();
+                ImGui::EndTable();
+            }
+        }
+        ImGui::PopID();
+    }
+}
+
 ez::xml::Nodes Controller::getXmlNodes(const std::string& vUserDatas) {
     ez::xml::Node node;
     auto& controller = node.addChild("controller");
+    controller.addChild("querytimeout").setContent(ez::str::toStr("%i", m_queryTimeoutMs));
+    controller.addChild("scripttransaction").setContent(m_scriptInTransaction);
+    controller.addChild("realprecision").setContent(ez::str::toStr("%i", m_cellTextCache.getFormat().realPrecision));
     auto& nodeHistory = controller.addChild("history");
     for (const auto& h : m_history.queries) {
         nodeHistory.addChild("query").setContent(ez::xml::Node::escapeXml(h.query));
@@ -327,6 +819,14 @@ bool Controller::setFromXmlNodes(const ez::xml::Node& vNode, const ez::xml::Node
     }
     if (strName == "query" && strParentName == "history") {
         m_addQueryToHistory(strValue);
+    } else if (strName == "querytimeout" && strParentName == "controller") {
+        m_queryTimeoutMs = std::max(ez::ivariant(strValue).GetI(), 0);
+    } else if (strName == "scripttransaction" && strParentName == "controller") {
+        m_scriptInTransaction = ez::ivariant(strValue).GetB();
+    } else if (strName == "realprecision" && strParentName == "controller") {
+        auto format = m_cellTextCache.getFormat();
+        format.realPrecision = std::clamp(ez::ivariant(strValue).GetI(), 0, 17);
+        m_cellTextCache.setFormat(format);
     }
     return false; // stop here
 }
@@ -343,20 +843,343 @@ ImU32 Controller::m_getSqliteTypeColor(const SqliteType vSqliteType) {
     return 0;
 }
 
-void Controller::m_colorizeTableCell(const ImU32 vColor) {
-    auto drawListPtr = ImGui::GetWindowDrawList();
-    const auto& cursor = ImGui::GetCursorScreenPos();
-    auto* tbl_ptr = GImGui->CurrentTable;
-    const auto& table_column = tbl_ptr->Columns[tbl_ptr->CurrentColumn];
-    const auto& column_height = ImGui::GetTextLineHeight();
-    const auto& spacingX = IM_TRUNC(ImGui::GetStyle().ItemSpacing.x * 0.5f);
-    const auto& spacingY = IM_TRUNC(ImGui::GetStyle().ItemSpacing.y * 0.5f);
-    const ImVec2 pMin(table_column.MinX + spacingX - 1.0f, cursor.y - spacingY * 0.5f);
-    const ImVec2 pMax(table_column.MaxX, cursor.y + column_height + spacingY);
-    drawListPtr->AddRectFilled(pMin, pMax, vColor);
+void Controller::m_selectResultCell(const ResultGridRow& vRow, const int vCol, int& ioSelRow, int& ioSelCol) {
+    // the viewer own the full value
+    const auto& cell = vRow.pCells->cells.at(vCol);
+    ioSelRow = vRow.idx;
+    ioSelCol = vCol;
+    if (cell.type == SqliteType::TYPE_TEXT) {
+        BlobLocator locator;
+        if (vRow.pBlock->isTextLoaded(vRow.blockRow, vCol)) {
+            m_valueViewer.setText(std::string(vRow.pBlock->getText(vRow.blockRow, vCol)));  // not truncated
+        } else if (vRow.pBlock->getCellLocator(vRow.blockRow, vCol, locator)) {
+            m_valueViewer.setText(locator, vRow.pBlock->getSize(vRow.blockRow, vCol));  // read in a worker
+        }
+    } else if (cell.type == SqliteType::TYPE_BLOB) {
+        BlobLocator locator;
+        if (vRow.pBlock->isBlobLoaded(vRow.blockRow, vCol)) {
+            m_valueViewer.setBlob(std::string(vRow.pBlock->getBlob(vRow.blockRow, vCol)), {vRow.idx, vCol});
+        } else if (vRow.pBlock->getCellLocator(vRow.blockRow, vCol, locator)) {
+            m_valueViewer.setBlob(locator, vRow.pBlock->getSize(vRow.blockRow, vCol), {vRow.idx, vCol});  // read by pages on demand
+        } else {
+            m_valueViewer.setBlobError(  //
+                vRow.pBlock->getSize(vRow.blockRow, vCol),
+                "This blob is read on demand, but its row can't be located. Select the rowid of its table for view it.");
+        }
+    } else {
+        m_valueViewer.setText(std::string(vRow.pCells->getText(cell)));
+    }
+}
+
+void Controller::m_openResultCellContextMenu(const ResultGridRow& vRow, const int vCol) {
+    m_contextCellType = vRow.pCells->cells.at(vCol).type;
+    m_contextCellRow = vRow.idx;
+    m_contextCellCol = vCol;
+    ImGui::OpenPopup("##ResultCellContextMenu");
 }
 
-bool Controller::m_drawQueryResultTable(const QueryResult& vResult, int& ioSelRow, int& ioSelCol, std::string& vOutValue) {
+// to call in the id scope of m_openResultCellContextMenu
+void Controller::m_drawResultCellContextMenu(const QueryCursor& vCursor) {
+    if (ImGui::BeginPopup("##ResultCellContextMenu")) {
+        // the rowid columns of a result are searched only when a cell must be located
+        BlobLocator locator;
+        bool isLocated = false;
+        bool isSearching = false;
+        size_t blockRow = 0U;
+        const auto* pBlock = vCursor.getRowBlock(static_cast<size_t>(m_contextCellRow), blockRow);
+        if (pBlock != nullptr) {
+            if (pBlock->needRowidSearch()) {
+                isSearching = true;
+                if (m_rowidSearchJob == nullptr) {
+                    auto pRowidColumns = pBlock->rowidColumns;
+                    auto columns = pBlock->columns;
+                    m_rowidSearchJob = JobManager::ref().pushJob(  //
+                        Job::Priority::INTERACTIVE,
+                        [pRowidColumns, columns](Job& /*vJob*/) {  //
+                            DBHelper::ref().searchRowidColumns(*pRowidColumns, columns);
+                        },
+                        [this](Job& /*vJob*/) { m_rowidSearchJob.reset(); });
+                }
+            } else {
+                isLocated = pBlock->getCellLocator(blockRow, static_cast<size_t>(m_contextCellCol), locator);
+            }
+        }
+        const bool canTransfer = isLocated && !BlobTransfer::ref().isRunning();
+        const bool hasBytes = (m_contextCellType == SqliteType::TYPE_TEXT || m_contextCellType == SqliteType::TYPE_BLOB);
+        if (ImGui::MenuItem("Save cell to file", nullptr, false, canTransfer && hasBytes)) {
+            Frontend::ref().ActionMenuSaveCellToFile(locator);
+        }
+        if (ImGui::MenuItem("Load file into cell", nullptr, false, canTransfer)) {
+            Frontend::ref().ActionMenuLoadFileIntoCell(locator);
+        }
+        if (isSearching) {
+            ImGui::Separator();
+            ImGui::TextDisabled("Locating the row..");
+        } else if (!isLocated) {
+            ImGui::Separator();
+            ImGui::TextDisabled("Select the rowid of the table for transfer this cell");
+        }
+        ImGui::EndPopup();
+    }
+}
+
+float Controller::m_drawResultCell(
+    ImDrawList* vpDrawList,
+    CellTextCache::Row& vRow,
+    const int vCol,
+    const ImRect& vCellRect,
+    const ImVec2& vTextPos,
+    const float vTextMaxX,
+    const bool vSelected,
+    const bool vHovered,
+    const bool vMeasure) {
+    auto& cell = vRow.cells[vCol];
+    ImU32 bgColor = cell.color;
+    if (vSelected) {
+        bgColor = ImGui::GetColorU32(ImGuiCol_Header);
+    } else if (vHovered) {
+        bgColor = ImGui::GetColorU32(ImGuiCol_HeaderHovered);
+    }
+    if (bgColor != 0) {
+        vpDrawList->AddRectFilled(vCellRect.Min, vCellRect.Max, bgColor);
+    }
+    const auto text = vRow.getText(cell);
+    if (text.empty()) {
+        return 0.0f;
+    }
+    const ImVec4 clipRect(vCellRect.Min.x, vCellRect.Min.y, vTextMaxX, vCellRect.Max.y);
+    vpDrawList->AddText(  //
+        ImGui::GetFont(),
+        ImGui::GetFontSize(),
+        vTextPos,
+        ImGui::GetColorU32(ImGuiCol_Text),
+        text.data(),
+        text.data() + text.size(),
+        0.0f,
+        &clipRect);
+    if (!vMeasure) {
+        return 0.0f;
+    }
+    if (cell.width < 0.0f) {
+        cell.width = ImGui::CalcTextSize(text.data(), text.data() + text.size()).x;
+    }
+    return cell.width;
+}
+
+void Controller::m_fitWideGridColumns(const std::vector<ColumnInfo>& vColumns) {
+    const auto& style = ImGui::GetStyle();
+    for (size_t c = 0; c < vColumns.size(); ++c) {
+        float width = ImGui::CalcTextSize(vColumns[c].name.c_str()).x;
+        for (auto& row : m_resultGridRows) {
+            if (row.pCells != nullptr) {
+                auto& cell = row.pCells->cells[c];
+                if (cell.width < 0.0f) {
+                    const auto text = row.pCells->getText(cell);
+                    cell.width = ImGui::CalcTextSize(text.data(), text.data() + text.size()).x;
+                }
+                width = std::max(width, cell.width);
+            }
+        }
+        m_wideGridColumnOffsets[c + 1U] = m_wideGridColumnOffsets[c] + width + style.CellPadding.x * 2.0f;
+    }
+}
+
+bool Controller::m_drawWideResultGrid(  //
+    QueryCursor& vCursor,
+    const int vRowCount,
+    const bool vNeedResizeToFit,
+    int& ioSelRow,
+    int& ioSelCol) {
+    // too much columns for an ImGui table, so only the visible range of rows and columns is drawn,
+    // found from the scroll offsets and the cumulated column widths. the header row and the key column are frozen
+    static const float s_minColumnWidth = 20.0f;
+    static const float s_resizeGrabSize = 4.0f;
+    bool selectionChanged = false;
+    const auto& columns = vCursor.getColumns();
+    const int colCount = static_cast<int>(columns.size());
+    if (m_wideGridColumnOffsets.size() != columns.size() + 1U) {
+        m_wideGridColumnOffsets.assign(columns.size() + 1U, 0.0f);
+        m_wideGridResizedColumn = -1;
+        m_wideGridNeedFit = true;
+        m_resultGridRows.clear();  // the rows of the last frame are of another result
+        m_fitWideGridColumns(columns);  // on the headers only
+    }
+    const auto& style = ImGui::GetStyle();
+    const float rowHeight = ImGui::GetTextLineHeight() + style.CellPadding.y * 2.0f;
+    const float headerHeight = rowHeight;
+    const auto& offsets = m_wideGridColumnOffsets;
+    ImGui::SetNextWindowContentSize(ImVec2(offsets.back(), headerHeight + rowHeight * static_cast<float>(vRowCount)));
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
+    const bool visible = ImGui::BeginChild("##QueryResultGrid", ImVec2(0.0f, 0.0f), ImGuiChildFlags_Borders, ImGuiWindowFlags_HorizontalScrollbar);
+    ImGui::PopStyleVar();
+    if (visible) {
+        const ImRect innerRect = ImGui::GetCurrentWindow()->InnerRect;
+        const float scrollX = ImGui::GetScrollX();
+        const float scrollY = ImGui::GetScrollY();
+        const int frozenCount = std::min(s_frozenColumnsCount, colCount);
+        const float frozenWidth = offsets[frozenCount];
+        const ImRect bodyRect(ImVec2(innerRect.Min.x, innerRect.Min.y + headerHeight), innerRect.Max);
+
+        // visible ranges
+        const int firstRow = std::max(static_cast<int>(scrollY / rowHeight), 0);
+        const int endRow = std::min(static_cast<int>(std::ceil((scrollY + bodyRect.GetHeight()) / rowHeight)), vRowCount);
+        const auto findColumn = [&offsets, colCount](const float vX) {  // column containing the content pos vX
+            const auto it = std::upper_bound(offsets.begin(), offsets.end(), vX);
+            return std::clamp(static_cast<int>(it - offsets.begin()) - 1, 0, colCount - 1);
+        };
+        const int firstCol = std::max(findColumn(scrollX + frozenWidth), frozenCount);
+        const int endCol = std::min(findColumn(scrollX + innerRect.GetWidth()) + 1, colCount);
+
+        // read in a worker, the rows will come in a next frame
+        m_fetchCursorRows(  //
+            vCursor,
+            static_cast<size_t>(std::max(firstRow - s_prefetchRowsMargin, 0)),
+            static_cast<size_t>(std::max(endRow + s_prefetchRowsMargin, 0)));
+        m_resultGridRows.clear();
+        for (int r = firstRow; r < endRow; ++r) {
+            ResultGridRow row;
+            row.idx = r;
+            row.posY = bodyRect.Min.y + static_cast<float>(r) * rowHeight - scrollY;
+            row.pBlock = vCursor.getRowBlock(static_cast<size_t>(r), row.blockRow);
+            if (row.pBlock != nullptr) {
+                row.pCells = &m_cellTextCache.getRow(static_cast<size_t>(r), *row.pBlock, row.blockRow);
+            }
+            m_resultGridRows.push_back(row);
+        }
+        if (vNeedResizeToFit || (m_wideGridNeedFit && !m_resultGridRows.empty() && m_resultGridRows.front().pCells != nullptr)) {
+            m_fitWideGridColumns(columns);
+            m_wideGridNeedFit = false;
+        }
+        // screen x of the left of a column
+        const auto getColumnX = [&offsets, &innerRect, frozenCount, scrollX](const int vCol) {
+            return innerRect.Min.x + offsets[vCol] - ((vCol < frozenCount) ? 0.0f : scrollX);
+        };
+
+        // hit test, one item for the whole grid
+        const ImGuiID gridId = ImGui::GetID("##grid");
+        ImGui::ItemAdd(innerRect, gridId);
+        bool hovered = false;
+        bool held = false;
+        const bool pressed = ImGui::ButtonBehavior(innerRect, gridId, &hovered, &held, ImGuiButtonFlags_PressedOnClick);
+        const ImVec2 mousePos = ImGui::GetMousePos();
+        int hoveredRow = -1;
+        int hoveredCol = -1;
+        int hoveredBorder = -1;
+        const float mouseContentX = mousePos.x - innerRect.Min.x + ((mousePos.x - innerRect.Min.x < frozenWidth) ? 0.0f : scrollX);
+        if (hovered && m_wideGridResizedColumn < 0 && mouseContentX < offsets.back()) {
+            hoveredCol = findColumn(mouseContentX);
+            if (mousePos.y < bodyRect.Min.y) {
+                const float columnMaxX = getColumnX(hoveredCol) + offsets[hoveredCol + 1] - offsets[hoveredCol];
+                if (columnMaxX - mousePos.x <= s_resizeGrabSize) {
+                    hoveredBorder = hoveredCol;
+                } else if (mousePos.x - getColumnX(hoveredCol) <= s_resizeGrabSize && hoveredCol > 0) {
+                    hoveredBorder = hoveredCol - 1;
+                }
+            } else {
+                const auto idx = static_cast<size_t>((mousePos.y - bodyRect.Min.y + scrollY) / rowHeight) - static_cast<size_t>(firstRow);
+                if (idx < m_resultGridRows.size() && m_resultGridRows[idx].pCells != nullptr) {
+                    hoveredRow = m_resultGridRows[idx].idx;
+                    if (pressed) {
+                        m_selectResultCell(m_resultGridRows[idx], hoveredCol, ioSelRow, ioSelCol);
+                        selectionChanged = true;
+                    } else if (ImGui::IsMouseClicked(ImGuiMouseButton_Right)) {
+                        m_openResultCellContextMenu(m_resultGridRows[idx], hoveredCol);
+                    }
+                }
+            }
+            if (pressed && hoveredBorder >= 0) {
+                m_wideGridResizedColumn = hoveredBorder;
+            }
+        }
+        if (m_wideGridResizedColumn >= 0) {
+            if (held) {
+                // the next columns are shifted
+                const int col = m_wideGridResizedColumn;
+                const float width = std::max(mousePos.x - getColumnX(col), s_minColumnWidth);
+                const float delta = width - (offsets[col + 1] - offsets[col]);
+                for (size_t c = static_cast<size_t>(col) + 1U; c < m_wideGridColumnOffsets.size(); ++c) {
+                    m_wideGridColumnOffsets[c] += delta;
+                }
+            } else {
+                m_wideGridResizedColumn = -1;
+            }
+        }
+        if (hoveredBorder >= 0 || m_wideGridResizedColumn >= 0) {
+            ImGui::SetMouseCursor(ImGuiMouseCursor_ResizeEW);
+        }
+
+        // cells, the scrolled ones first, then the frozen ones over them
+        auto* drawListPtr = ImGui::GetWindowDrawList();
+        const ImU32 rowBgAltColor = ImGui::GetColorU32(ImGuiCol_TableRowBgAlt);
+        const ImU32 borderColor = ImGui::GetColorU32(ImGuiCol_TableBorderLight);
+        const ImU32 strongBorderColor = ImGui::GetColorU32(ImGuiCol_TableBorderStrong);
+        const auto drawCells = [&](const int vFirstCol, const int vEndCol, const ImRect& vClipRect) {
+            drawListPtr->PushClipRect(vClipRect.Min, vClipRect.Max, true);
+            for (const auto& row : m_resultGridRows) {
+                if ((row.idx % 2) != 0) {
+                    drawListPtr->AddRectFilled(ImVec2(vClipRect.Min.x, row.posY), ImVec2(vClipRect.Max.x, row.posY + rowHeight), rowBgAltColor);
+                }
+                for (int c = vFirstCol; c < vEndCol; ++c) {
+                    const float x = getColumnX(c);
+                    const ImVec2 textPos(x + style.CellPadding.x, row.posY + style.CellPadding.y);
+                    if (row.pCells == nullptr) {  // not fetched yet or after the end
+                        if (c == 0) {
+                            drawListPtr->AddText(textPos, ImGui::GetColorU32(ImGuiCol_TextDisabled), "...");
+                        }
+                        continue;
+                    }
+                    const ImRect cellRect(x, row.posY, x + offsets[c + 1] - offsets[c], row.posY + rowHeight);
+                    m_drawResultCell(  //
+                        drawListPtr,
+                        *row.pCells,
+                        c,
+                        cellRect,
+                        textPos,
+                        cellRect.Max.x - style.CellPadding.x,
+                        (ioSelRow == row.idx && ioSelCol == c),
+                        (hoveredRow == row.idx && hoveredCol == c),
+                        false);
+                }
+            }
+            for (int c = vFirstCol; c < vEndCol; ++c) {
+                const float x = getColumnX(c + 1) - 1.0f;
+                drawListPtr->AddLine(ImVec2(x, vClipRect.Min.y), ImVec2(x, vClipRect.Max.y), borderColor);
+            }
+            drawListPtr->PopClipRect();
+        };
+        const auto drawHeaders = [&](const int vFirstCol, const int vEndCol, const ImRect& vClipRect) {
+            drawListPtr->PushClipRect(vClipRect.Min, vClipRect.Max, true);
+            drawListPtr->AddRectFilled(vClipRect.Min, vClipRect.Max, ImGui::GetColorU32(ImGuiCol_TableHeaderBg));
+            for (int c = vFirstCol; c < vEndCol; ++c) {
+                const float x = getColumnX(c);
+                const float maxX = x + offsets[c + 1] - offsets[c];
+                const ImVec4 clipRect(x, vClipRect.Min.y, maxX - style.CellPadding.x, vClipRect.Max.y);
+                drawListPtr->AddText(  //
+                    ImGui::GetFont(),
+                    ImGui::GetFontSize(),
+                    ImVec2(x + style.CellPadding.x, vClipRect.Min.y + style.CellPadding.y),
+                    ImGui::GetColorU32(ImGuiCol_Text),
+                    columns[c].name.c_str(),
+                    nullptr,
+                    0.0f,
+                    &clipRect);
+                drawListPtr->AddLine(ImVec2(maxX - 1.0f, vClipRect.Min.y), ImVec2(maxX - 1.0f, vClipRect.Max.y), strongBorderColor);
+            }
+            drawListPtr->PopClipRect();
+        };
+        const float frozenMaxX = innerRect.Min.x + frozenWidth;
+        drawCells(firstCol, endCol, ImRect(ImVec2(frozenMaxX, bodyRect.Min.y), bodyRect.Max));
+        drawCells(0, frozenCount, ImRect(bodyRect.Min, ImVec2(frozenMaxX, bodyRect.Max.y)));
+        drawHeaders(firstCol, endCol, ImRect(ImVec2(frozenMaxX, innerRect.Min.y), ImVec2(innerRect.Max.x, bodyRect.Min.y)));
+        drawHeaders(0, frozenCount, ImRect(innerRect.Min, ImVec2(frozenMaxX, bodyRect.Min.y)));
+        drawListPtr->AddLine(ImVec2(innerRect.Min.x, bodyRect.Min.y - 1.0f), ImVec2(innerRect.Max.x, bodyRect.Min.y - 1.0f), strongBorderColor);
+    }
+    m_drawResultCellContextMenu(vCursor);
+    ImGui::EndChild();
+    return selectionChanged;
+}
+
+bool Controller::m_drawQueryResultTable(QueryCursor& vCursor, int& ioSelRow, int& ioSelCol) {
     bool needResizeToFit{false};
     if (ImGui::BeginMenuBar()) {
         if (ImGui::BeginMenu("Sizing")) {
@@ -365,12 +1188,37 @@ bool Controller::m_drawQueryResultTable(const QueryResult& vResult, int& ioSelRo
             }
             ImGui::EndMenu();
         }
+        if (ImGui::BeginMenu("Display")) {
+            auto format = m_cellTextCache.getFormat();
+            if (ImGui::SliderInt("Real precision", &format.realPrecision, 0, 17)) {
+                m_cellTextCache.setFormat(format);  // the cells are formatted again
+            }
+            ImGui::EndMenu();
+        }
+        if (ImGui::BeginMenu(ICON_FONT_DOWNLOAD " Export", !m_resultSql.empty() && !ResultExporter::ref().isRunning())) {
+            for (const auto format : {ResultExporter::Format::CSV, ResultExporter::Format::TSV, ResultExporter::Format::JSONL}) {
+                if (ImGui::MenuItem(ResultExporter::getFormatName(format))) {
+                    Frontend::ref().ActionMenuExportResults(format);
+                }
+            }
+            ImGui::EndMenu();
+        }
+        m_drawScriptStatementsMenu();
+        ImGui::Text("%zu%s rows", vCursor.getKnownRowsCount(), vCursor.isExhausted() ? "" : "+");
+        if (!vCursor.getLastErrorMsg().empty()) {
+            ImGui::TextColored(ImGui::CustomStyle::BadColor, "%s", vCursor.getLastErrorMsg().c_str());
+        }
         ImGui::EndMenuBar();
     }
     bool selectionChanged = false;
-    const int colCount = static_cast<int>(vResult.columns.size());
-    const int rowCount = static_cast<int>(vResult.rows.size());
-    if (ImGui::BeginTable(                     //
+    const auto& columns = vCursor.getColumns();
+    const int colCount = static_cast<int>(columns.size());
+    // while the statement is not exhausted, we expose one more block for let the user scroll to it
+    const size_t knownRowsCount = vCursor.getKnownRowsCount() + (vCursor.isExhausted() ? 0U : vCursor.getBlockSize());
+    const int rowCount = static_cast<int>(std::min<size_t>(knownRowsCount, INT32_MAX));
+    if (colCount > s_maxTableColumns) {
+        selectionChanged = m_drawWideResultGrid(vCursor, rowCount, needResizeToFit, ioSelRow, ioSelCol);
+    } else if (ImGui::BeginTable(              //
             "##QueryResultTable",              //
             colCount,                          //
             ImGuiTableFlags_Borders            //
@@ -381,72 +1229,95 @@ bool Controller::m_drawQueryResultTable(const QueryResult& vResult, int& ioSelRo
                 | ImGuiTableFlags_Reorderable  //
                 | ImGuiTableFlags_Hideable)) {
         ImGui::TableSetupScrollFreeze(0, 1);
-        for (const auto& col : vResult.columns) {
+        for (const auto& col : columns) {
             ImGui::TableSetupColumn(col.name.c_str(), ImGuiTableColumnFlags_WidthFixed);
         }
         ImGui::TableHeadersRow();
-        m_textHeight = ImGui::GetTextLineHeight();
-        m_queryResultTableClipper.Begin(rowCount, ImGui::GetTextLineHeightWithSpacing());
+        // no widget per cell : the rows only reserve their height, then the cells of each column are
+        // drawn in one pass in the column draw channel, and the selection is hit-tested once per frame
+        const auto& style = ImGui::GetStyle();
+        const float rowHeight = ImGui::GetTextLineHeight() + style.CellPadding.y * 2.0f;
+        auto* tablePtr = ImGui::GetCurrentTable();
+        m_resultGridRows.clear();
+        m_queryResultTableClipper.Begin(rowCount, rowHeight);
         while (m_queryResultTableClipper.Step()) {
+            // read in a worker, the rows will come in a next frame
+            m_fetchCursorRows(  //
+                vCursor,
+                static_cast<size_t>(std::max(m_queryResultTableClipper.DisplayStart - s_prefetchRowsMargin, 0)),
+                static_cast<size_t>(std::max(m_queryResultTableClipper.DisplayEnd + s_prefetchRowsMargin, 0)));
             for (int r = m_queryResultTableClipper.DisplayStart; r < m_queryResultTableClipper.DisplayEnd; ++r) {
                 if (r < 0) {
                     continue;
                 }
-                const auto& row = vResult.rows.at(r);
-                ImGui::TableNextRow();
-                for (int c = 0; c < colCount; ++c) {
-                    SqliteType columnType{SqliteType::TYPE_TEXT};
-                    ImGui::TableSetColumnIndex(c);
-                    const char* label = "";
-                    static char buf[256];
-                    buf[0] = '\0';
-                    if (c < static_cast<int>(row.values.size())) {
-                        const auto& cell = row.values.at(c);
-                        std::visit(
-                            [&](auto&& val) {
-                                using T = std::decay_t<decltype(val)>;
-                                if constexpr (std::is_same_v<T, int64_t>) {  // type INTEGER
-                                    columnType = SqliteType::TYPE_INTEGER;
-                                    snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(val));
-                                } else if constexpr (std::is_same_v<T, double>) {  // type REAL
-                                    columnType = SqliteType::TYPE_REAL;
-                                    snprintf(buf, sizeof(buf), "%.6f", val);
-                                } else if constexpr (std::is_same_v<T, std::string>) {  // type TEXT
-                                    columnType = SqliteType::TYPE_TEXT;
-                                    if (val.size() < sizeof(buf)) {
-                                        memcpy(buf, val.c_str(), val.size() + 1);
-                                    } else {
-                                        snprintf(buf, sizeof(buf), "%.*s…", (int)sizeof(buf) - 2, val.c_str());
-                                    }
-                                } else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {  // type blob
-                                    columnType = SqliteType::TYPE_BLOB;
-                                    snprintf(buf, sizeof(buf), "[BLOB] %zu bytes", val.size());
-                                } else if constexpr (std::is_same_v<T, std::nullptr_t>) {  // type NULL
-                                    columnType = SqliteType::TYPE_NULL;
-                                    snprintf(buf, sizeof(buf), "NULL");
-                                }
-                            },
-                            cell);
-                        label = buf[0] ? buf : "";
+                ImGui::TableNextRow(ImGuiTableRowFlags_None, rowHeight);
+                ResultGridRow row;
+                row.idx = r;
+                row.posY = tablePtr->RowPosY1;
+                row.pBlock = vCursor.getRowBlock(static_cast<size_t>(r), row.blockRow);
+                if (row.pBlock != nullptr) {
+                    row.pCells = &m_cellTextCache.getRow(static_cast<size_t>(r), *row.pBlock, row.blockRow);
+                }
+                m_resultGridRows.push_back(row);
+            }
+        }
+        if (!m_resultGridRows.empty()) {
+            // hit test, the headers, the resize borders and the scrollbars are items
+            int hoveredRow = -1;
+            const int hoveredCol = ImGui::TableGetHoveredColumn();
+            if (hoveredCol >= 0 && ImGui::IsWindowHovered() && !ImGui::IsAnyItemHovered()) {
+                const float mouseY = ImGui::GetMousePos().y;
+                const float offsetY = mouseY - m_resultGridRows.front().posY;
+                if (offsetY >= 0.0f) {
+                    const auto idx = static_cast<size_t>(offsetY / rowHeight);
+                    if (idx < m_resultGridRows.size() && m_resultGridRows[idx].pBlock != nullptr) {
+                        hoveredRow = m_resultGridRows[idx].idx;
+                        if (ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
+                            m_selectResultCell(m_resultGridRows[idx], hoveredCol, ioSelRow, ioSelCol);
+                            selectionChanged = true;
+                        } else if (ImGui::IsMouseClicked(ImGuiMouseButton_Right) && m_resultGridRows[idx].pCells != nullptr) {
+                            m_openResultCellContextMenu(m_resultGridRows[idx], hoveredCol);
+                        }
                     }
-                    ImGui::PushID(r);
-                    ImGui::PushID(c);
-                    //if (columnType != SqliteType::TYPE_TEXT) {
-                        m_colorizeTableCell(m_getSqliteTypeColor(columnType));
-                    //}
-                    const bool isSelected = (ioSelRow == r && ioSelCol == c);
-                    if (ImGui::Selectable(  //
-                            label,
-                            isSelected,
-                            ImGuiSelectableFlags_AllowOverlap,
-                            ImVec2(0, m_textHeight))) {
-                        ioSelRow = r;
-                        ioSelCol = c;
-                        vOutValue = label;
-                        selectionChanged = true;
+                }
+            }
+            auto* drawListPtr = ImGui::GetWindowDrawList();
+            const ImU32 disabledTextColor = ImGui::GetColorU32(ImGuiCol_TextDisabled);
+            for (int c = 0; c < colCount; ++c) {
+                if (!ImGui::TableSetColumnIndex(c)) {  // hidden or clipped
+                    continue;
+                }
+                const auto& column = tablePtr->Columns[c];
+                const float textX = ImGui::GetCursorScreenPos().x;
+                const bool needContentWidth = (column.AutoFitQueue != 0);  // measured only for the auto fit
+                float contentWidth = 0.0f;
+                for (const auto& row : m_resultGridRows) {
+                    const ImVec2 cellMin(column.MinX, row.posY);
+                    const ImVec2 cellMax(column.MaxX, row.posY + rowHeight);
+                    const ImVec2 textPos(textX, row.posY + style.CellPadding.y);
+                    if (row.pCells == nullptr) {  // not fetched yet or after the end
+                        if (c == 0) {
+                            drawListPtr->AddText(textPos, disabledTextColor, "...");
+                        }
+                        continue;
                     }
-                    ImGui::PopID();  // c
-                    ImGui::PopID();  // r
+                    const bool isSelected = (ioSelRow == row.idx && ioSelCol == c);
+                    const bool isHovered = (hoveredRow == row.idx && hoveredCol == c);
+                    const float width = m_drawResultCell(  //
+                        drawListPtr,
+                        *row.pCells,
+                        c,
+                        ImRect(cellMin, cellMax),
+                        textPos,
+                        column.WorkMaxX,
+                        isSelected,
+                        isHovered,
+                        needContentWidth);
+                    contentWidth = std::max(contentWidth, width);
+                }
+                if (needContentWidth) {
+                    auto& cursorMaxPos = ImGui::GetCurrentWindow()->DC.CursorMaxPos;
+                    cursorMaxPos.x = std::max(cursorMaxPos.x, textX + contentWidth);
                 }
             }
         }
@@ -454,11 +1325,155 @@ bool Controller::m_drawQueryResultTable(const QueryResult& vResult, int& ioSelRo
         if (needResizeToFit) {
             ImGui::TableSetColumnWidthAutoAll(ImGui::GetCurrentContext()->CurrentTable);
         }        
+        m_drawResultCellContextMenu(vCursor);
         ImGui::EndTable();
     }
     return selectionChanged;
 }
 
+void Controller::m_onQueryCompleted(QueryJob& vJob, const bool vSaveQuery) {
+    if (m_queryJob.get() == &vJob) {
+        m_queryJob.reset();
+    }
+    clearResults();
+    int32_t errorLine = 0;
+    const bool isScript = vJob.isScript();  // false once the script result is taken
+    if (isScript) {
+        // the results of the executed statements are shown even if the script failed
+        m_scriptResult = vJob.takeScriptResult();
+        const auto& statements = m_scriptResult.statements;
+        size_t idx = statements.size() - 1U;
+        if (statements.back().errorMsg.empty()) {
+            // the last statement returning rows is the most interesting
+            for (size_t i = statements.size(); i > 0U; --i) {
+                if (statements[i - 1U].result.isValid()) {
+                    idx = i - 1U;
+                    break;
+                }
+            }
+        } else {
+            const auto& sql = vJob.getSql();
+            errorLine = static_cast<int32_t>(std::count(sql.begin(), sql.begin() + statements.back().offset, '\n'));
+        }
+        m_selectScriptStatement(idx);
+    }
+    if (vJob.isSucceeded()) {
+        if (!isScript) {
+            m_queryCursor = vJob.takeCursor();
+            m_resultSql = vJob.getSql();
+        }
+        if (vSaveQuery) {
+            m_addQueryToHistory(vJob.getSql());
+        }
+        // not for a script, the run time would be the one of all the statements
+        auto plan = vJob.takePlan();
+        if (!isScript && plan.isValid()) {
+            plan.elapsedMs = vJob.getElapsedMs();
+            m_addQueryPlan(std::move(plan));
+        }
+        CodeEditor::ref().clearErrorMarkers();
+        reanalyzeDatabase();
+    } else {
+        if (vJob.getState() == QueryJob::State::FAILED) {
+            CodeEditor::ErrorMarker marker;
+            marker.line = errorLine;
+            marker.lineNumberColor = IM_COL32(200, 20, 20, 150);
+            marker.textColor = IM_COL32(200, 20, 20, 150);
+            marker.textTooltip = vJob.getErrorMsg();
+            CodeEditor::ref().clearErrorMarkers();
+            CodeEditor::ref().addErrorMarker(marker);
+        } else {  // canceled or timed out
+            LogVarError("%s", vJob.getErrorMsg().c_str());
+        }
+    }
+}
+
+void Controller::m_selectScriptStatement(const size_t vIdx) {
+    if (vIdx < m_scriptResult.statements.size()) {
+        m_scriptStatementIdx = static_cast<int32_t>(vIdx);
+        // the detached cursor get a copy, the script keep the results for the others selections
+        QueryResult result = m_scriptResult.statements.at(vIdx).result;
+        m_stopCursorFetch();
+        m_queryCursor = std::make_unique<QueryCursor>();
+        m_queryCursor->open(std::move(result));
+        m_resultSql = m_scriptResult.statements.at(vIdx).sql;
+        m_cellTextCache.clear();
+        m_wideGridColumnOffsets.clear();
+        m_selRow = -1;
+        m_selCol = -1;
+        m_valueViewer.clear();
+        m_valueViewer.clearImages();
+    }
+}
+
+// one fetch at a time, the next rows are asked at the frame following its completion
+void Controller::m_fetchCursorRows(QueryCursor& vCursor, const size_t vStart, const size_t vEnd) {
+    if (m_cursorFetchJob != nullptr || !vCursor.needFetch(vStart, vEnd)) {
+        return;
+    }
+    m_cursorFetchJob = QueryManager::ref().pushCursorFetch(&vCursor, vStart, vEnd, m_queryTimeoutMs, [this](QueryJob& vJob) {
+        if (m_cursorFetchJob.get() != &vJob) {
+            return;  // the cursor was closed
+        }
+        m_cursorFetchJob.reset();
+        if (m_queryCursor != nullptr && !m_queryCursor->applyBlocks()) {
+            LogVarError("Failed to fetch the rows : %s", vJob.getErrorMsg().c_str());
+        }
+    });
+}
+
+void Controller::m_stopCursorFetch() {
+    QueryManager::ref().cancelQueryAndWait(m_cursorFetchJob);
+    m_cursorFetchJob.reset();
+}
+
+void Controller::m_drawScriptStatementsMenu() {
+    if (!m_scriptResult.isValid()) {
+        return;
+    }
+    const auto& statements = m_scriptResult.statements;
+    const auto menuLabel = ez::str::toStr(  //
+        ICON_FONT_SCRIPT_TEXT " Statement %i/%zu###ScriptStatements",
+        m_scriptStatementIdx + 1,
+        statements.size());
+    if (ImGui::BeginMenu(menuLabel.c_str())) {
+        for (size_t i = 0; i < statements.size(); ++i) {
+            const auto& statement = statements.at(i);
+            std::string sql = statement.sql.substr(0, statement.sql.find('\n'));
+            if (sql.size() > 64U) {
+                sql = sql.substr(0, 64U) + "...";
+            }
+            const auto label = ez::str::toStr("#%zu %s##%zu", i + 1U, sql.c_str(), i);
+            const auto infos = ez::str::toStr(  //
+                "%.2f ms | %lld changes | %zu rows",
+                statement.elapsedMs,
+                static_cast<long long>(statement.changesCount),
+                statement.result.getRowsCount());
+            const bool hasError = !statement.errorMsg.empty();
+            if (hasError) {
+                ImGui::PushStyleColor(ImGuiCol_Text, ImGui::CustomStyle::BadColor);
+            }
+            if (ImGui::MenuItem(label.c_str(), infos.c_str(), m_scriptStatementIdx == static_cast<int32_t>(i))) {
+                m_scriptStatementToSelect = static_cast<int32_t>(i);
+            }
+            if (hasError) {
+                ImGui::PopStyleColor();
+            }
+            if (ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("%s%s%s", statement.sql.c_str(), hasError ? "\n\n" : "", statement.errorMsg.c_str());
+            }
+        }
+        ImGui::EndMenu();
+    }
+    if (m_scriptStatementIdx >= 0 && m_scriptStatementIdx < static_cast<int32_t>(statements.size())) {
+        const auto& statement = statements.at(m_scriptStatementIdx);
+        ImGui::Text("%.2f ms, %lld changes%s", statement.elapsedMs, static_cast<long long>(statement.changesCount), m_scriptResult.inTransaction ? " (transaction)" : "");
+        if (!statement.errorMsg.empty()) {
+            ImGui::TextColored(ImGui::CustomStyle::BadColor, "%s", statement.errorMsg.c_str());
+        }
+    }
+}
+
 void Controller::m_addQueryToHistory(const std::string& vQuery) {
     if (m_history.uniqueQuery.find(vQuery) == m_history.uniqueQuery.end()) {
         m_history.uniqueQuery.emplace(vQuery);
@@ -466,24 +1481,335 @@ void Controller::m_addQueryToHistory(const std::string& vQuery) {
     }
 }
 
+// the pointers of the rows are valid until the next analyze, who set m_structureRowsDirty
+void Controller::m_buildStructureRows() {
+    m_structureRows.clear();
+    for (auto& database : m_databases.databases) {
+        m_structureRows.push_back({&database, nullptr, -1});
+        if (!database.expanded) {
+            continue;
+        }
+        for (auto& table : database.tables) {
+            m_structureRows.push_back({&database, &table, -1});
+            if (!table.expanded) {
+                continue;
+            }
+            if (!table.fieldsLoaded && !table.fieldsRequested) {
+                m_requestTableFields(database, table);
+            }
+            for (size_t f = 0; f < table.fields.size(); ++f) {
+                m_structureRows.push_back({&database, &table, static_cast<int32_t>(f)});
+            }
+        }
+    }
+    m_structureRowsDirty = false;
+}
+
+// the table is found again by its name at the completion, the tables can be merged meanwhile
+void Controller::m_requestTableFields(const Database& vDatabase, TableDatas& vTableDatas) {
+    struct FieldsLoading {
+        std::vector<TableFieldDatas> fields;
+        std::string errorMsg;
+    };
+    auto pLoading = std::make_shared<FieldsLoading>();
+    vTableDatas.fieldsRequested = true;
+    const auto databaseName = vDatabase.name;
+    const auto tableName = vTableDatas.name;
+    const auto tableSql = vTableDatas.sql;
+    JobManager::ref().pushJob(  //
+        Job::Priority::INTERACTIVE,
+        [tableName, pLoading](Job& /*vJob*/) {  //
+            m_loadTableFields(tableName, pLoading->fields, pLoading->errorMsg);
+        },
+        [this, databaseName, tableName, tableSql, pLoading](Job& vJob) {
+            for (auto& database : m_databases.databases) {
+                if (database.name != databaseName) {
+                    continue;
+                }
+                auto& tables = database.tables;
+                auto it = std::lower_bound(tables.begin(), tables.end(), tableName, [](const TableDatas& vTable, const std::string& vName) {
+                    return vTable.name < vName;
+                });
+                if (it == tables.end() || it->name != tableName || it->sql != tableSql) {
+                    break;  // removed or altered, an other request is done for the new one
+                }
+                if (vJob.getState() == Job::State::CANCELED) {
+                    it->fieldsRequested = false;
+                    break;
+                }
+                if (!pLoading->errorMsg.empty()) {
+                    LogVarError("Failed to load the fields of the table %s : %s", tableName.c_str(), pLoading->errorMsg.c_str());
+                }
+                it->fields = std::move(pLoading->fields);
+                it->fieldsLoaded = true;  // even on error, else it will be tried at each frame
+                m_structureRowsDirty = true;
+                break;
+            }
+        });
+}
+
+bool Controller::m_loadTableFields(const std::string& vTableName, std::vector<TableFieldDatas>& vOutFields, std::string& vOutErrorMsg) {
+    std::string tableName;  // in a sql string literal
+    for (const auto c : vTableName) {
+        if (c == '\'') {
+            tableName += '\'';
+        }
+        tableName += c;
+    }
+    const auto& results = DBHelper::ref().executeReadQuery(  //
+        "SELECT cid, name, type, \"notnull\", dflt_value, pk FROM pragma_table_info('" + tableName + "');",
+        &vOutErrorMsg);
+    vOutFields.clear();
+    if (!vOutErrorMsg.empty()) {
+        return false;
+    }
+    vOutFields.reserve(results.getRowsCount());
+    for (size_t r = 0; r < results.getRowsCount(); ++r) {
+        TableFieldDatas fldDatas;
+        fldDatas.cid = static_cast<RowID>(results.getInteger(r, 0));
+        fldDatas.name = results.getText(r, 1);
+        fldDatas.type = results.getText(r, 2);
+        if (fldDatas.type == "INTEGER") {
+            fldDatas.type = "INT";  // fro compact table column display
+        }
+        fldDatas.notNull = (results.getInteger(r, 3) != 0);
+        fldDatas.defaultValue = results.getText(r, 4);  // empty if NULL
+        fldDatas.primaryKey = (results.getInteger(r, 5) != 0);
+        vOutFields.push_back(fldDatas);
+    }
+    return true;
+}
+
 void Controller::m_drawTableContextMenu(const TableDatas& vTableDatas) {
     if (ImGui::MenuItem("Show SELECT statement")) {
         CodeEditor::ref().setCode("SELECT * FROM " + vTableDatas.name + ";");
     }
     if (ImGui::MenuItem("Show CREATE statement")) {
-        m_actions.pushBackImmediateAction([this, &vTableDatas]() {
-            if (executeQuery("SELECT sql FROM sqlite_schema WHERE name = '" + vTableDatas.name + "';", false)) {
-                if (m_queryResult.isValid()) {
-                    CodeEditor::ref().setCode(  //
-                        std::get<std::string>(  //
-                            m_queryResult.rows.front().values.front()));
-                    m_queryResult.clear();
+        QueryManager::ref().pushQuery(  //
+            "SELECT sql FROM sqlite_schema WHERE name = '" + vTableDatas.name + "';",
+            0,
+            [](QueryJob& vJob) {
+                const auto& result = vJob.getResultRef();
+                if (vJob.isSucceeded() && result.isValid()) {
+                    CodeEditor::ref().setCode(std::string(result.getText(0, 0)));
                 }
-            }
-        });
+            });
     }
     ImGui::Separator();
     if (ImGui::MenuItem("Show DROP TABLE statement")) {
         CodeEditor::ref().setCode("DROP TABLE " + vTableDatas.name + ";");
     }
 }
+
+// the new plan is compared with the previous one
+void Controller::m_addQueryPlan(QueryPlan&& vQueryPlan) {
+    vQueryPlan.number = ++m_queryPlansCount;
+    m_leftPlanNumber = m_rightPlanNumber;
+    m_rightPlanNumber = vQueryPlan.number;
+    m_queryPlans.push_back(std::move(vQueryPlan));
+    while (m_queryPlans.size() > s_maxQueryPlans) {
+        m_queryPlans.pop_front();
+    }
+}
+
+const QueryPlan* Controller::m_getQueryPlan(const size_t vNumber) const {
+    for (const auto& plan : m_queryPlans) {
+        if (plan.number == vNumber) {
+            return &plan;
+        }
+    }
+    return nullptr;
+}
+
+void Controller::m_drawQueryPlanSelector(const char* vLabel, size_t& ioPlanNumber) {
+    if (ImGui::BeginMenu(vLabel)) {
+        if (m_queryPlans.empty()) {
+            ImGui::TextDisabled("No plans");
+        }
+        for (auto it = m_queryPlans.rbegin(); it != m_queryPlans.rend(); ++it) {
+            const auto sql = it->sql.substr(0, std::min<size_t>(it->sql.find('\n'), 60U));
+            const auto label = (it->elapsedMs < 0.0)  //
+                ? ez::str::toStr("#%zu explained : %s", it->number, sql.c_str())
+                : ez::str::toStr("#%zu %.3f ms : %s", it->number, it->elapsedMs, sql.c_str());
+            if (ImGui::MenuItem(label.c_str(), nullptr, it->number == ioPlanNumber)) {
+                ioPlanNumber = it->number;
+            }
+        }
+        ImGui::EndMenu();
+    }
+}
+
+void Controller::m_drawQueryPlan(const QueryPlan& vQueryPlan) {
+    if (vQueryPlan.number == 0U) {
+        // not in the history, like the plans of the index advisor
+    } else if (vQueryPlan.elapsedMs < 0.0) {
+        ImGui::Text("#%zu, explained without execution", vQueryPlan.number);
+    } else {
+        ImGui::Text("#%zu, executed in %.3f ms", vQueryPlan.number, vQueryPlan.elapsedMs);
+    }
+    const auto warningsCount = vQueryPlan.getWarningsCount();
+    if (warningsCount > 0U) {
+        if (vQueryPlan.number != 0U) {
+            ImGui::SameLine();
+        }
+        ImGui::TextColored(ImGui::CustomStyle::BadColor, "(%zu warnings)", warningsCount);
+    }
+    ImGui::TextWrapped("%s", vQueryPlan.sql.c_str());
+    if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
+        CodeEditor::ref().setCode(vQueryPlan.sql);
+    }
+    ImGui::Separator();
+    // the nodes are in the depth first order, the children of a closed node are skipped
+    int32_t closedDepth = -1;
+    int32_t openedDepth = 0;  // count of the opened tree nodes
+    for (size_t idx = 0; idx < vQueryPlan.nodes.size(); ++idx) {
+        const auto& node = vQueryPlan.nodes.at(idx);
+        if (closedDepth >= 0 && node.depth > closedDepth) {
+            continue;
+        }
+        closedDepth = -1;
+        while (openedDepth > node.depth) {
+            ImGui::TreePop();
+            --openedDepth;
+        }
+        ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_DefaultOpen;
+        if (!node.hasChildren) {
+            flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+        }
+        const bool warning = (node.kind != QueryPlanNode::Kind::NORMAL);
+        if (warning) {
+            ImGui::PushStyleColor(ImGuiCol_Text, ImGui::CustomStyle::BadColor);
+        }
+        const bool opened = ImGui::TreeNodeEx(reinterpret_cast<void*>(idx), flags, "%s", node.detail.c_str());
+        if (warning) {
+            ImGui::PopStyleColor();
+            if (ImGui::IsItemHovered()) {
+                switch (node.kind) {
+                    case QueryPlanNode::Kind::FULL_SCAN: ImGui::SetTooltip("Full table scan, an index can be missing"); break;
+                    case QueryPlanNode::Kind::TEMP_BTREE: ImGui::SetTooltip("Temporary b-tree, an index can give the order"); break;
+                    case QueryPlanNode::Kind::AUTO_INDEX: ImGui::SetTooltip("Automatic index built at each execution, an index is missing"); break;
+                    default: break;
+                }
+            }
+        }
+        if (node.hasChildren) {
+            if (opened) {
+                ++openedDepth;
+            } else {
+                closedDepth = node.depth;
+            }
+        }
+    }
+    while (openedDepth > 0) {
+        ImGui::TreePop();
+        --openedDepth;
+    }
+}
+
+// flame like view of the cycles by element of the plan, the children are under their parent
+void Controller::m_drawScanStatus(const StatementProfile& vProfile) {
+    if (ImGui::SmallContrastedButton("X")) {
+        m_selectedProfile = StatementProfile();
+        return;
+    }
+    ImGui::SameLine();
+    const auto sqlFirstLine = vProfile.sql.substr(0, vProfile.sql.find('\n'));
+    ImGui::Text("%.3f ms : %s", vProfile.elapsedMs, sqlFirstLine.c_str());
+    if (vProfile.scans.empty()) {
+        ImGui::TextDisabled("No scan status, sqlite must be built with SQLITE_ENABLE_STMT_SCANSTATUS");
+        return;
+    }
+    if (vProfile.cycles > 0) {
+        ImGui::Text("%lld cycles", static_cast<long long>(vProfile.cycles));
+    }
+    if (ImGui::BeginChild("##ScanStatus")) {
+        auto* pDrawList = ImGui::GetWindowDrawList();
+        const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+        const float fullWidth = ImGui::GetContentRegionAvail().x;
+        const float indent = ImGui::GetStyle().IndentSpacing;
+        const auto& style = ImGui::GetStyle();
+        for (size_t idx = 0; idx < vProfile.scans.size(); ++idx) {
+            const auto& scan = vProfile.scans.at(idx);
+            double ratio = 0.0;
+            if (vProfile.cycles > 0 && scan.cycles > 0) {
+                ratio = static_cast<double>(scan.cycles) / static_cast<double>(vProfile.cycles);
+            }
+            const bool mismatch = scan.isEstimateMismatch();
+            const auto pos = ImGui::GetCursorScreenPos();
+            ImGui::PushID(static_cast<int>(idx));
+            ImGui::InvisibleButton("##scan", ImVec2(fullWidth, rowHeight));
+            ImGui::PopID();
+            const float x = pos.x + indent * static_cast<float>(scan.depth);
+            const float barWidth = std::max((fullWidth - indent * static_cast<float>(scan.depth)) * static_cast<float>(ratio), 2.0f);
+            const auto barColor = mismatch ? ImGui::GetColorU32(ImGui::CustomStyle::BadColor) : ImGui::GetColorU32(ImGuiCol_PlotHistogram);
+            pDrawList->AddRectFilled(ImVec2(x, pos.y), ImVec2(x + barWidth, pos.y + rowHeight - 1.0f), barColor);
+            const auto label = ez::str::toStr(  //
+                "%s  %.1f%%  rows %.1f est %.1f",
+                scan.explain.empty() ? scan.name.c_str() : scan.explain.c_str(),
+                ratio * 100.0,
+                scan.getActualRows(),
+                scan.estimatedRows);
+            pDrawList->AddText(ImVec2(x + style.FramePadding.x, pos.y), ImGui::GetColorU32(ImGuiCol_Text), label.c_str());
+            if (ImGui::IsItemHovered()) {
+                ImGui::BeginTooltip();
+                ImGui::TextUnformatted(scan.explain.c_str());
+                ImGui::Text("loops : %lld", static_cast<long long>(scan.loopsCount));
+                ImGui::Text("visited rows : %lld", static_cast<long long>(scan.visitsCount));
+                ImGui::Text("rows by loop : %.1f, estimated : %.1f", scan.getActualRows(), scan.estimatedRows);
+                ImGui::Text("cycles : %lld (%.1f%%)", static_cast<long long>(scan.cycles), ratio * 100.0);
+                if (mismatch) {
+                    ImGui::TextColored(ImGui::CustomStyle::BadColor, "The planner estimate is wrong, ANALYZE can fix it");
+                }
+                ImGui::EndTooltip();
+            }
+        }
+    }
+    ImGui::EndChild();
+}
+
+// the executed queries of the plans history, unique, the slowest first
+std::vector<std::string> Controller::m_getSlowestQueries(const size_t vCount) const {
+    std::vector<const QueryPlan*> executedPlans;
+    for (const auto& plan : m_queryPlans) {
+        if (plan.elapsedMs >= 0.0) {
+            executedPlans.push_back(&plan);
+        }
+    }
+    std::sort(executedPlans.begin(), executedPlans.end(), [](const QueryPlan* vA, const QueryPlan* vB) {  //
+        return vA->elapsedMs > vB->elapsedMs;
+    });
+    std::vector<std::string> ret;
+    for (const auto* pPlan : executedPlans) {
+        if (ret.size() >= vCount) {
+            break;
+        }
+        if (std::find(ret.begin(), ret.end(), pPlan->sql) == ret.end()) {
+            ret.push_back(pPlan->sql);
+        }
+    }
+    return ret;
+}
+
+// a single statement is atomic, the index is created in its own transaction
+void Controller::m_createAdvisedIndex(const std::string& vCreateSql, const std::string& vQuery) {
+    if (m_indexJob != nullptr && !m_indexJob->isFinished()) {
+        LogVarError("An index is already being created");
+        return;
+    }
+    m_indexJob = QueryManager::ref().pushQuery(vCreateSql, 0, [this, vCreateSql, vQuery](QueryJob& vJob) {
+        if (!vJob.isSucceeded()) {
+            LogVarError("Failed to create the index : %s", vJob.getErrorMsg().c_str());
+            return;
+        }
+        LogVarInfo("Index created in %.2f s", vJob.getElapsedMs() / 1000.0);
+        for (auto& advice : m_indexAdvices) {
+            auto& createIndexes = advice.createIndexes;
+            createIndexes.erase(std::remove(createIndexes.begin(), createIndexes.end(), vCreateSql), createIndexes.end());
+        }
+        reanalyzeDatabase();
+        // timed again, the plans pane compare the new plan with the previous one
+        if (!vQuery.empty() && !isQueryRunning()) {
+            executeQuery(vQuery, false);
+        }
+    });
+}
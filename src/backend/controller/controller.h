@@ -27,10 +27,19 @@
 #include <ezlibs/ezSingleton.hpp>
 #include <ezlibs/ezActions.hpp>
 #include <backend/helpers/dbHelper.h>
+#include <backend/managers/queryManager.h>
+#include <backend/managers/jobManager.h>
+#include <backend/helpers/resultExporter.h>
+#include <backend/helpers/queryProfiler.h>
+#include <backend/helpers/queryPlan.h>
+#include <backend/helpers/indexAdvisor.h>
+#include <backend/helpers/cellTextCache.h>
+#include <frontend/components/valueViewer.h>
 
 #include <string>
 #include <vector>
 #include <map>
+#include <deque>
 #include <set>
 
 struct TableFieldDatas {
@@ -46,16 +55,24 @@ struct TableFieldDatas {
 
 struct TableDatas {
     std::string name;
+    std::string sql;  // CREATE statement, changed by an ALTER TABLE
     std::vector<TableFieldDatas> fields;
+    bool fieldsLoaded{false};  // the fields are loaded by a job when the table is expanded
+    bool fieldsRequested{false};
+    bool expanded{false};
     void clear() { *this = TableDatas(); }
     bool isValid() { return (!name.empty()) && (!fields.empty()); }
 };
 
 struct Database {
     std::string name;
-    ez::cnt::DicoVector<std::string, TableDatas> tables;
+    std::vector<TableDatas> tables;  // sorted by name
+    bool expanded{true};
     void clear() { *this = Database(); }
     bool isValid() { return !tables.empty(); }
+    // vTables must be sorted by name. the tables with the same sql are kept with their loaded fields,
+    // return the count of added, modified or removed tables
+    size_t mergeTables(std::vector<TableDatas>&& vTables);
 };
 
 struct Databases {
@@ -86,22 +103,87 @@ class Controller : public ez::xml::Config {
 private:
     History m_history;
     Databases m_databases;
+    int64_t m_schemaVersion{-1};  // version of the analyzed schema, -1 if not analyzed
+    JobPtr m_analyzeJob;  // analyze done after the queries
+    bool m_analyzeAgain{false};  // asked while m_analyzeJob was running
+    uint32_t m_analyzeGeneration{0U};  // incremented by clearAnalyze, the older analyzes are dropped
+    // visible rows of the structure tree, drawn through a clipper. pTable is null for a database row, fieldIdx is -1 for a table row
+    struct StructureRow {
+        Database* pDatabase{nullptr};
+        TableDatas* pTable{nullptr};
+        int32_t fieldIdx{-1};
+    };
+    std::vector<StructureRow> m_structureRows;
+    bool m_structureRowsDirty{true};  // rebuilt after an analyze, an expand or a collapse
+    ImGuiListClipper m_structureTreeClipper;
+    std::vector<StatementProfile> m_profiles;  // copy of the profiler datas, updated when its generation change
+    uint64_t m_profilesGeneration{0U};
+    ImGuiListClipper m_profilerClipper;
+    StatementProfile m_selectedProfile;  // shown with its scan status, none if the sql is empty
+    static const size_t s_maxQueryPlans;  // the oldest plans are dropped
+    std::deque<QueryPlan> m_queryPlans;  // explained or executed queries, oldest first
+    size_t m_queryPlansCount{0U};  // number of the last plan
+    size_t m_leftPlanNumber{0U};  // compared plans, 0 for none
+    size_t m_rightPlanNumber{0U};
+    static const size_t s_slowestQueriesCount;  // advised from the plans history
+    std::vector<IndexAdvice> m_indexAdvices;  // of the last advisor run
+    QueryJobPtr m_indexJob;  // creation of an advised index
+    JobPtr m_explainJob;  // plan asked by the Explain menu
+    JobPtr m_rowidSearchJob;  // location of the cell of the context menu
+    static const int32_t s_prefetchRowsMargin;  // rows fetched around the visible ones
+    static const int32_t s_maxTableColumns;  // above, the result is drawn in a grid virtualized on the columns too
+    static const int32_t s_frozenColumnsCount;  // key columns of the wide grid, always visible
     ImGuiListClipper m_queryResultTableClipper;
-    float m_textHeight{0.0f};
-    QueryResult m_queryResult;
-    std::string m_cellValue;
+    // visible rows of the result grid, the cells are drawn column by column in the draw list
+    struct ResultGridRow {
+        int32_t idx{-1};
+        float posY{0.0f};
+        const QueryResult* pBlock{nullptr};  // null if not fetched yet
+        size_t blockRow{0U};
+        CellTextCache::Row* pCells{nullptr};  // null if not fetched yet
+    };
+    std::vector<ResultGridRow> m_resultGridRows;
+    CellTextCache m_cellTextCache;  // cleared when the shown result change
+    std::vector<float> m_wideGridColumnOffsets;  // cumulated widths of the wide grid columns, the last is the total
+    int32_t m_wideGridResizedColumn{-1};
+    bool m_wideGridNeedFit{false};  // the columns are sized on the first fetched rows
+    std::unique_ptr<QueryCursor> m_queryCursor;
+    QueryJobPtr m_cursorFetchJob;  // rows of m_queryCursor read in a worker
+    std::string m_resultSql;  // sql of the shown result, executed again by the export
+    ValueViewer m_valueViewer;  // of the selected cell
     int32_t m_selRow{-1};
     int32_t m_selCol{-1};
+    // cell of the context menu of the result grid
+    int32_t m_contextCellRow{-1};
+    int32_t m_contextCellCol{-1};
+    SqliteType m_contextCellType{SqliteType::TYPE_NULL};
     ez::Actions m_actions;
+    QueryJobPtr m_queryJob;
+    int32_t m_queryTimeoutMs{0};  // 0 => no timeout
+    ScriptResult m_scriptResult;
+    int32_t m_scriptStatementIdx{-1};  // statement shown in the result table
+    int32_t m_scriptStatementToSelect{-1};  // applied after the drawing of the table, who use the current cursor
+    bool m_scriptInTransaction{false};
 
 public:
     bool init();
     void unit();
 
     void clearAnalyze();
+    void clearResults();
 
+    // the schema is loaded again only if its version changed since the last analyze
     bool analyzeDatabase(const std::string& vDatabaseFilePathName);
-    bool executeQuery(const std::string& vQuery, const bool vSaveQuery);
+    void reanalyzeDatabase();  // same in a job, for the changes done by the queries
+    bool executeQuery(const std::string& vQuery, const bool vSaveQuery);  // asynchronous, the result is applied at frame start
+    void cancelQuery();
+    bool isQueryRunning() const;
+    bool explainQuery(const std::string& vQuery);  // asynchronous, the plan is added to the history without execution
+    bool adviseIndexes(const std::vector<std::string>& vQueries);  // asynchronous
+    bool importCsvFile(const std::string& vFilePathName);  // asynchronous, in a new table
+    bool exportResults(const std::string& vFilePathName, const ResultExporter::Format vFormat);  // asynchronous
+    bool saveCellToFile(const BlobLocator& vLocator, const std::string& vFilePathName);  // asynchronous, streamed by chunks
+    bool loadFileIntoCell(const BlobLocator& vLocator, const std::string& vFilePathName);  // asynchronous, streamed by chunks
 
     void doActions();
 
@@ -112,14 +194,49 @@ public:
     void drawQueryResultValue();
     void drawQueryHistory();
     void drawDatabaseStructure();
+    void drawQueryProfiler();
+    void drawQueryPlans();
+    void drawIndexAdvisor();
 
     ez::xml::Nodes getXmlNodes(const std::string& vUserDatas = "") override;
     bool setFromXmlNodes(const ez::xml::Node& vNode, const ez::xml::Node& vParent, const std::string& vUserDatas) override;
 
 private:
     ImU32 m_getSqliteTypeColor(const SqliteType vSqliteType);
-    void m_colorizeTableCell(const ImU32 vColor);
-    bool m_drawQueryResultTable(const QueryResult& vResult, int& ioSelRow, int& ioSelCol, std::string& vOutValue);
+    bool m_drawQueryResultTable(QueryCursor& vCursor, int& ioSelRow, int& ioSelCol);
+    bool m_drawWideResultGrid(QueryCursor& vCursor, const int vRowCount, const bool vNeedResizeToFit, int& ioSelRow, int& ioSelCol);
+    void m_fitWideGridColumns(const std::vector<ColumnInfo>& vColumns);
+    void m_selectResultCell(const ResultGridRow& vRow, const int vCol, int& ioSelRow, int& ioSelCol);
+    void m_openResultCellContextMenu(const ResultGridRow& vRow, const int vCol);
+    void m_drawResultCellContextMenu(const QueryCursor& vCursor);
+    // background and text of a result cell, return the text width if vMeasure
+    float m_drawResultCell(
+        ImDrawList* vpDrawList,
+        CellTextCache::Row& vRow,
+        const int vCol,
+        const ImRect& vCellRect,
+        const ImVec2& vTextPos,
+        const float vTextMaxX,
+        const bool vSelected,
+        const bool vHovered,
+        const bool vMeasure);
+    void m_onQueryCompleted(QueryJob& vJob, const bool vSaveQuery);
+    void m_selectScriptStatement(const size_t vIdx);
+    void m_fetchCursorRows(QueryCursor& vCursor, const size_t vStart, const size_t vEnd);
+    void m_stopCursorFetch();  // before the cursor is closed
+    void m_drawScriptStatementsMenu();
     void m_addQueryToHistory(const std::string& vQuery);
+    void m_buildStructureRows();
+    void m_requestTableFields(const Database& vDatabase, TableDatas& vTableDatas);
+    static bool m_readSchema(const int64_t vKnownVersion, int64_t& vOutVersion, std::vector<TableDatas>& vOutTables, std::string& vOutErrorMsg);  // in a worker
+    bool m_applySchema(const std::string& vDatabaseFilePathName, const int64_t vVersion, std::vector<TableDatas>&& vTables);
+    static bool m_loadTableFields(const std::string& vTableName, std::vector<TableFieldDatas>& vOutFields, std::string& vOutErrorMsg);  // in a worker
     void m_drawTableContextMenu(const TableDatas& vTableDatas);
+    void m_addQueryPlan(QueryPlan&& vQueryPlan);
+    const QueryPlan* m_getQueryPlan(const size_t vNumber) const;
+    void m_drawQueryPlanSelector(const char* vLabel, size_t& ioPlanNumber);
+    void m_drawQueryPlan(const QueryPlan& vQueryPlan);
+    std::vector<std::string> m_getSlowestQueries(const size_t vCount) const;
+    void m_createAdvisedIndex(const std::string& vCreateSql, const std::string& vQuery);  // vQuery is executed again if not empty
+    void m_drawScanStatus(const StatementProfile& vProfile);
 };
@@ -0,0 +1,96 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <backend/helpers/dbHelper.h>
+#include <backend/managers/jobManager.h>
+
+#include <ezlibs/ezClass.hpp>
+#include <ezlibs/ezSingleton.hpp>
+
+#include <functional>
+#include <cstdint>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+// save a cell in a file, or load a file in a cell, in a job of the JobManager.
+// the blob is streamed by chunks with the sqlite3_blob api, so it is never fully in memory
+class BlobTransfer {
+    IMPLEMENT_SINGLETON(BlobTransfer)
+    DISABLE_CONSTRUCTORS(BlobTransfer)
+    DISABLE_DESTRUCTORS(BlobTransfer)
+
+public:
+    enum class Operation {  //
+        SAVE_TO_FILE = 0,
+        LOAD_FROM_FILE
+    };
+    enum class State {  //
+        IDLE = 0,
+        RUNNING,
+        DONE,
+        FAILED,
+        CANCELED
+    };
+    typedef std::function<void(BlobTransfer&)> CompletionFunctor;  // called in the ui thread
+
+private:
+    JobPtr m_job;
+    std::mutex m_runMutex;  // held by the job while it transfers
+    std::atomic<State> m_state{State::IDLE};
+    std::atomic<size_t> m_bytesDone{0U};
+    std::atomic<size_t> m_bytesCount{0U};
+    std::chrono::steady_clock::time_point m_startTime{};
+    double m_elapsedMs{0.0};
+    Operation m_operation{Operation::SAVE_TO_FILE};
+    BlobLocator m_locator;
+    std::string m_filePathName;
+    std::string m_errorMsg;
+    CompletionFunctor m_completionFunctor;
+
+public:
+    bool init();
+    void unit();
+
+    bool start(  //
+        const Operation vOperation,
+        const BlobLocator& vLocator,
+        const std::string& vFilePathName,
+        const CompletionFunctor& vCompletionFunctor);
+    void cancel();
+    void stop();  // cancel and wait the end of the transfer
+    bool isRunning() const { return m_state == State::RUNNING; }
+
+    State getState() const { return m_state; }
+    Operation getOperation() const { return m_operation; }
+    float getProgress() const;  // [0:1]
+    double getElapsedMs() const;  // live value while running
+    size_t getBytesDone() const { return m_bytesDone; }
+    size_t getBytesCount() const { return m_bytesCount; }
+    const BlobLocator& getLocator() const { return m_locator; }
+    const std::string& getFilePathName() const { return m_filePathName; }
+    const std::string& getErrorMsg() const { return m_errorMsg; }  // valid once finished
+
+private:
+    void m_run(Job& vJob);
+    void m_complete();
+};
@@ -0,0 +1,126 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "cellTextCache.h"
+#include <backend/helpers/dbHelper.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <iterator>
+
+const size_t CellTextCache::s_rowsPerBlock = 256U;
+const size_t CellTextCache::s_maxBlocks = 8U;
+const size_t CellTextCache::s_maxTextSize = 256U;
+
+void CellTextCache::setFormat(const Format& vFormat) {
+    if (vFormat != m_format) {
+        m_format = vFormat;
+        clear();
+    }
+}
+
+void CellTextCache::setTypeColor(const SqliteType vType, const uint32_t vColor) {
+    const auto idx = static_cast<size_t>(vType);
+    if (idx < m_typeColors.size() && m_typeColors[idx] != vColor) {
+        m_typeColors[idx] = vColor;
+        clear();
+    }
+}
+
+CellTextCache::Row& CellTextCache::getRow(const size_t vRowIdx, const QueryResult& vBlock, const size_t vBlockRow) {
+    const size_t blockIdx = vRowIdx / s_rowsPerBlock;
+    auto it = m_blocks.find(blockIdx);
+    if (it == m_blocks.end()) {
+        if (m_blocks.size() >= s_maxBlocks) {
+            // the visible rows are around the requested one
+            const auto first = m_blocks.begin();
+            const auto last = std::prev(m_blocks.end());
+            if (blockIdx - std::min(blockIdx, first->first) > last->first - std::min(last->first, blockIdx)) {
+                m_blocks.erase(first);
+            } else {
+                m_blocks.erase(last);
+            }
+        }
+        it = m_blocks.emplace(blockIdx, std::vector<Row>(s_rowsPerBlock)).first;
+    }
+    auto& row = it->second.at(vRowIdx % s_rowsPerBlock);
+    if (row.cells.empty()) {
+        m_buildRow(vBlock, vBlockRow, row);
+    }
+    return row;
+}
+
+void CellTextCache::m_buildRow(const QueryResult& vBlock, const size_t vBlockRow, Row& vOutRow) const {
+    const size_t colCount = vBlock.getColumnsCount();
+    vOutRow.cells.resize(colCount);
+    vOutRow.texts.clear();
+    char buf[512];  // enough for a fixed real of any magnitude
+    for (size_t c = 0; c < colCount; ++c) {
+        auto& cell = vOutRow.cells[c];
+        cell.type = vBlock.getType(vBlockRow, c);
+        cell.color = m_typeColors[static_cast<size_t>(cell.type)];
+        cell.offset = static_cast<uint32_t>(vOutRow.texts.size());
+        std::string_view text;
+        switch (cell.type) {
+            case SqliteType::TYPE_INTEGER: {
+                const auto res = std::to_chars(buf, buf + sizeof(buf), vBlock.getInteger(vBlockRow, c));
+                text = std::string_view(buf, static_cast<size_t>(res.ptr - buf));
+                break;
+            }
+            case SqliteType::TYPE_REAL: {
+                const double value = vBlock.getReal(vBlockRow, c);
+#if defined(__cpp_lib_to_chars)
+                auto res = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, m_format.realPrecision);
+                if (res.ec != std::errc()) {
+                    res = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general, m_format.realPrecision);
+                }
+                text = std::string_view(buf, (res.ec == std::errc()) ? static_cast<size_t>(res.ptr - buf) : 0U);
+#else  // no floating point to_chars in this std lib
+                const int len = snprintf(buf, sizeof(buf), "%.*f", m_format.realPrecision, value);
+                text = std::string_view(buf, static_cast<size_t>(std::clamp(len, 0, static_cast<int>(sizeof(buf)) - 1)));
+#endif
+                break;
+            }
+            case SqliteType::TYPE_TEXT: {
+                text = vBlock.getText(vBlockRow, c);
+                if (text.size() > s_maxTextSize) {
+                    size_t size = s_maxTextSize;
+                    while (size > 0U && (static_cast<uint8_t>(text[size]) & 0xC0) == 0x80) {  // not in a utf8 sequence
+                        --size;
+                    }
+                    text = text.substr(0U, size);
+                }
+                break;
+            }
+            case SqliteType::TYPE_BLOB: {
+                const int len = snprintf(buf, sizeof(buf), "[BLOB] %zu bytes", vBlock.getSize(vBlockRow, c));
+                text = std::string_view(buf, static_cast<size_t>(std::max(len, 0)));
+                break;
+            }
+            case SqliteType::TYPE_NULL:
+            default: {
+                text = "NULL";
+                break;
+            }
+        }
+        vOutRow.texts.append(text.data(), text.size());
+        cell.size = static_cast<uint32_t>(text.size());
+    }
+}
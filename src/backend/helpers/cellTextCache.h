@@ -0,0 +1,74 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <headers/defs.h>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct QueryResult;
+
+// display texts of the result cells, formatted once per row and kept by blocks of rows.
+// must be cleared when the shown result change, the format clear it itself
+class CellTextCache {
+public:
+    struct Format {
+        int32_t realPrecision{6};  // digits after the point
+        bool operator==(const Format& vOther) const { return realPrecision == vOther.realPrecision; }
+        bool operator!=(const Format& vOther) const { return !(*this == vOther); }
+    };
+    struct Cell {
+        uint32_t offset{0U};  // in the texts of the row
+        uint32_t size{0U};
+        uint32_t color{0U};  // background of the type, 0 for none
+        float width{-1.0f};  // measured by the drawing on the first need, -1 until then
+        SqliteType type{SqliteType::TYPE_NULL};
+    };
+    struct Row {
+        std::vector<Cell> cells;  // empty if not built
+        std::string texts;
+        std::string_view getText(const Cell& vCell) const { return std::string_view(texts.data() + vCell.offset, vCell.size); }
+    };
+
+private:
+    static const size_t s_rowsPerBlock;
+    static const size_t s_maxBlocks;  // the farthest block from the requested one is dropped
+    static const size_t s_maxTextSize;  // the full text is shown in the value pane
+    std::map<size_t, std::vector<Row>> m_blocks;  // key is the index of the first row / s_rowsPerBlock
+    std::array<uint32_t, 5U> m_typeColors{};
+    Format m_format;
+
+public:
+    void clear() { m_blocks.clear(); }
+    void setFormat(const Format& vFormat);  // clear the cache if the format change
+    const Format& getFormat() const { return m_format; }
+    void setTypeColor(const SqliteType vType, const uint32_t vColor);
+    // the row vRowIdx of the result, built from the row vBlockRow of vBlock if not already done.
+    // the returned row stay valid while its block is not dropped, so for the rows of a frame
+    Row& getRow(const size_t vRowIdx, const QueryResult& vBlock, const size_t vBlockRow);
+
+private:
+    void m_buildRow(const QueryResult& vBlock, const size_t vBlockRow, Row& vOutRow) const;
+};
@@ -0,0 +1,895 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "csvImporter.h"
+
+#include <backend/helpers/dbHelper.h>
+#include <sqlite3/sqlite3.hpp>
+#include <ezlibs/ezOS.hpp>
+
+#include <condition_variable>
+#include <system_error>
+#include <filesystem>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+
+#ifdef WINDOWS_OS
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CSV_IMPORTER_USE_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace fs = std::filesystem;
+
+const size_t CsvImporter::s_chunkSize = 8U * 1024U * 1024U;
+const size_t CsvImporter::s_sampleRowsCount = 1000U;
+const size_t CsvImporter::s_rowsPerTransaction = 500000U;
+
+//////////////////////////////////////////////////////////////////////////////////
+//// MAPPED FILE /////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////
+
+// read only memory mapping of a whole file
+class MappedFile {
+private:
+    const char* m_datas{nullptr};
+    size_t m_size{0U};
+#ifdef WINDOWS_OS
+    HANDLE m_file{INVALID_HANDLE_VALUE};
+    HANDLE m_mapping{nullptr};
+#else
+    int m_fd{-1};
+#endif
+
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& vFilePathName) {
+        close();
+#ifdef WINDOWS_OS
+        m_file = CreateFileW(  //
+            fs::u8path(vFilePathName).c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(m_file, &fileSize)) {
+            close();
+            return false;
+        }
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+        if (m_size == 0U) {
+            return true;  // an empty file cant be mapped
+        }
+        m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping != nullptr) {
+            m_datas = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+#else
+        m_fd = ::open(vFilePathName.c_str(), O_RDONLY);
+        if (m_fd < 0) {
+            return false;
+        }
+        struct stat fileStat {};
+        if (fstat(m_fd, &fileStat) != 0) {
+            close();
+            return false;
+        }
+        m_size = static_cast<size_t>(fileStat.st_size);
+        if (m_size == 0U) {
+            return true;  // an empty file cant be mapped
+        }
+        void* ptr = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+        if (ptr != MAP_FAILED) {
+            (void)madvise(ptr, m_size, MADV_SEQUENTIAL);
+            m_datas = static_cast<const char*>(ptr);
+        }
+#endif
+        if (m_datas == nullptr) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#ifdef WINDOWS_OS
+        if (m_datas != nullptr) {
+            UnmapViewOfFile(m_datas);
+        }
+        if (m_mapping != nullptr) {
+            CloseHandle(m_mapping);
+            m_mapping = nullptr;
+        }
+        if (m_file != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_file);
+            m_file = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (m_datas != nullptr) {
+            munmap(const_cast<char*>(m_datas), m_size);
+        }
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+#endif
+        m_datas = nullptr;
+        m_size = 0U;
+    }
+
+    const char* getDatas() const { return m_datas; }
+    size_t getSize() const { return m_size; }
+};
+
+//////////////////////////////////////////////////////////////////////////////////
+//// PARSING /////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////
+
+struct CsvField {
+    const char* ptr{nullptr};
+    uint32_t size{0U};
+    bool quoted{false};
+};
+
+struct CsvChunk {
+    std::vector<CsvField> fields;
+    std::vector<uint32_t> rowsFieldsCount;    // fields count of each row
+    std::deque<std::string> unescapedFields;  // quoted fields with "" escapes. a deque keep the pointers valid
+    bool ready{false};
+};
+
+#ifdef CSV_IMPORTER_USE_SSE2
+static inline uint32_t s_countTrailingZeros(const uint32_t vMask) {
+#ifdef _MSC_VER
+    unsigned long idx = 0;
+    _BitScanForward(&idx, vMask);
+    return static_cast<uint32_t>(idx);
+#else
+    return static_cast<uint32_t>(__builtin_ctz(vMask));
+#endif
+}
+#endif
+
+// return the first delimiter, quote, \r or \n of [vpStart, vpEnd), or vpEnd
+static const char* s_findSpecialChar(const char* vpStart, const char* vpEnd, const char vDelimiter) {
+    const char* pCurrent = vpStart;
+#ifdef CSV_IMPORTER_USE_SSE2
+    const __m128i delimiters = _mm_set1_epi8(vDelimiter);
+    const __m128i quotes = _mm_set1_epi8('"');
+    const __m128i crs = _mm_set1_epi8('\r');
+    const __m128i lfs = _mm_set1_epi8('\n');
+    while (pCurrent + 16 <= vpEnd) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pCurrent));
+        const __m128i found = _mm_or_si128(  //
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, delimiters), _mm_cmpeq_epi8(bytes, quotes)),
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, crs), _mm_cmpeq_epi8(bytes, lfs)));
+        const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(found));
+        if (mask != 0U) {
+            return pCurrent + s_countTrailingZeros(mask);
+        }
+        pCurrent += 16;
+    }
+#endif
+    while (pCurrent < vpEnd) {
+        const char c = *pCurrent;
+        if (c == vDelimiter || c == '"' || c == '\r' || c == '\n') {
+            return pCurrent;
+        }
+        ++pCurrent;
+    }
+    return vpEnd;
+}
+
+// the most frequent of , ; tab | in the first line, outside of the quoted fields
+static char s_detectDelimiter(const char* vpStart, const char* vpEnd) {
+    static const char s_candidates[] = {',', ';', '\t', '|'};
+    size_t counts[sizeof(s_candidates)] = {};
+    bool inQuotes = false;
+    for (const char* pCurrent = vpStart; pCurrent < vpEnd; ++pCurrent) {
+        const char c = *pCurrent;
+        if (c == '"') {
+            inQuotes = !inQuotes;
+        } else if (!inQuotes) {
+            if (c == '\n' || c == '\r') {
+                break;
+            }
+            for (size_t i = 0; i < sizeof(s_candidates); ++i) {
+                if (c == s_candidates[i]) {
+                    ++counts[i];
+                }
+            }
+        }
+    }
+    const auto it = std::max_element(std::begin(counts), std::end(counts));
+    return (*it > 0U) ? s_candidates[it - std::begin(counts)] : ',';
+}
+
+// parse the records of [vpStart, vpEnd) in vOutChunk. stop after vMaxRows records if not 0.
+// return the end of the last parsed record
+static const char* s_parseRecords(const char* vpStart, const char* vpEnd, const char vDelimiter, const size_t vMaxRows, CsvChunk& vOutChunk) {
+    const char* pCurrent = vpStart;
+    size_t rowsCount = 0U;
+    while (pCurrent < vpEnd && (vMaxRows == 0U || rowsCount < vMaxRows)) {
+        if (*pCurrent == '\n' || *pCurrent == '\r') {
+            ++pCurrent;  // empty line
+            continue;
+        }
+        uint32_t fieldsCount = 0U;
+        bool endOfRecord = false;
+        while (!endOfRecord) {
+            CsvField field;
+            if (pCurrent < vpEnd && *pCurrent == '"') {
+                field.quoted = true;
+                const char* pFieldStart = ++pCurrent;
+                bool escaped = false;
+                while (true) {
+                    const auto* pQuote = static_cast<const char*>(std::memchr(pCurrent, '"', static_cast<size_t>(vpEnd - pCurrent)));
+                    if (pQuote == nullptr) {
+                        pCurrent = vpEnd;  // not closed, we take all until the end
+                        break;
+                    }
+                    if (pQuote + 1 < vpEnd && pQuote[1] == '"') {
+                        escaped = true;
+                        pCurrent = pQuote + 2;
+                    } else {
+                        pCurrent = pQuote;
+                        break;
+                    }
+                }
+                const char* pFieldEnd = pCurrent;
+                if (escaped) {
+                    std::string str;
+                    str.reserve(static_cast<size_t>(pFieldEnd - pFieldStart));
+                    for (const char* p = pFieldStart; p < pFieldEnd; ++p) {
+                        str.push_back(*p);
+                        if (*p == '"') {
+                            ++p;  // "" => "
+                        }
+                    }
+                    vOutChunk.unescapedFields.push_back(std::move(str));
+                    field.ptr = vOutChunk.unescapedFields.back().data();
+                    field.size = static_cast<uint32_t>(vOutChunk.unescapedFields.back().size());
+                } else {
+                    field.ptr = pFieldStart;
+                    field.size = static_cast<uint32_t>(pFieldEnd - pFieldStart);
+                }
+                // the chars between the closing quote and the delimiter are ignored
+                while (pCurrent < vpEnd && *pCurrent != vDelimiter && *pCurrent != '\r' && *pCurrent != '\n') {
+                    ++pCurrent;
+                }
+            } else {
+                const char* pFieldStart = pCurrent;
+                pCurrent = s_findSpecialChar(pCurrent, vpEnd, vDelimiter);
+                while (pCurrent < vpEnd && *pCurrent == '"') {
+                    // a quote in a not quoted field is a normal char
+                    pCurrent = s_findSpecialChar(pCurrent + 1, vpEnd, vDelimiter);
+                }
+                field.ptr = pFieldStart;
+                field.size = static_cast<uint32_t>(pCurrent - pFieldStart);
+            }
+            vOutChunk.fields.push_back(field);
+            ++fieldsCount;
+            if (pCurrent < vpEnd && *pCurrent == vDelimiter) {
+                ++pCurrent;
+            } else {
+                endOfRecord = true;
+                if (pCurrent < vpEnd && *pCurrent == '\r') {
+                    ++pCurrent;
+                }
+                if (pCurrent < vpEnd && *pCurrent == '\n') {
+                    ++pCurrent;
+                }
+            }
+        }
+        vOutChunk.rowsFieldsCount.push_back(fieldsCount);
+        ++rowsCount;
+    }
+    return pCurrent;
+}
+
+// position of a scan in the quoted fields
+enum class CsvQuoteState {  //
+    OUT = 0,
+    IN,
+    CLOSED,  // just after a closing quote, a quote here is a "" escape
+    Count
+};
+
+// the quote rule of s_parseRecords : a quote opens a quoted field only at the start of a field, a "" is an escaped
+// quote in it, and a quote elsewhere is a normal char. scan [vpStart, vpEnd) from ioState.
+// vStopAtRecordEnd : stop after the first \n outside of the quoted fields. return the end of the scan
+static const char* s_scanQuotes(  //
+    const char* vpStart,
+    const char* vpEnd,
+    const char* vpDatasStart,
+    const char vDelimiter,
+    const bool vStopAtRecordEnd,
+    CsvQuoteState& ioState) {
+    const char* pCurrent = vpStart;
+    while (pCurrent < vpEnd) {
+        if (ioState == CsvQuoteState::IN) {
+            const auto* pQuote = static_cast<const char*>(std::memchr(pCurrent, '"', static_cast<size_t>(vpEnd - pCurrent)));
+            if (pQuote == nullptr) {
+                return vpEnd;
+            }
+            pCurrent = pQuote + 1;
+            ioState = CsvQuoteState::CLOSED;
+            continue;
+        }
+        if (ioState == CsvQuoteState::CLOSED) {
+            ioState = CsvQuoteState::OUT;
+            if (*pCurrent == '"') {
+                ++pCurrent;
+                ioState = CsvQuoteState::IN;
+                continue;
+            }
+        }
+        const char* pFound = nullptr;
+        if (vStopAtRecordEnd) {
+            pFound = pCurrent;
+            while (pFound < vpEnd && *pFound != '"' && *pFound != '\n') {
+                ++pFound;
+            }
+            if (pFound == vpEnd) {
+                return vpEnd;
+            }
+            if (*pFound == '\n') {
+                return pFound + 1;
+            }
+        } else {
+            pFound = static_cast<const char*>(std::memchr(pCurrent, '"', static_cast<size_t>(vpEnd - pCurrent)));
+            if (pFound == nullptr) {
+                return vpEnd;
+            }
+        }
+        const char previous = (pFound == vpDatasStart) ? '\n' : pFound[-1];
+        if (previous == vDelimiter || previous == '\n' || previous == '\r') {
+            ioState = CsvQuoteState::IN;
+        }
+        pCurrent = pFound + 1;
+    }
+    return vpEnd;
+}
+
+// the chunks are cut after a \n who is not in a quoted field, with the quote rule of s_parseRecords.
+// the nominal chunks are scanned in parallel from each possible state, then the state at each
+// nominal start is known in order, and each cut is searched from its nominal start
+static std::vector<const char*> s_computeChunksBoundaries(  //
+    const char* vpStart,
+    const char* vpEnd,
+    const char vDelimiter,
+    const size_t vChunkSize,
+    const size_t vThreadsCount) {
+    static const size_t s_statesCount = static_cast<size_t>(CsvQuoteState::Count);
+    const size_t size = static_cast<size_t>(vpEnd - vpStart);
+    const size_t chunksCount = std::max<size_t>(1U, (size + vChunkSize - 1U) / vChunkSize);
+    std::vector<CsvQuoteState> endStates(chunksCount * s_statesCount, CsvQuoteState::OUT);  // by chunk and by start state
+    {
+        std::atomic<size_t> nextChunk{0U};
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < std::min(vThreadsCount, chunksCount); ++t) {
+            threads.emplace_back([&]() {
+                size_t idx = 0U;
+                while ((idx = nextChunk++) < chunksCount) {
+                    const char* pChunkStart = vpStart + idx * vChunkSize;
+                    const char* pChunkEnd = std::min(pChunkStart + vChunkSize, vpEnd);
+                    for (size_t state = 0U; state < s_statesCount; ++state) {
+                        auto& endState = endStates[idx * s_statesCount + state];
+                        endState = static_cast<CsvQuoteState>(state);
+                        (void)s_scanQuotes(pChunkStart, pChunkEnd, vpStart, vDelimiter, false, endState);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    std::vector<const char*> boundaries;
+    boundaries.push_back(vpStart);
+    auto state = CsvQuoteState::OUT;
+    for (size_t idx = 1U; idx < chunksCount; ++idx) {
+        state = endStates[(idx - 1U) * s_statesCount + static_cast<size_t>(state)];
+        auto cutState = state;
+        const char* pCurrent = s_scanQuotes(vpStart + idx * vChunkSize, vpEnd, vpStart, vDelimiter, true, cutState);
+        // a record can be bigger than a chunk, so two searches can find the same cut
+        if (pCurrent > boundaries.back() && pCurrent < vpEnd) {
+            boundaries.push_back(pCurrent);
+        }
+    }
+    boundaries.push_back(vpEnd);
+    return boundaries;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//// TYPES ///////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////
+
+static bool s_parseInteger(const CsvField& vField, int64_t& vOutValue) {
+    const char* pEnd = vField.ptr + vField.size;
+    const char* pStart = (vField.size > 1U && vField.ptr[0] == '+') ? vField.ptr + 1 : vField.ptr;
+    const auto res = std::from_chars(pStart, pEnd, vOutValue);
+    return res.ec == std::errc() && res.ptr == pEnd;
+}
+
+// [+-]digits[.digits][(e|E)[+-]digits], checked by hand for not depend of the locale
+static bool s_isReal(const CsvField& vField) {
+    const char* pCurrent = vField.ptr;
+    const char* pEnd = vField.ptr + vField.size;
+    const auto skipDigits = [&pCurrent, pEnd]() {
+        const char* pStart = pCurrent;
+        while (pCurrent < pEnd && *pCurrent >= '0' && *pCurrent <= '9') {
+            ++pCurrent;
+        }
+        return static_cast<size_t>(pCurrent - pStart);
+    };
+    if (pCurrent < pEnd && (*pCurrent == '+' || *pCurrent == '-')) {
+        ++pCurrent;
+    }
+    size_t digitsCount = skipDigits();
+    if (pCurrent < pEnd && *pCurrent == '.') {
+        ++pCurrent;
+        digitsCount += skipDigits();
+    }
+    if (digitsCount == 0U) {
+        return false;
+    }
+    if (pCurrent < pEnd && (*pCurrent == 'e' || *pCurrent == 'E')) {
+        ++pCurrent;
+        if (pCurrent < pEnd && (*pCurrent == '+' || *pCurrent == '-')) {
+            ++pCurrent;
+        }
+        if (skipDigits() == 0U) {
+            return false;
+        }
+    }
+    return pCurrent == pEnd;
+}
+
+// 0 followed by a digit, after the sign. like a zip code or a phone number, the zeros must be kept
+static bool s_hasLeadingZero(const CsvField& vField) {
+    const char* pCurrent = vField.ptr;
+    const char* pEnd = vField.ptr + vField.size;
+    if (pCurrent < pEnd && (*pCurrent == '+' || *pCurrent == '-')) {
+        ++pCurrent;
+    }
+    return (pEnd - pCurrent >= 2) && pCurrent[0] == '0' && pCurrent[1] >= '0' && pCurrent[1] <= '9';
+}
+
+// a column is INTEGER or REAL if all the not empty values of the sample are, and have no leading zero, else TEXT
+static std::vector<SqliteType> s_inferColumnsTypes(const CsvChunk& vSample, const size_t vColumnsCount) {
+    std::vector<SqliteType> types(vColumnsCount, SqliteType::TYPE_INTEGER);
+    std::vector<bool> hasValues(vColumnsCount, false);
+    size_t fieldIdx = 0U;
+    for (const auto fieldsCount : vSample.rowsFieldsCount) {
+        for (size_t c = 0; c < fieldsCount; ++c) {
+            const auto& field = vSample.fields[fieldIdx + c];
+            if (c >= vColumnsCount || field.size == 0U) {
+                continue;
+            }
+            hasValues[c] = true;
+            if (s_hasLeadingZero(field)) {
+                types[c] = SqliteType::TYPE_TEXT;
+                continue;
+            }
+            int64_t value = 0;
+            if (types[c] == SqliteType::TYPE_INTEGER && !s_parseInteger(field, value)) {
+                types[c] = SqliteType::TYPE_REAL;
+            }
+            if (types[c] == SqliteType::TYPE_REAL && !s_isReal(field)) {
+                types[c] = SqliteType::TYPE_TEXT;
+            }
+        }
+        fieldIdx += fieldsCount;
+    }
+    for (size_t c = 0; c < vColumnsCount; ++c) {
+        if (!hasValues[c]) {
+            types[c] = SqliteType::TYPE_TEXT;
+        }
+    }
+    return types;
+}
+
+static std::string s_quoteIdentifier(const std::string& vName) {
+    std::string ret = "\"";
+    for (const auto c : vName) {
+        ret += c;
+        if (c == '"') {
+            ret += '"';
+        }
+    }
+    ret += '"';
+    return ret;
+}
+
+static std::string s_getTypeName(const SqliteType vType) {
+    switch (vType) {
+        case SqliteType::TYPE_INTEGER: return "INTEGER";
+        case SqliteType::TYPE_REAL: return "REAL";
+        default: break;
+    }
+    return "TEXT";
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//// PUBLIC //////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////
+
+bool CsvImporter::init() {
+    return true;
+}
+
+void CsvImporter::unit() {
+    stop();
+    m_job.reset();
+}
+
+bool CsvImporter::start(const std::string& vFilePathName, const std::string& vTableName, const CompletionFunctor& vCompletionFunctor) {
+    if (m_job != nullptr) {  // running, or its completion is not called yet
+        return false;
+    }
+    m_filePathName = vFilePathName;
+    m_tableName = vTableName.empty() ? fs::u8path(vFilePathName).stem().u8string() : vTableName;
+    m_errorMsg.clear();
+    m_malformedRowsCount = 0U;
+    m_bytesCount = 0U;
+    m_bytesDone = 0U;
+    m_rowsCount = 0U;
+    m_elapsedMs = 0.0;
+    m_completionFunctor = vCompletionFunctor;
+    m_startTime = std::chrono::steady_clock::now();
+    m_state = State::RUNNING;
+    m_job = JobManager::ref().pushJob(  //
+        Job::Priority::INTERACTIVE,
+        [this](Job& vJob) { m_run(vJob); },
+        [this](Job& /*vJob*/) { m_complete(); });
+    return true;
+}
+
+void CsvImporter::cancel() {
+    if (m_job != nullptr) {
+        m_job->cancel();
+    }
+}
+
+void CsvImporter::stop() {
+    cancel();
+    // a pending job will not run once canceled, a running one releases the lock at its end
+    std::lock_guard<std::mutex> lock(m_runMutex);
+}
+
+float CsvImporter::getProgress() const {
+    const size_t bytesCount = m_bytesCount;
+    if (bytesCount == 0U) {
+        return 0.0f;
+    }
+    return static_cast<float>(static_cast<double>(m_bytesDone) / static_cast<double>(bytesCount));
+}
+
+double CsvImporter::getElapsedMs() const {
+    if (m_state == State::RUNNING) {
+        const auto elapsed = std::chrono::steady_clock::now() - m_startTime;
+        return std::chrono::duration<double, std::milli>(elapsed).count();
+    }
+    return m_elapsedMs;
+}
+
+double CsvImporter::getRowsPerSecond() const {
+    const auto elapsedMs = getElapsedMs();
+    return (elapsedMs > 0.0) ? static_cast<double>(m_rowsCount) * 1000.0 / elapsedMs : 0.0;
+}
+
+double CsvImporter::getMegaBytesPerSecond() const {
+    const auto elapsedMs = getElapsedMs();
+    return (elapsedMs > 0.0) ? static_cast<double>(m_bytesDone) / (1024.0 * 1024.0) * 1000.0 / elapsedMs : 0.0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//// PRIVATE /////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////
+
+void CsvImporter::m_run(Job& vJob) {
+    std::lock_guard<std::mutex> lock(m_runMutex);
+    if (vJob.isCancelRequested()) {  // canceled by stop() while it was pending
+        return;
+    }
+    const bool ok = m_import(vJob);
+    const auto elapsed = std::chrono::steady_clock::now() - m_startTime;
+    m_elapsedMs = std::chrono::duration<double, std::milli>(elapsed).count();
+    if (vJob.isCancelRequested()) {
+        m_errorMsg = "Import canceled";
+        m_state = State::CANCELED;
+    } else {
+        m_state = ok ? State::DONE : State::FAILED;
+    }
+}
+
+void CsvImporter::m_complete() {
+    m_job.reset();
+    if (m_state == State::RUNNING) {  // canceled before it runs
+        m_errorMsg = "Import canceled";
+        m_elapsedMs = 0.0;
+        m_state = State::CANCELED;
+    }
+    if (m_completionFunctor) {
+        m_completionFunctor(*this);
+    }
+}
+
+bool CsvImporter::m_import(Job& vJob) {
+    MappedFile file;
+    if (!file.open(m_filePathName)) {
+        m_errorMsg = "Failed to open the file " + m_filePathName;
+        return false;
+    }
+    m_bytesCount = file.getSize();
+    const char* pBegin = file.getDatas();
+    const char* pEnd = pBegin + file.getSize();
+    if (file.getSize() >= 3U && std::memcmp(pBegin, "\xEF\xBB\xBF", 3U) == 0) {
+        pBegin += 3;  // utf8 bom
+    }
+
+    // header
+    const char delimiter = s_detectDelimiter(pBegin, pEnd);
+    CsvChunk header;
+    const char* pDatas = s_parseRecords(pBegin, pEnd, delimiter, 1U, header);
+    if (header.fields.empty()) {
+        m_errorMsg = "The file is empty";
+        return false;
+    }
+    std::vector<std::string> columnsNames;
+    for (const auto& field : header.fields) {
+        std::string name(field.ptr, field.size);
+        name.erase(0, name.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t") + 1U);
+        if (name.empty()) {
+            name = "column_" + std::to_string(columnsNames.size() + 1U);
+        }
+        const std::string baseName = name;
+        for (size_t idx = 2U; std::find(columnsNames.begin(), columnsNames.end(), name) != columnsNames.end(); ++idx) {
+            name = baseName + "_" + std::to_string(idx);
+        }
+        columnsNames.push_back(name);
+    }
+    const size_t columnsCount = columnsNames.size();
+
+    // columns types
+    CsvChunk sample;
+    (void)s_parseRecords(pDatas, pEnd, delimiter, s_sampleRowsCount, sample);
+    const auto columnsTypes = s_inferColumnsTypes(sample, columnsCount);
+    sample = CsvChunk();
+
+    const auto hardwareThreadsCount = static_cast<size_t>(std::thread::hardware_concurrency());
+    const size_t parsersCount = (hardwareThreadsCount > 2U) ? hardwareThreadsCount - 1U : 1U;  // one thread for the writer
+    const auto boundaries = s_computeChunksBoundaries(pDatas, pEnd, delimiter, s_chunkSize, parsersCount);
+    const size_t chunksCount = boundaries.size() - 1U;
+
+    // table and insert statement
+    auto& db = DBHelper::ref();
+    std::unique_lock<std::recursive_mutex> dbLock(db.getMutexRef());
+    if (!db.openDBFile()) {
+        m_errorMsg = db.getLastErrorMsg();
+        return false;
+    }
+    {
+        // a suffix is added if the table exist
+        sqlite3_stmt* stmt = db.prepareStatement("SELECT 1 FROM sqlite_schema WHERE lower(name) = lower(?1);");
+        if (stmt == nullptr) {
+            m_errorMsg = db.getLastErrorMsg();
+            return false;
+        }
+        const std::string baseName = m_tableName;
+        for (size_t idx = 2U;; ++idx) {
+            sqlite3_bind_text(stmt, 1, m_tableName.c_str(), static_cast<int>(m_tableName.size()), SQLITE_TRANSIENT);
+            const bool exist = (sqlite3_step(stmt) == SQLITE_ROW);
+            sqlite3_reset(stmt);
+            if (!exist) {
+                break;
+            }
+            m_tableName = baseName + "_" + std::to_string(idx);
+        }
+        sqlite3_finalize(stmt);
+    }
+    std::string createSql = "CREATE TABLE " + s_quoteIdentifier(m_tableName) + " (";
+    std::string insertSql = "INSERT INTO " + s_quoteIdentifier(m_tableName) + " VALUES (";
+    for (size_t c = 0; c < columnsCount; ++c) {
+        createSql += ((c > 0U) ? ", " : "") + s_quoteIdentifier(columnsNames[c]) + " " + s_getTypeName(columnsTypes[c]);
+        insertSql += (c > 0U) ? ", ?" : "?";
+    }
+    createSql += ");";
+    insertSql += ");";
+    (void)db.executeQuery(createSql);
+    if (!db.getLastErrorMsg().empty()) {
+        m_errorMsg = db.getLastErrorMsg();
+        return false;
+    }
+    sqlite3_stmt* insertStmt = db.prepareStatement(insertSql);
+    if (insertStmt == nullptr) {
+        m_errorMsg = db.getLastErrorMsg();
+        (void)db.executeQuery("DROP TABLE " + s_quoteIdentifier(m_tableName) + ";");
+        return false;
+    }
+    sqlite3* dbPtr = sqlite3_db_handle(insertStmt);
+    dbLock.unlock();
+
+    // parsers
+    const size_t maxChunksInFlight = parsersCount * 2U;
+    std::vector<CsvChunk> chunks(chunksCount);
+    std::mutex chunksMutex;
+    std::condition_variable chunksCv;
+    size_t nextChunkToParse = 0U;
+    size_t writtenChunksCount = 0U;
+    bool stopParsers = false;
+    std::vector<std::thread> parsers;
+    for (size_t t = 0; t < std::min(parsersCount, chunksCount); ++t) {
+        parsers.emplace_back([&]() {
+            while (true) {
+                size_t idx = 0U;
+                {
+                    std::unique_lock<std::mutex> lock(chunksMutex);
+                    chunksCv.wait(lock, [&]() {  //
+                        return stopParsers || nextChunkToParse >= chunksCount || nextChunkToParse < writtenChunksCount + maxChunksInFlight;
+                    });
+                    if (stopParsers || nextChunkToParse >= chunksCount) {
+                        return;
+                    }
+                    idx = nextChunkToParse++;
+                }
+                CsvChunk chunk;
+                (void)s_parseRecords(boundaries[idx], boundaries[idx + 1U], delimiter, 0U, chunk);
+                chunk.ready = true;
+                {
+                    std::lock_guard<std::mutex> lock(chunksMutex);
+                    chunks[idx] = std::move(chunk);
+                }
+                chunksCv.notify_all();
+            }
+        });
+    }
+
+    // writer
+    bool ok = true;
+    size_t rowsInTransaction = 0U;
+    for (size_t idx = 0U; idx < chunksCount && ok && !vJob.isCancelRequested(); ++idx) {
+        {
+            std::unique_lock<std::mutex> lock(chunksMutex);
+            chunksCv.wait(lock, [&]() { return chunks[idx].ready; });
+        }
+        const auto& chunk = chunks[idx];
+        if (!dbLock.owns_lock()) {
+            dbLock.lock();
+            if (!db.beginDBTransaction()) {
+                m_errorMsg = db.getLastErrorMsg();
+                ok = false;
+                break;
+            }
+        }
+        size_t fieldIdx = 0U;
+        for (const auto fieldsCount : chunk.rowsFieldsCount) {
+            for (size_t c = 0; c < columnsCount; ++c) {
+                const int bindIdx = static_cast<int>(c) + 1;
+                if (c >= fieldsCount) {
+                    sqlite3_bind_null(insertStmt, bindIdx);
+                    continue;
+                }
+                const auto& field = chunk.fields[fieldIdx + c];
+                int64_t value = 0;
+                if (field.size == 0U && !field.quoted) {
+                    sqlite3_bind_null(insertStmt, bindIdx);
+                } else if (columnsTypes[c] == SqliteType::TYPE_INTEGER && s_parseInteger(field, value)) {
+                    sqlite3_bind_int64(insertStmt, bindIdx, value);
+                } else {
+                    // the REAL columns convert the text by affinity. the mapping live until the step
+                    sqlite3_bind_text(insertStmt, bindIdx, field.ptr, static_cast<int>(field.size), SQLITE_STATIC);
+                }
+            }
+            if (fieldsCount != columnsCount) {
+                ++m_malformedRowsCount;
+            }
+            fieldIdx += fieldsCount;
+            if (sqlite3_step(insertStmt) != SQLITE_DONE) {
+                m_errorMsg = sqlite3_errmsg(dbPtr);
+                ok = false;
+                break;
+            }
+            sqlite3_reset(insertStmt);
+        }
+        if (!ok) {
+            break;
+        }
+        m_rowsCount += chunk.rowsFieldsCount.size();
+        rowsInTransaction += chunk.rowsFieldsCount.size();
+        if (rowsInTransaction >= s_rowsPerTransaction) {
+            // commit and release the db for the others threads
+            db.commitDBTransaction();
+            if (sqlite3_get_autocommit(dbPtr) == 0) {
+                m_errorMsg = db.getLastErrorMsg();
+                ok = false;
+            }
+            rowsInTransaction = 0U;
+            dbLock.unlock();
+        }
+        m_bytesDone = static_cast<size_t>(boundaries[idx + 1U] - file.getDatas());
+        {
+            std::lock_guard<std::mutex> lock(chunksMutex);
+            chunks[idx] = CsvChunk();
+            ++writtenChunksCount;
+        }
+        chunksCv.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(chunksMutex);
+        stopParsers = true;
+    }
+    chunksCv.notify_all();
+    for (auto& parser : parsers) {
+        parser.join();
+    }
+
+    if (!dbLock.owns_lock()) {
+        dbLock.lock();
+    }
+    sqlite3_reset(insertStmt);
+    sqlite3_finalize(insertStmt);
+    if (ok && !vJob.isCancelRequested()) {
+        if (sqlite3_get_autocommit(dbPtr) == 0) {
+            db.commitDBTransaction();
+            if (sqlite3_get_autocommit(dbPtr) == 0) {
+                m_errorMsg = db.getLastErrorMsg();
+                ok = false;
+            }
+        }
+    }
+    if (!ok || vJob.isCancelRequested()) {
+        if (sqlite3_get_autocommit(dbPtr) == 0) {
+            db.rollbackDBTransaction();
+        }
+        // the table is created by the import, so we can remove the rows of the previous transactions with it
+        (void)db.executeQuery("DROP TABLE " + s_quoteIdentifier(m_tableName) + ";");
+        return false;
+    }
+    m_bytesDone = m_bytesCount.load();
+    return true;
+}
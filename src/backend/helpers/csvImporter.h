@@ -0,0 +1,100 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <backend/managers/jobManager.h>
+
+#include <ezlibs/ezClass.hpp>
+#include <ezlibs/ezSingleton.hpp>
+
+#include <functional>
+#include <cstdint>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+// import a csv file in a new table.
+// the file is memory mapped and cut in chunks at records boundaries. the chunks are parsed in parallel,
+// and a single writer bind the fields in one reused INSERT statement inside large transactions.
+// the import is a job of the JobManager
+class CsvImporter {
+    IMPLEMENT_SINGLETON(CsvImporter)
+    DISABLE_CONSTRUCTORS(CsvImporter)
+    DISABLE_DESTRUCTORS(CsvImporter)
+
+public:
+    enum class State {  //
+        IDLE = 0,
+        RUNNING,
+        DONE,
+        FAILED,
+        CANCELED
+    };
+    typedef std::function<void(CsvImporter&)> CompletionFunctor;  // called in the ui thread
+
+private:  // (static)
+    static const size_t s_chunkSize;
+    static const size_t s_sampleRowsCount;      // rows used for infer the columns types
+    static const size_t s_rowsPerTransaction;  // the db is released between two transactions
+
+private:
+    JobPtr m_job;
+    std::mutex m_runMutex;  // held by the job while it imports
+    std::atomic<State> m_state{State::IDLE};
+    std::atomic<size_t> m_bytesCount{0U};
+    std::atomic<size_t> m_bytesDone{0U};
+    std::atomic<size_t> m_rowsCount{0U};
+    std::chrono::steady_clock::time_point m_startTime{};
+    double m_elapsedMs{0.0};
+    std::string m_filePathName;
+    std::string m_tableName;  // can be suffixed by the import if the table exist
+    std::string m_errorMsg;
+    size_t m_malformedRowsCount{0U};  // rows with a wrong fields count
+    CompletionFunctor m_completionFunctor;
+
+public:
+    bool init();
+    void unit();
+
+    // vTableName : if empty, the file name is used
+    bool start(const std::string& vFilePathName, const std::string& vTableName, const CompletionFunctor& vCompletionFunctor);
+    void cancel();
+    void stop();  // cancel and wait the end of the import
+    bool isRunning() const { return m_state == State::RUNNING; }
+
+    State getState() const { return m_state; }
+    float getProgress() const;  // [0:1]
+    size_t getRowsCount() const { return m_rowsCount; }
+    double getElapsedMs() const;  // live value while running
+    double getRowsPerSecond() const;
+    double getMegaBytesPerSecond() const;
+    const std::string& getFilePathName() const { return m_filePathName; }
+
+    // valid once finished
+    const std::string& getTableName() const { return m_tableName; }
+    const std::string& getErrorMsg() const { return m_errorMsg; }
+    size_t getMalformedRowsCount() const { return m_malformedRowsCount; }
+
+private:
+    void m_run(Job& vJob);
+    void m_complete();
+    bool m_import(Job& vJob);
+};
@@ -0,0 +1,121 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dbBackup.h"
+
+#include <backend/helpers/dbHelper.h>
+
+#include <algorithm>
+
+bool DBBackup::init() {
+    return true;
+}
+
+void DBBackup::unit() {
+    stop();
+    m_job.reset();
+}
+
+bool DBBackup::start(const Operation vOperation, const std::string& vFilePathName, const CompletionFunctor& vCompletionFunctor) {
+    if (m_job != nullptr || vFilePathName.empty()) {  // running, or its completion is not called yet
+        return false;
+    }
+    m_operation = vOperation;
+    m_filePathName = vFilePathName;
+    m_errorMsg.clear();
+    m_remainingPages = 0;
+    m_pagesCount = 0;
+    m_elapsedMs = 0.0;
+    m_completionFunctor = vCompletionFunctor;
+    m_startTime = std::chrono::steady_clock::now();
+    m_state = State::RUNNING;
+    m_job = JobManager::ref().pushJob(  //
+        Job::Priority::INTERACTIVE,
+        [this](Job& vJob) { m_run(vJob); },
+        [this](Job& /*vJob*/) { m_complete(); });
+    return true;
+}
+
+void DBBackup::cancel() {
+    if (m_job != nullptr) {
+        m_job->cancel();
+    }
+}
+
+void DBBackup::stop() {
+    cancel();
+    // a pending job will not run once canceled, a running one releases the lock at its end
+    std::lock_guard<std::mutex> lock(m_runMutex);
+}
+
+float DBBackup::getProgress() const {
+    const int32_t pagesCount = m_pagesCount;
+    if (pagesCount <= 0) {
+        return 0.0f;
+    }
+    return std::clamp(1.0f - static_cast<float>(m_remainingPages) / static_cast<float>(pagesCount), 0.0f, 1.0f);
+}
+
+double DBBackup::getElapsedMs() const {
+    if (m_state == State::RUNNING) {
+        const auto elapsed = std::chrono::steady_clock::now() - m_startTime;
+        return std::chrono::duration<double, std::milli>(elapsed).count();
+    }
+    return m_elapsedMs;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//// PRIVATE /////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////
+
+void DBBackup::m_run(Job& vJob) {
+    std::lock_guard<std::mutex> lock(m_runMutex);
+    if (vJob.isCancelRequested()) {  // canceled by stop() while it was pending
+        return;
+    }
+    const bool ok = DBHelper::ref().backupWithFile(  //
+        m_filePathName,
+        m_operation == Operation::SAVE_TO_FILE,
+        [this, &vJob](const int32_t vRemainingPages, const int32_t vPagesCount) {
+            m_remainingPages = vRemainingPages;
+            m_pagesCount = vPagesCount;
+            return !vJob.isCancelRequested();
+        },
+        &m_errorMsg);
+    const auto elapsed = std::chrono::steady_clock::now() - m_startTime;
+    m_elapsedMs = std::chrono::duration<double, std::milli>(elapsed).count();
+    if (vJob.isCancelRequested()) {
+        m_errorMsg = (m_operation == Operation::SAVE_TO_FILE) ? "Save canceled" : "Load canceled";
+        m_state = State::CANCELED;
+    } else {
+        m_state = ok ? State::DONE : State::FAILED;
+    }
+}
+
+void DBBackup::m_complete() {
+    m_job.reset();
+    if (m_state == State::RUNNING) {  // canceled before it runs
+        m_errorMsg = (m_operation == Operation::SAVE_TO_FILE) ? "Save canceled" : "Load canceled";
+        m_elapsedMs = 0.0;
+        m_state = State::CANCELED;
+    }
+    if (m_completionFunctor) {
+        m_completionFunctor(*this);
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <backend/managers/jobManager.h>
+
+#include <ezlibs/ezClass.hpp>
+#include <ezlibs/ezSingleton.hpp>
+
+#include <functional>
+#include <cstdint>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+// load a file in the in memory db, or save the in memory db in a file, in a job of the JobManager.
+// the copy is done by chunks of pages, so the progress is known and it can be canceled
+class DBBackup {
+    IMPLEMENT_SINGLETON(DBBackup)
+    DISABLE_CONSTRUCTORS(DBBackup)
+    DISABLE_DESTRUCTORS(DBBackup)
+
+public:
+    enum class Operation {  //
+        LOAD_IN_MEMORY = 0,
+        SAVE_TO_FILE
+    };
+    enum class State {  //
+        IDLE = 0,
+        RUNNING,
+        DONE,
+        FAILED,
+        CANCELED
+    };
+    typedef std::function<void(DBBackup&)> CompletionFunctor;  // called in the ui thread
+
+private:
+    JobPtr m_job;
+    std::mutex m_runMutex;  // held by the job while it copies
+    std::atomic<State> m_state{State::IDLE};
+    std::atomic<int32_t> m_remainingPages{0};
+    std::atomic<int32_t> m_pagesCount{0};
+    std::chrono::steady_clock::time_point m_startTime{};
+    double m_elapsedMs{0.0};
+    Operation m_operation{Operation::LOAD_IN_MEMORY};
+    std::string m_filePathName;
+    std::string m_errorMsg;
+    CompletionFunctor m_completionFunctor;
+
+public:
+    bool init();
+    void unit();
+
+    // LOAD_IN_MEMORY need an in memory db opened with DBHelper::openMemoryDB
+    bool start(const Operation vOperation, const std::string& vFilePathName, const CompletionFunctor& vCompletionFunctor);
+    void cancel();
+    void stop();  // cancel and wait the end of the copy
+    bool isRunning() const { return m_state == State::RUNNING; }
+
+    State getState() const { return m_state; }
+    Operation getOperation() const { return m_operation; }
+    float getProgress() const;  // [0:1]
+    double getElapsedMs() const;  // live value while running
+    const std::string& getFilePathName() const { return m_filePathName; }
+    const std::string& getErrorMsg() const { return m_errorMsg; }  // valid once finished
+
+private:
+    void m_run(Job& vJob);
+    void m_complete();
+};
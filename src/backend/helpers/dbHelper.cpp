@@ -19,21 +19,234 @@
 
 #include "DBHelper.h"
 
+#include <algorithm>
+#include <cctype>
 #include <cstring>
 #include <fstream>
+#include <map>
+#include <set>
 #include <vector>
 #include <new>
 
 #include <sqlite3/sqlite3.hpp>
 #include <ezlibs/ezFile.hpp>
 
+#include <backend/helpers/queryProfiler.h>
+
+const size_t QueryResult::s_maxLoadedBlobSize = 4096U;
+const size_t QueryResult::s_maxLoadedTextSize = 4096U;
+
+void QueryResult::reserve(const size_t vRowsCount) {
+    m_columnsDatas.resize(columns.size());
+    for (auto& datas : m_columnsDatas) {
+        datas.types.reserve(vRowsCount);
+        datas.slots.reserve(vRowsCount);
+        datas.sizes.reserve(vRowsCount);
+    }
+}
+
+void QueryResult::appendRow(sqlite3_stmt* vStmt) {
+    const auto colCount = columns.size();
+    if (m_columnsDatas.size() != colCount) {
+        m_columnsDatas.resize(colCount);
+    }
+    for (size_t c = 0; c < colCount; ++c) {
+        auto& datas = m_columnsDatas[c];
+        const auto idx = static_cast<int>(c);
+        switch (sqlite3_column_type(vStmt, idx)) {
+            case SQLITE_INTEGER: {
+                datas.types.push_back(SqliteType::TYPE_INTEGER);
+                datas.slots.push_back(sqlite3_column_int64(vStmt, idx));
+                datas.sizes.push_back(0U);
+                break;
+            }
+            case SQLITE_FLOAT: {
+                const double value = sqlite3_column_double(vStmt, idx);
+                int64_t bits{};
+                std::memcpy(&bits, &value, sizeof(bits));
+                datas.types.push_back(SqliteType::TYPE_REAL);
+                datas.slots.push_back(bits);
+                datas.sizes.push_back(0U);
+                break;
+            }
+            case SQLITE_TEXT: {
+                const auto* text = reinterpret_cast<const char*>(sqlite3_column_text(vStmt, idx));
+                const auto size = static_cast<size_t>(sqlite3_column_bytes(vStmt, idx));
+                const bool isCapped = m_capTexts && size > s_maxLoadedTextSize && m_isLocated(vStmt, c);
+                datas.types.push_back(SqliteType::TYPE_TEXT);
+                datas.slots.push_back(static_cast<int64_t>(m_arena.size()));
+                datas.sizes.push_back(static_cast<uint32_t>(size));
+                m_arena.insert(m_arena.end(), text, text + (isCapped ? s_maxLoadedTextSize : size));
+                m_arena.push_back('\0');
+                break;
+            }
+            case SQLITE_BLOB: {
+                const auto* blob = static_cast<const char*>(sqlite3_column_blob(vStmt, idx));
+                const auto size = static_cast<size_t>(sqlite3_column_bytes(vStmt, idx));
+                datas.types.push_back(SqliteType::TYPE_BLOB);
+                datas.slots.push_back(static_cast<int64_t>(m_arena.size()));
+                datas.sizes.push_back(static_cast<uint32_t>(size));
+                if (blob != nullptr && size <= s_maxLoadedBlobSize) {
+                    m_arena.insert(m_arena.end(), blob, blob + size);
+                } else {
+                    (void)m_isLocated(vStmt, c);  // searched here, in the worker, before the selection of the cell
+                }
+                break;
+            }
+            default: {
+                datas.types.push_back(SqliteType::TYPE_NULL);
+                datas.slots.push_back(0);
+                datas.sizes.push_back(0U);
+                break;
+            }
+        }
+    }
+    ++m_rowsCount;
+}
+
+size_t QueryResult::getMemoryUsage() const {
+    size_t ret = m_arena.capacity();
+    for (const auto& datas : m_columnsDatas) {
+        ret += datas.types.capacity() * sizeof(SqliteType);
+        ret += datas.slots.capacity() * sizeof(int64_t);
+        ret += datas.sizes.capacity() * sizeof(uint32_t);
+    }
+    return ret;
+}
+
+int64_t QueryResult::getInteger(const size_t vRow, const size_t vCol) const {
+    const auto& datas = m_columnsDatas[vCol];
+    if (datas.types[vRow] == SqliteType::TYPE_REAL) {
+        return static_cast<int64_t>(getReal(vRow, vCol));
+    } else if (datas.types[vRow] == SqliteType::TYPE_INTEGER) {
+        return datas.slots[vRow];
+    }
+    return 0;
+}
+
+double QueryResult::getReal(const size_t vRow, const size_t vCol) const {
+    const auto& datas = m_columnsDatas[vCol];
+    if (datas.types[vRow] == SqliteType::TYPE_REAL) {
+        double value{};
+        std::memcpy(&value, &datas.slots[vRow], sizeof(value));
+        return value;
+    } else if (datas.types[vRow] == SqliteType::TYPE_INTEGER) {
+        return static_cast<double>(datas.slots[vRow]);
+    }
+    return 0.0;
+}
+
+std::string_view QueryResult::getText(const size_t vRow, const size_t vCol) const {
+    const auto& datas = m_columnsDatas[vCol];
+    if (datas.types[vRow] == SqliteType::TYPE_TEXT) {
+        const char* text = m_arena.data() + datas.slots[vRow];
+        size_t size = datas.sizes[vRow];
+        if (!isTextLoaded(vRow, vCol)) {
+            size = s_maxLoadedTextSize;
+            while (size > 0U && (static_cast<uint8_t>(text[size]) & 0xC0) == 0x80) {  // not in a utf8 sequence
+                --size;
+            }
+        }
+        return std::string_view(text, size);
+    }
+    return {};
+}
+
+bool QueryResult::isTextLoaded(const size_t vRow, const size_t vCol) const {
+    return !m_capTexts || getSize(vRow, vCol) <= s_maxLoadedTextSize || !m_isLocated(vRow, vCol);
+}
+
+std::string_view QueryResult::getBlob(const size_t vRow, const size_t vCol) const {
+    const auto& datas = m_columnsDatas[vCol];
+    if (datas.types[vRow] == SqliteType::TYPE_BLOB && datas.sizes[vRow] > 0U && datas.sizes[vRow] <= s_maxLoadedBlobSize) {
+        return std::string_view(m_arena.data() + datas.slots[vRow], datas.sizes[vRow]);
+    }
+    return {};
+}
+
+bool QueryResult::getCellLocator(const size_t vRow, const size_t vCol, BlobLocator& vOutLocator) const {
+    if (!m_isLocated(vRow, vCol)) {
+        return false;
+    }
+    const auto& column = columns.at(vCol);
+    vOutLocator.database = column.originDatabase;
+    vOutLocator.table = column.originTable;
+    vOutLocator.column = column.originColumn;
+    vOutLocator.rowid = getInteger(vRow, static_cast<size_t>(rowidColumns->get(vCol)));
+    return true;
+}
+
+bool QueryResult::m_isLocated(const size_t vRow, const size_t vCol) const {
+    const auto rowidColumn = (rowidColumns != nullptr) ? rowidColumns->get(vCol) : -1;
+    return rowidColumn >= 0 && getType(vRow, static_cast<size_t>(rowidColumn)) == SqliteType::TYPE_INTEGER;
+}
+
+bool QueryResult::m_isLocated(sqlite3_stmt* vStmt, const size_t vCol) {
+    if (rowidColumns == nullptr) {
+        return false;
+    }
+    rowidColumns->search(sqlite3_db_handle(vStmt), columns);
+    const auto rowidColumn = rowidColumns->get(vCol);
+    return rowidColumn >= 0 && sqlite3_column_type(vStmt, rowidColumn) == SQLITE_INTEGER;
+}
+
+int32_t RowidColumns::get(const size_t vCol) const {
+    if (!m_isSearched || vCol >= m_rowidColumns.size()) {
+        return -1;
+    }
+    return m_rowidColumns[vCol];
+}
+
+void RowidColumns::search(sqlite3* vDbPtr, const std::vector<ColumnInfo>& vColumns) noexcept {
+    if (m_isSearched) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_searchMutex);
+    if (!m_isSearched) {  // the ui and a fetch can ask it together
+        m_rowidColumns = DBHelper::searchRowidColumns(vDbPtr, m_sql, vColumns);
+        m_isSearched = true;
+    }
+}
+
 void SqliteDbDeleter::operator()(sqlite3* vDb) const noexcept {
     if (vDb != nullptr) {
         sqlite3_close_v2(vDb);
     }
 }
 
+void QueryControl::interrupt() noexcept {
+    std::lock_guard<std::mutex> lock(connectionMutex);
+    if (connectionPtr != nullptr) {
+        sqlite3_interrupt(connectionPtr);
+    }
+}
+
+ReadConnection::ReadConnection(ReadConnection&& vOther) noexcept : m_dbPtr(vOther.m_dbPtr), m_generation(vOther.m_generation) {
+    vOther.m_dbPtr = nullptr;
+}
+
+ReadConnection& ReadConnection::operator=(ReadConnection&& vOther) noexcept {
+    if (this != &vOther) {
+        release();
+        m_dbPtr = vOther.m_dbPtr;
+        m_generation = vOther.m_generation;
+        vOther.m_dbPtr = nullptr;
+    }
+    return *this;
+}
+
+void ReadConnection::release() noexcept {
+    if (m_dbPtr != nullptr) {
+        DBHelper::ref().m_releaseReadConnection(m_dbPtr, m_generation);
+        m_dbPtr = nullptr;
+    }
+}
+
 const int32_t DBHelper::m_maxInsertAttempts = 50;
+const size_t DBHelper::m_maxCachedStatements = 128U;
+const size_t DBHelper::m_maxReadConnections = 4U;
+const int32_t DBHelper::m_backupPagesPerStep = 1024;  // 4 MB with the default page size
+const size_t DBHelper::m_blobChunkSize = 1024U * 1024U;
 
 bool DBHelper::init(const std::string& vDBFilePathName) noexcept {
     unit();
@@ -42,8 +255,10 @@ bool DBHelper::init(const std::string& vDBFilePathName) noexcept {
 }
 
 void DBHelper::unit() noexcept {
+    std::lock_guard<std::recursive_mutex> lock(m_dbMutex);
     m_closeDB();
     m_dataBaseFilePathName.clear();
+    m_inMemory = false;
     m_lastErrorMsg.clear();
     m_transactionStarted = false;
 }
@@ -68,7 +283,9 @@ bool DBHelper::createDBFile(const std::string& vDBFilePathName) noexcept {
     if (vDBFilePathName.empty()) {
         return false;
     }
+    std::lock_guard<std::recursive_mutex> lock(m_dbMutex);
     m_dataBaseFilePathName = vDBFilePathName;
+    m_inMemory = false;
     ez::file::destroyFile(m_dataBaseFilePathName);
     return m_createDB();
 }
@@ -78,21 +295,120 @@ bool DBHelper::openDBFile() noexcept {
 }
 
 bool DBHelper::openDBFile(const std::string& vDBFilePathName) noexcept {
+    std::lock_guard<std::recursive_mutex> lock(m_dbMutex);
     if (m_sqliteDb != nullptr) {
         // already open
         return true;
     }
     m_dataBaseFilePathName = vDBFilePathName;
+    m_inMemory = false;
     return m_openDB();
 }
 
 void DBHelper::closeDBFile() noexcept {
+    std::lock_guard<std::recursive_mutex> lock(m_dbMutex);
     m_closeDB();
 }
 
+// MEMORY
+
+bool DBHelper::openMemoryDB() noexcept {
+    std::lock_guard<std::recursive_mutex> lock(m_dbMutex);
+    m_closeDB();
+    if (m_sqliteDb != nullptr) {
+        return false;  // a transaction is running
+    }
+    m_dataBaseFilePathName = ":memory:";
+    m_inMemory = m_createDB();
+    return m_inMemory;
+}
+
+bool DBHelper::backupWithFile(  //
+    const std::string& vFilePathName,
+    const bool vToFile,
+    const BackupProgressFunctor& vProgressFunctor,
+    std::string* vpOutErrorMsg) noexcept {
+    std::string errorMsg;
+    std::unique_ptr<sqlite3, SqliteDbDeleter> fileDb{};
+    {
+        sqlite3* rawHandle = nullptr;
+        const auto flags = vToFile ? (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE) : SQLITE_OPEN_READONLY;
+        if (sqlite3_open_v2(vFilePathName.c_str(), &rawHandle, flags, nullptr) != SQLITE_OK) {
+            errorMsg = (rawHandle != nullptr) ? sqlite3_errmsg(rawHandle) : "sqlite3_open_v2 failed.";
+        }
+        fileDb.reset(rawHandle);
+    }
+    // the db is locked during the whole load, the others threads must not see it half copied
+    std::unique_lock<std::recursive_mutex> lock(m_dbMutex);
+    if (errorMsg.empty()) {
+        if (!m_openDB()) {
+            errorMsg = m_lastErrorMsg;
+        } else if (!vToFile && !m_inMemory) {
+            errorMsg = "A file can only be loaded in a memory db";
+        }
+    }
+    if (errorMsg.empty() && !vToFile) {
+        // the backup can't change the page size of an in memory destination, it must be the one of the source
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(fileDb.get(), "PRAGMA page_size;", -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+            const auto pageSize = sqlite3_column_int(stmt, 0);
+            (void)m_debugSqlite3Exec(__FUNCTION__, "PRAGMA page_size = " + std::to_string(pageSize) + ";");
+        }
+        sqlite3_finalize(stmt);
+    }
+    auto* pDest = vToFile ? fileDb.get() : m_sqliteDb.get();
+    auto* pSource = vToFile ? m_sqliteDb.get() : fileDb.get();
+    sqlite3_backup* pBackup = nullptr;
+    if (errorMsg.empty()) {
+        pBackup = sqlite3_backup_init(pDest, "main", pSource, "main");
+        if (pBackup == nullptr) {
+            errorMsg = sqlite3_errmsg(pDest);
+        }
+    }
+    if (pBackup != nullptr) {
+        bool canceled = false;
+        auto rc = SQLITE_OK;
+        while (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED) {
+            if (!lock.owns_lock()) {
+                lock.lock();
+            }
+            rc = sqlite3_backup_step(pBackup, m_backupPagesPerStep);
+            const auto remainingPages = sqlite3_backup_remaining(pBackup);
+            const auto pagesCount = sqlite3_backup_pagecount(pBackup);
+            if (vToFile) {
+                // the changes done on the db by the others threads are reported in the backup by sqlite
+                lock.unlock();
+            }
+            if (vProgressFunctor && !vProgressFunctor(remainingPages, pagesCount)) {
+                canceled = true;
+                break;
+            }
+            if (rc == SQLITE_BUSY || rc == SQLITE_LOCKED) {
+                sqlite3_sleep(10);
+            }
+        }
+        if (!lock.owns_lock()) {
+            lock.lock();
+        }
+        // an unfinished backup is rollbacked, the destination stay as before
+        const auto finishRc = sqlite3_backup_finish(pBackup);
+        if (canceled) {
+            errorMsg = "Backup canceled";
+        } else if (rc != SQLITE_DONE || finishRc != SQLITE_OK) {
+            errorMsg = sqlite3_errmsg(pDest);
+        }
+    }
+    m_lastErrorMsg = errorMsg;
+    if (vpOutErrorMsg != nullptr) {
+        *vpOutErrorMsg = errorMsg;
+    }
+    return errorMsg.empty();
+}
+
 // TRANSACTIONS
 
 bool DBHelper::beginDBTransaction() noexcept {
+    std::lock_guard<std::recursive_mutex> lock(m_dbMutex);
     if (!m_openDB()) {
         return false;
     }
@@ -105,12 +421,13 @@ bool DBHelper::beginDBTransaction() noexcept {
 }
 
 void DBHelper::commitDBTransaction() noexcept {
+    std::lock_guard<std::recursive_mutex> lock(m_dbMutex);
     (void)m_debugSqlite3Exec(__FUNCTION__, "COMMIT;");
     m_transactionStarted = false;
-    m_closeDB();
 }
 
 void DBHelper::rollbackDBTransaction() noexcept {
+    std::lock_guard<std::recursive_mutex> lock(m_dbMutex);
     (void)m_debugSqlite3Exec(__FUNCTION__, "ROLLBACK;");
     m_transactionStarted = false;
 }
@@ -121,52 +438,35 @@ std::string DBHelper::getLastErrorMsg() const noexcept {
     return m_lastErrorMsg;
 }
 
-QueryResult DBHelper::executeQuery(const std::string& vSql) noexcept {
+QueryResult DBHelper::executeQuery(const std::string& vSql, QueryControl* vpControl, const bool vCacheStatement) noexcept {
     QueryResult result{};
 
+    std::lock_guard<std::recursive_mutex> lock(m_dbMutex);
+
     if (!m_openDB()) {
         return result;
     }
 
     m_lastErrorMsg.clear();
-    sqlite3_stmt* stmt = nullptr;
-    if (m_debugSqlite3PrepareV2(__FUNCTION__, vSql, -1, &stmt, nullptr) != SQLITE_OK) {
-        m_lastErrorMsg = sqlite3_errmsg(m_sqliteDb.get());
+    sqlite3_stmt* stmt = m_acquireStatement(vSql, vCacheStatement);
+    if (stmt == nullptr) {
+        if (vpControl != nullptr) {
+            vpControl->errorMsg = m_lastErrorMsg;
+        }
         return result;
     }
 
-    const int colCount = sqlite3_column_count(stmt);
-    result.columns.reserve(colCount);
+    installQueryControl(vpControl);
 
-    for (int i = 0; i < colCount; ++i) {
-        ColumnInfo ci;
-        ci.name = sqlite3_column_name(stmt, i);
-        const char* decl = sqlite3_column_decltype(stmt, i);
-        ci.declType = decl ? decl : "";
-        result.columns.push_back(std::move(ci));
-    }
+    result.columns = readColumnInfos(stmt);
 
     while (true) {
         int stepRes = sqlite3_step(stmt);
         if (stepRes == SQLITE_ROW) {
-            Row row;
-            row.values.reserve(colCount);
-            for (int i = 0; i < colCount; ++i) {
-                int type = sqlite3_column_type(stmt, i);
-                switch (type) {
-                    case SQLITE_INTEGER: row.values.emplace_back((int64_t)sqlite3_column_int64(stmt, i)); break;
-                    case SQLITE_FLOAT: row.values.emplace_back(sqlite3_column_double(stmt, i)); break;
-                    case SQLITE_TEXT: row.values.emplace_back(std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, i)))); break;
-                    case SQLITE_BLOB: {
-                        const void* data = sqlite3_column_blob(stmt, i);
-                        int size = sqlite3_column_bytes(stmt, i);
-                        row.values.emplace_back(std::vector<uint8_t>((const uint8_t*)data, (const uint8_t*)data + size));
-                        break;
-                    }
-                    default: row.values.emplace_back(nullptr); break;
-                }
+            result.appendRow(stmt);
+            if (vpControl != nullptr) {
+                ++vpControl->rowsCount;
             }
-            result.rows.push_back(std::move(row));
         } else if (stepRes == SQLITE_DONE) {
             break;
         } else {
@@ -175,14 +475,747 @@ QueryResult DBHelper::executeQuery(const std::string& vSql) noexcept {
         }
     }
 
+    m_releaseStatement(stmt, vCacheStatement);
+
+    uninstallQueryControl(vpControl, m_lastErrorMsg);
+    if (vpControl != nullptr) {
+        m_lastErrorMsg = vpControl->errorMsg;
+    }
+    return result;
+}
+
+// SCRIPT
+
+bool DBHelper::isScript(const std::string& vSql) noexcept {
+    // split without a prepare, it fail on a read connection for a temp table, an attached db
+    // or a table created in the transaction of the writer, and the next statements were dropped
+    const char* pBegin = vSql.c_str();
+    const char* pEnd = pBegin + vSql.size();
+    const char* pStart = m_skipBlankSql(pBegin, pEnd);
+    std::string statement;
+    for (auto pos = vSql.find(';', static_cast<size_t>(pStart - pBegin)); pos != std::string::npos; pos = vSql.find(';', pos + 1U)) {
+        statement.assign(pStart, pBegin + pos + 1U);
+        // false for a ';' in a string, a comment or the body of a trigger
+        if (sqlite3_complete(statement.c_str()) != 0) {
+            return m_skipBlankSql(pBegin + pos + 1U, pEnd) != pEnd;
+        }
+    }
+    return false;
+}
+
+ScriptResult DBHelper::executeScript(const std::string& vSql, const bool vInTransaction, QueryControl* vpControl) noexcept {
+    ScriptResult script{};
+
+    std::lock_guard<std::recursive_mutex> lock(m_dbMutex);
+
+    m_lastErrorMsg.clear();
+    if (!m_openDB() || (vInTransaction && !beginDBTransaction())) {
+        if (vpControl != nullptr) {
+            vpControl->errorMsg = m_lastErrorMsg;
+        }
+        return script;
+    }
+    script.inTransaction = vInTransaction;
+
+    installQueryControl(vpControl);
+
+    auto* dbPtr = m_sqliteDb.get();
+    const char* pBegin = vSql.c_str();
+    const char* pEnd = pBegin + vSql.size();
+    const char* pCurrent = m_skipBlankSql(pBegin, pEnd);
+    while (pCurrent < pEnd && m_lastErrorMsg.empty()) {
+        const auto startTime = std::chrono::steady_clock::now();
+        StatementResult statement;
+        statement.offset = static_cast<size_t>(pCurrent - pBegin);
+        sqlite3_stmt* stmt = nullptr;
+        const char* pTail = pEnd;
+        if (sqlite3_prepare_v2(dbPtr, pCurrent, static_cast<int>(pEnd - pCurrent), &stmt, &pTail) != SQLITE_OK) {
+            m_lastErrorMsg = sqlite3_errmsg(dbPtr);
+            statement.sql.assign(pCurrent, pEnd);
+            statement.errorMsg = m_lastErrorMsg;
+            script.statements.push_back(std::move(statement));
+            break;
+        }
+        if (stmt != nullptr) {
+            statement.sql.assign(pCurrent, pTail);
+            statement.result.columns = readColumnInfos(stmt);
+            statement.result.rowidColumns = std::make_shared<RowidColumns>(statement.sql);
+            const auto totalChanges = sqlite3_total_changes64(dbPtr);
+            while (true) {
+                const auto rc = sqlite3_step(stmt);
+                if (rc == SQLITE_ROW) {
+                    statement.result.appendRow(stmt);
+                    if (vpControl != nullptr) {
+                        ++vpControl->rowsCount;
+                    }
+                } else {
+                    if (rc != SQLITE_DONE) {
+                        m_lastErrorMsg = sqlite3_errmsg(dbPtr);
+                        statement.errorMsg = m_lastErrorMsg;
+                    }
+                    break;
+                }
+            }
+            // sqlite3_changes64 keep the count of the last INSERT/UPDATE/DELETE, so only read it if this statement changed rows
+            if (sqlite3_total_changes64(dbPtr) != totalChanges) {
+                statement.changesCount = sqlite3_changes64(dbPtr);
+            }
+            sqlite3_finalize(stmt);
+            statement.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+            script.statements.push_back(std::move(statement));
+        }
+        pCurrent = m_skipBlankSql(pTail, pEnd);
+    }
+
+    uninstallQueryControl(vpControl, m_lastErrorMsg);
+    if (vpControl != nullptr) {
+        m_lastErrorMsg = vpControl->errorMsg;
+    }
+
+    if (script.inTransaction) {
+        if (m_lastErrorMsg.empty()) {
+            commitDBTransaction();
+        }
+        if (!m_lastErrorMsg.empty()) {  // the script or the commit failed
+            const auto errorMsg = m_lastErrorMsg;
+            // an interrupted statement can have already rollbacked the transaction
+            if (sqlite3_get_autocommit(dbPtr) == 0) {
+                rollbackDBTransaction();
+            } else {
+                m_transactionStarted = false;
+            }
+            m_lastErrorMsg = errorMsg;
+            if (vpControl != nullptr) {
+                vpControl->errorMsg = m_lastErrorMsg;
+            }
+        }
+    }
+    return script;
+}
+
+// CURSOR
+
+sqlite3_stmt* DBHelper::prepareStatement(const std::string& vSql) noexcept {
+    std::lock_guard<std::recursive_mutex> lock(m_dbMutex);
+    if (!m_openDB()) {
+        return nullptr;
+    }
+    m_lastErrorMsg.clear();
+    sqlite3_stmt* stmt = nullptr;
+    if (m_debugSqlite3PrepareV2(__FUNCTION__, vSql, -1, &stmt, nullptr) != SQLITE_OK) {
+        m_lastErrorMsg = sqlite3_errmsg(m_sqliteDb.get());
+        return nullptr;
+    }
+    return stmt;
+}
+
+void DBHelper::installQueryControl(QueryControl* vpControl) noexcept {
+    installQueryControl(m_sqliteDb.get(), vpControl);
+}
+
+void DBHelper::uninstallQueryControl(QueryControl* vpControl, const std::string& vErrorMsg) noexcept {
+    uninstallQueryControl(m_sqliteDb.get(), vpControl, vErrorMsg);
+}
+
+void DBHelper::installQueryControl(sqlite3* vDbPtr, QueryControl* vpControl) noexcept {
+    if (vpControl != nullptr && vDbPtr != nullptr) {
+        // checked every 1000 vm instructions, a non zero return interrupt the statement
+        sqlite3_progress_handler(vDbPtr, 1000, m_progressHandler, vpControl);
+        std::lock_guard<std::mutex> lock(vpControl->connectionMutex);
+        vpControl->connectionPtr = vDbPtr;
+    }
+}
+
+void DBHelper::uninstallQueryControl(sqlite3* vDbPtr, QueryControl* vpControl, const std::string& vErrorMsg) noexcept {
+    if (vpControl != nullptr) {
+        if (vDbPtr != nullptr) {
+            sqlite3_progress_handler(vDbPtr, 0, nullptr, nullptr);
+        }
+        {
+            std::lock_guard<std::mutex> lock(vpControl->connectionMutex);
+            vpControl->connectionPtr = nullptr;
+        }
+        if (vpControl->timedOut) {
+            vpControl->errorMsg = "Query timeout after " + std::to_string(vpControl->timeoutMs) + " ms";
+        } else if (vpControl->cancelRequested) {
+            vpControl->errorMsg = "Query canceled";
+        } else {
+            vpControl->errorMsg = vErrorMsg;
+        }
+    }
+}
+
+std::vector<ColumnInfo> DBHelper::readColumnInfos(sqlite3_stmt* vStmt) noexcept {
+    std::vector<ColumnInfo> columns;
+    const int colCount = sqlite3_column_count(vStmt);
+    columns.reserve(colCount);
+    for (int i = 0; i < colCount; ++i) {
+        ColumnInfo ci;
+        ci.name = sqlite3_column_name(vStmt, i);
+        const char* decl = sqlite3_column_decltype(vStmt, i);
+        ci.declType = decl ? decl : "";
+#ifdef SQLITE_ENABLE_COLUMN_METADATA
+        const char* database = sqlite3_column_database_name(vStmt, i);
+        const char* table = sqlite3_column_table_name(vStmt, i);
+        const char* origin = sqlite3_column_origin_name(vStmt, i);
+        if (database != nullptr && table != nullptr && origin != nullptr) {
+            ci.originDatabase = database;
+            ci.originTable = table;
+            ci.originColumn = origin;
+        }
+#endif
+        columns.push_back(std::move(ci));
+    }
+    return columns;
+}
+
+std::vector<int32_t> DBHelper::searchRowidColumns(sqlite3* vDbPtr, const std::string& vSql, const std::vector<ColumnInfo>& vColumns) noexcept {
+    std::vector<int32_t> ret(vColumns.size(), -1);
+    if (vDbPtr == nullptr) {
+        return ret;
+    }
+#ifdef SQLITE_ENABLE_COLUMN_METADATA
+    // the blobs are located by the rowid of their row, so we search a result column holding the rowid of their table
+    std::map<std::pair<std::string, std::string>, int32_t> rowidColumns;  // by origin database and table
+    for (size_t i = 0; i < vColumns.size(); ++i) {
+        const auto& ci = vColumns[i];
+        if (!ci.originTable.empty() && m_isRowidColumn(vDbPtr, ci)) {
+            rowidColumns.emplace(std::make_pair(ci.originDatabase, ci.originTable), static_cast<int32_t>(i));  // the first is kept
+        }
+    }
+    // the column metadata don't tell the instance of the table, so a table read twice can't be located.
+    // else in a self join the blob of one row would be located by the rowid of another
+    for (auto it = rowidColumns.begin(); it != rowidColumns.end();) {
+        if (m_countTableInstances(vDbPtr, vSql, it->first.first, it->first.second) != 1U) {
+            it = rowidColumns.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (size_t i = 0; i < vColumns.size(); ++i) {
+        const auto it = rowidColumns.find(std::make_pair(vColumns[i].originDatabase, vColumns[i].originTable));
+        if (it != rowidColumns.end()) {
+            ret[i] = it->second;
+        }
+    }
+#else
+    (void)vSql;
+#endif
+    return ret;
+}
+
+void DBHelper::searchRowidColumns(RowidColumns& vRowidColumns, const std::vector<ColumnInfo>& vColumns) noexcept {
+    auto connection = acquireReadConnection();
+    std::unique_lock<std::recursive_mutex> lock(m_dbMutex, std::defer_lock);
+    auto* dbPtr = connection.get();
+    if (dbPtr == nullptr) {
+        lock.lock();
+        if (m_openDB()) {
+            dbPtr = m_sqliteDb.get();
+        }
+    }
+    vRowidColumns.search(dbPtr, vColumns);  // none are found without a db, the search is not tried again
+}
+
+// the cursors opened on the table or on its indexes are read in the program of the statement.
+// an index cursor tied to a table cursor by a seek on its rowid is the same instance, any other cursor is one more
+size_t DBHelper::m_countTableInstances(sqlite3* vDbPtr, const std::string& vSql, const std::string& vDatabase, const std::string& vTable) noexcept {
+    int databaseIdx = -1;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(vDbPtr, "SELECT seq FROM pragma_database_list WHERE name = ?1", -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, vDatabase.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            databaseIdx = sqlite3_column_int(stmt, 0);
+        }
+    }
+    sqlite3_finalize(stmt);
+    std::set<int> rootPages;  // of the table and of its indexes
+    char* rootsSql = sqlite3_mprintf("SELECT rootpage FROM \"%w\".sqlite_schema WHERE tbl_name = ?1 AND rootpage > 0", vDatabase.c_str());
+    stmt = nullptr;
+    if (rootsSql != nullptr && sqlite3_prepare_v2(vDbPtr, rootsSql, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, vTable.c_str(), -1, SQLITE_TRANSIENT);
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            rootPages.insert(sqlite3_column_int(stmt, 0));
+        }
+    }
     sqlite3_finalize(stmt);
+    sqlite3_free(rootsSql);
+    if (databaseIdx < 0 || rootPages.empty()) {
+        return 0U;
+    }
+    std::map<int, int> cursorParents;  // union find of the cursors of the table
+    const auto findRoot = [&cursorParents](int vCursor) {
+        while (cursorParents[vCursor] != vCursor) {
+            vCursor = cursorParents[vCursor];
+        }
+        return vCursor;
+    };
+    const auto join = [&cursorParents, &findRoot](const int vCursorA, const int vCursorB) {
+        if (cursorParents.count(vCursorA) != 0U && cursorParents.count(vCursorB) != 0U) {
+            cursorParents[findRoot(vCursorA)] = findRoot(vCursorB);
+        }
+    };
+    const std::string explainSql = "EXPLAIN " + vSql;
+    stmt = nullptr;
+    if (sqlite3_prepare_v2(vDbPtr, explainSql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        return 0U;
+    }
+    int rowidRegister = -1;  // written by the previous opcode
+    int rowidCursor = -1;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        // addr, opcode, p1, p2, p3, p4, p5, comment
+        const auto* opcodePtr = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        const std::string opcode = (opcodePtr != nullptr) ? opcodePtr : "";
+        const int p1 = sqlite3_column_int(stmt, 2);
+        const int p2 = sqlite3_column_int(stmt, 3);
+        const int p3 = sqlite3_column_int(stmt, 4);
+        if (opcode == "OpenRead" || opcode == "OpenWrite" || opcode == "ReopenIdx") {
+            if (p3 == databaseIdx && rootPages.count(p2) != 0U) {
+                cursorParents.emplace(p1, p1);
+            }
+        } else if (opcode == "DeferredSeek") {
+            join(p1, p3);  // the index cursor and the table cursor
+        } else if ((opcode == "SeekRowid" || opcode == "NotExists") && p3 == rowidRegister) {
+            join(p1, rowidCursor);
+        }
+        if (opcode == "IdxRowid" || opcode == "Rowid") {
+            rowidRegister = p2;
+            rowidCursor = p1;
+        } else {
+            rowidRegister = -1;
+        }
+    }
+    sqlite3_finalize(stmt);
+    size_t ret = 0U;
+    for (const auto& cursor : cursorParents) {
+        if (findRoot(cursor.first) == cursor.first) {
+            ++ret;
+        }
+    }
+    return ret;
+}
 
-    m_closeDB();
+bool DBHelper::m_isRowidColumn(sqlite3* vDbPtr, const ColumnInfo& vColumn) noexcept {
+#ifdef SQLITE_ENABLE_COLUMN_METADATA
+    if (vColumn.originColumn == "rowid") {  // the origin of a rowid of a table without INTEGER PRIMARY KEY
+        return true;
+    }
+    // else only an INTEGER PRIMARY KEY alone is an alias of the rowid
+    const char* type = nullptr;
+    int primaryKey = 0;
+    if (sqlite3_table_column_metadata(  //
+            vDbPtr,
+            vColumn.originDatabase.c_str(),
+            vColumn.originTable.c_str(),
+            vColumn.originColumn.c_str(),
+            &type,
+            nullptr,
+            nullptr,
+            &primaryKey,
+            nullptr) != SQLITE_OK ||
+        primaryKey == 0 || type == nullptr || sqlite3_stricmp(type, "INTEGER") != 0) {
+        return false;
+    }
+    bool ret = false;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(vDbPtr, "SELECT count(*) FROM pragma_table_info(?1, ?2) WHERE pk > 0", -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, vColumn.originTable.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, vColumn.originDatabase.c_str(), -1, SQLITE_TRANSIENT);
+        ret = (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_int(stmt, 0) == 1);
+    }
+    sqlite3_finalize(stmt);
+    return ret;
+#else
+    return false;
+#endif
+}
+
+// BLOB
+
+BlobReadStatus DBHelper::readBlob(const BlobLocator& vLocator, const size_t vOffset, char* vBuffer, const size_t vSize, std::string* vpOutErrorMsg) noexcept {
+    auto readConnection = acquireReadConnection();
+    std::unique_lock<std::recursive_mutex> lock(m_dbMutex, std::defer_lock);
+    sqlite3* dbPtr = readConnection.get();
+    if (dbPtr == nullptr) {
+        if (!lock.try_lock()) {  // a query is running on the writer
+            return BlobReadStatus::BUSY;
+        }
+        dbPtr = m_sqliteDb.get();
+    }
+    if (dbPtr == nullptr) {
+        if (vpOutErrorMsg != nullptr) {
+            *vpOutErrorMsg = "No database opened";
+        }
+        return BlobReadStatus::FAILED;
+    }
+    auto ret = BlobReadStatus::FAILED;
+    sqlite3_blob* blobPtr = nullptr;
+    if (sqlite3_blob_open(  //
+            dbPtr,
+            vLocator.database.c_str(),
+            vLocator.table.c_str(),
+            vLocator.column.c_str(),
+            vLocator.rowid,
+            0,
+            &blobPtr) == SQLITE_OK &&
+        sqlite3_blob_read(blobPtr, vBuffer, static_cast<int>(vSize), static_cast<int>(vOffset)) == SQLITE_OK) {
+        ret = BlobReadStatus::SUCCESS;
+    } else if (vpOutErrorMsg != nullptr) {
+        *vpOutErrorMsg = sqlite3_errmsg(dbPtr);
+    }
+    sqlite3_blob_close(blobPtr);  // no-op if null
+    return ret;
+}
+
+bool DBHelper::saveBlobToFile(  //
+    const BlobLocator& vLocator,
+    const std::string& vFilePathName,
+    const BlobTransferProgressFunctor& vProgressFunctor,
+    std::string* vpOutErrorMsg) noexcept {
+    std::string errorMsg;
+    // on the writer, the lock is taken only during the reads of the chunks
+    auto readConnection = acquireReadConnection();
+    const bool onWriter = !readConnection.isValid();
+    std::unique_lock<std::recursive_mutex> lock(m_dbMutex, std::defer_lock);
+    if (onWriter) {
+        lock.lock();
+    }
+    sqlite3* dbPtr = onWriter ? m_sqliteDb.get() : readConnection.get();
+    sqlite3_blob* blobPtr = nullptr;
+    if (dbPtr == nullptr) {
+        errorMsg = "No database opened";
+    } else if (sqlite3_blob_open(  //
+                   dbPtr,
+                   vLocator.database.c_str(),
+                   vLocator.table.c_str(),
+                   vLocator.column.c_str(),
+                   vLocator.rowid,
+                   0,
+                   &blobPtr) != SQLITE_OK) {
+        errorMsg = sqlite3_errmsg(dbPtr);
+    }
+    if (onWriter) {
+        lock.unlock();
+    }
+    std::ofstream file;
+    bool fileCreated = false;
+    if (errorMsg.empty()) {
+        file.open(vFilePathName, std::ios::binary | std::ios::trunc);
+        fileCreated = file.is_open();
+        if (!fileCreated) {
+            errorMsg = "Can't open " + vFilePathName;
+        }
+    }
+    bool canceled = false;
+    if (errorMsg.empty()) {
+        const auto size = static_cast<size_t>(sqlite3_blob_bytes(blobPtr));
+        std::vector<char> chunk(std::min(m_blobChunkSize, size));
+        size_t offset = 0U;
+        while (offset < size) {
+            const size_t count = std::min(chunk.size(), size - offset);
+            if (onWriter) {
+                lock.lock();
+            }
+            // SQLITE_ABORT if the row was changed since the open
+            const auto rc = sqlite3_blob_read(blobPtr, chunk.data(), static_cast<int>(count), static_cast<int>(offset));
+            if (rc != SQLITE_OK) {
+                errorMsg = sqlite3_errmsg(dbPtr);
+            }
+            if (onWriter) {
+                lock.unlock();
+            }
+            if (!errorMsg.empty()) {
+                break;
+            }
+            if (!file.write(chunk.data(), static_cast<std::streamsize>(count))) {
+                errorMsg = "Failed to write in " + vFilePathName;
+                break;
+            }
+            offset += count;
+            if (vProgressFunctor && !vProgressFunctor(offset, size)) {
+                canceled = true;
+                break;
+            }
+        }
+    }
+    if (blobPtr != nullptr) {
+        if (onWriter) {
+            lock.lock();
+        }
+        sqlite3_blob_close(blobPtr);
+    }
+    if (file.is_open()) {
+        file.close();
+        if (file.fail() && errorMsg.empty()) {
+            errorMsg = "Failed to write in " + vFilePathName;
+        }
+    }
+    if (fileCreated && (!errorMsg.empty() || canceled)) {
+        std::remove(vFilePathName.c_str());  // no partial file
+    }
+    if (vpOutErrorMsg != nullptr) {
+        *vpOutErrorMsg = errorMsg;
+    }
+    return errorMsg.empty() && !canceled;
+}
+
+bool DBHelper::loadBlobFromFile(  //
+    const BlobLocator& vLocator,
+    const std::string& vFilePathName,
+    const BlobTransferProgressFunctor& vProgressFunctor,
+    std::string* vpOutErrorMsg) noexcept {
+    std::string errorMsg;
+    std::ifstream file(vFilePathName, std::ios::binary | std::ios::ate);
+    size_t size = 0U;
+    if (!file.is_open()) {
+        errorMsg = "Can't open " + vFilePathName;
+    } else {
+        size = static_cast<size_t>(file.tellg());
+        file.seekg(0, std::ios::beg);
+        if (size > static_cast<size_t>(INT32_MAX)) {
+            errorMsg = "The file is too big for a sqlite blob";
+        }
+    }
+    // the writer is locked during the whole load, the others threads must not see the cell half written
+    std::unique_lock<std::recursive_mutex> lock(m_dbMutex);
+    auto* dbPtr = m_sqliteDb.get();
+    if (errorMsg.empty() && dbPtr == nullptr) {
+        errorMsg = "No database opened";
+    }
+    bool inSavepoint = false;
+    if (errorMsg.empty()) {
+        if (m_debugSqlite3Exec(__FUNCTION__, "SAVEPOINT blob_load;") != SQLITE_OK) {
+            errorMsg = m_lastErrorMsg;
+        } else {
+            inSavepoint = true;
+        }
+    }
+    if (errorMsg.empty()) {
+        // the size is reserved first, then the blob is written in place
+        char* sql = sqlite3_mprintf(  //
+            "UPDATE \"%w\".\"%w\" SET \"%w\" = ?1 WHERE rowid = ?2;",
+            vLocator.database.c_str(),
+            vLocator.table.c_str(),
+            vLocator.column.c_str());
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(dbPtr, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+            errorMsg = sqlite3_errmsg(dbPtr);
+        } else {
+            sqlite3_bind_zeroblob64(stmt, 1, static_cast<sqlite3_uint64>(size));
+            sqlite3_bind_int64(stmt, 2, vLocator.rowid);
+            if (sqlite3_step(stmt) != SQLITE_DONE) {
+                errorMsg = sqlite3_errmsg(dbPtr);
+            } else if (sqlite3_changes(dbPtr) != 1) {
+                errorMsg = "The row of the cell was not found";
+            }
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_free(sql);
+    }
+    bool canceled = false;
+    if (errorMsg.empty() && size > 0U) {
+        sqlite3_blob* blobPtr = nullptr;
+        if (sqlite3_blob_open(  //
+                dbPtr,
+                vLocator.database.c_str(),
+                vLocator.table.c_str(),
+                vLocator.column.c_str(),
+                vLocator.rowid,
+                1,
+                &blobPtr) != SQLITE_OK) {
+            errorMsg = sqlite3_errmsg(dbPtr);
+        } else {
+            std::vector<char> chunk(std::min(m_blobChunkSize, size));
+            size_t offset = 0U;
+            while (offset < size) {
+                const size_t count = std::min(chunk.size(), size - offset);
+                if (!file.read(chunk.data(), static_cast<std::streamsize>(count))) {
+                    errorMsg = "Failed to read " + vFilePathName;
+                    break;
+                }
+                if (sqlite3_blob_write(blobPtr, chunk.data(), static_cast<int>(count), static_cast<int>(offset)) != SQLITE_OK) {
+                    errorMsg = sqlite3_errmsg(dbPtr);
+                    break;
+                }
+                offset += count;
+                if (vProgressFunctor && !vProgressFunctor(offset, size)) {
+                    canceled = true;
+                    break;
+                }
+            }
+        }
+        sqlite3_blob_close(blobPtr);
+    }
+    if (inSavepoint) {
+        if (errorMsg.empty() && !canceled) {
+            if (m_debugSqlite3Exec(__FUNCTION__, "RELEASE blob_load;") != SQLITE_OK) {
+                errorMsg = m_lastErrorMsg;
+            }
+        }
+        if (!errorMsg.empty() || canceled) {
+            (void)m_debugSqlite3Exec(__FUNCTION__, "ROLLBACK TO blob_load; RELEASE blob_load;");
+        }
+    }
+    if (vpOutErrorMsg != nullptr) {
+        *vpOutErrorMsg = errorMsg;
+    }
+    return errorMsg.empty() && !canceled;
+}
+
+// READ POOL
+
+ReadConnection DBHelper::acquireReadConnection() noexcept {
+    {
+        // the uncommitted changes of an open transaction are visible only from the writer.
+        // if the writer is busy we don't wait for it
+        std::unique_lock<std::recursive_mutex> lock(m_dbMutex, std::try_to_lock);
+        if (lock.owns_lock() && m_sqliteDb != nullptr && sqlite3_get_autocommit(m_sqliteDb.get()) == 0) {
+            return {};
+        }
+    }
+    std::lock_guard<std::mutex> poolLock(m_readPoolMutex);
+    if (!m_readPoolEnabled) {
+        return {};
+    }
+    if (!m_freeReadConnections.empty()) {
+        auto* dbPtr = m_freeReadConnections.back();
+        m_freeReadConnections.pop_back();
+        return ReadConnection(dbPtr, m_readPoolGeneration);
+    }
+    if (m_readConnectionsCount >= m_maxReadConnections) {
+        return {};
+    }
+    sqlite3* rawHandle = nullptr;
+    const auto flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX;
+    if (sqlite3_open_v2(m_readPoolFilePathName.c_str(), &rawHandle, flags, nullptr) != SQLITE_OK) {
+        sqlite3_close_v2(rawHandle);
+        return {};
+    }
+    sqlite3_busy_timeout(rawHandle, 1000);  // a reader can wait during a wal recovery
+    QueryProfiler::ref().attach(rawHandle);
+    ++m_readConnectionsCount;
+    return ReadConnection(rawHandle, m_readPoolGeneration);
+}
+
+bool DBHelper::isReadPoolEnabled() noexcept {
+    std::lock_guard<std::mutex> poolLock(m_readPoolMutex);
+    return m_readPoolEnabled;
+}
+
+void DBHelper::updateReadPoolState() noexcept {
+    std::lock_guard<std::recursive_mutex> lock(m_dbMutex);
+    bool walMode = false;
+    if (m_sqliteDb != nullptr) {
+        sqlite3_stmt* stmt = m_acquireStatement("PRAGMA journal_mode;", true);
+        if (stmt != nullptr && sqlite3_step(stmt) == SQLITE_ROW) {
+            const auto* mode = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            walMode = (mode != nullptr) && (sqlite3_stricmp(mode, "wal") == 0);
+        }
+        m_releaseStatement(stmt, true);
+    }
+    std::lock_guard<std::mutex> poolLock(m_readPoolMutex);
+    if (walMode != m_readPoolEnabled || (walMode && m_readPoolFilePathName != m_dataBaseFilePathName)) {
+        m_resetReadPool(walMode);
+    }
+}
+
+QueryResult DBHelper::executeReadQuery(const std::string& vSql, std::string* vpOutErrorMsg, const bool vCacheStatement) noexcept {
+    auto connection = acquireReadConnection();
+    if (!connection.isValid()) {
+        std::lock_guard<std::recursive_mutex> lock(m_dbMutex);
+        auto result = executeQuery(vSql, nullptr, vCacheStatement);
+        if (vpOutErrorMsg != nullptr) {
+            *vpOutErrorMsg = m_lastErrorMsg;
+        }
+        return result;
+    }
+    QueryResult result{};
+    std::string errorMsg;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(connection.get(), vSql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        errorMsg = sqlite3_errmsg(connection.get());
+    } else if (stmt != nullptr) {
+        result.columns = readColumnInfos(stmt);
+        auto rc = sqlite3_step(stmt);
+        while (rc == SQLITE_ROW) {
+            result.appendRow(stmt);
+            rc = sqlite3_step(stmt);
+        }
+        if (rc != SQLITE_DONE) {
+            errorMsg = sqlite3_errmsg(connection.get());
+        }
+    }
+    sqlite3_finalize(stmt);
+    if (vpOutErrorMsg != nullptr) {
+        *vpOutErrorMsg = errorMsg;
+    }
     return result;
 }
 
+bool DBHelper::isReadStatement(sqlite3_stmt* vStmt) noexcept {
+    if (vStmt == nullptr || sqlite3_stmt_readonly(vStmt) == 0 || sqlite3_column_count(vStmt) == 0) {
+        return false;  // BEGIN and COMMIT are read only but change the connection state
+    }
+    const char* pSql = sqlite3_sql(vStmt);
+    if (pSql == nullptr) {
+        return false;
+    }
+    pSql = m_skipBlankSql(pSql, pSql + std::strlen(pSql));
+    // pragmas are settings of the connection, they must be applied on the writer
+    return sqlite3_strnicmp(pSql, "PRAGMA", 6) != 0;
+}
+
+void DBHelper::interruptQuery() noexcept {
+    // not m_dbMutex, the running query hold it. sqlite3_interrupt is thread safe while the connection is open
+    std::lock_guard<std::mutex> lock(m_interruptMutex);
+    if (m_interruptDbPtr != nullptr) {
+        sqlite3_interrupt(m_interruptDbPtr);
+    }
+}
+
 // PRIVATE
 
+int32_t DBHelper::m_progressHandler(void* vpUserDatas) {
+    auto* pControl = static_cast<QueryControl*>(vpUserDatas);
+    if (pControl == nullptr) {
+        return 0;
+    }
+    if (pControl->cancelRequested) {
+        return 1;
+    }
+    if (pControl->timeoutMs > 0) {
+        const auto elapsed = std::chrono::steady_clock::now() - pControl->startTime;
+        if (std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() > pControl->timeoutMs) {
+            pControl->timedOut = true;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+const char* DBHelper::m_skipBlankSql(const char* vpSql, const char* vpEnd) noexcept {
+    const char* pCurrent = vpSql;
+    while (pCurrent < vpEnd) {
+        if (std::isspace(static_cast<unsigned char>(*pCurrent)) || *pCurrent == ';') {
+            ++pCurrent;
+        } else if (pCurrent + 1 < vpEnd && pCurrent[0] == '-' && pCurrent[1] == '-') {
+            while (pCurrent < vpEnd && *pCurrent != '\n') {
+                ++pCurrent;
+            }
+        } else if (pCurrent + 1 < vpEnd && pCurrent[0] == '/' && pCurrent[1] == '*') {
+            pCurrent += 2;
+            while (pCurrent + 1 < vpEnd && !(pCurrent[0] == '*' && pCurrent[1] == '/')) {
+                ++pCurrent;
+            }
+            pCurrent = std::min(pCurrent + 2, vpEnd);
+        } else {
+            break;
+        }
+    }
+    return pCurrent;
+}
+
 bool DBHelper::m_openDB() noexcept {
     if (m_sqliteDb != nullptr) {
         return true;
@@ -201,11 +1234,22 @@ bool DBHelper::m_openDB() noexcept {
         return false;
     }
 
-    m_sqliteDb.reset(rawHandle);
+    m_resetConnection(rawHandle);
+    QueryProfiler::ref().attach(rawHandle);
     (void)m_enableForeignKey();
+    updateReadPoolState();
     return true;
 }
 
+// the interrupt handle is cleared before the close, so interruptQuery never use a closed connection
+void DBHelper::m_resetConnection(sqlite3* vDbPtr) noexcept {
+    {
+        std::lock_guard<std::mutex> lock(m_interruptMutex);
+        m_interruptDbPtr = vDbPtr;
+    }
+    m_sqliteDb.reset(vDbPtr);
+}
+
 bool DBHelper::m_createDB() noexcept {
     m_closeDB();
 
@@ -222,15 +1266,24 @@ bool DBHelper::m_createDB() noexcept {
         return false;
     }
 
-    m_sqliteDb.reset(rawHandle);
+    m_resetConnection(rawHandle);
+    QueryProfiler::ref().attach(rawHandle);
     (void)m_enableForeignKey();
-    m_closeDB();  // keep behavior: close after creation
     return true;
 }
 
 void DBHelper::m_closeDB() noexcept {
     if (!m_transactionStarted) {
-        m_sqliteDb.reset();
+        // statements must be finalized before the close, else the connection become a zombie
+        m_clearStatementCache();
+        m_resetConnection(nullptr);
+        if (m_inMemory) {
+            // the datas are lost, it can't be reopened
+            m_inMemory = false;
+            m_dataBaseFilePathName.clear();
+        }
+        std::lock_guard<std::mutex> poolLock(m_readPoolMutex);
+        m_resetReadPool(false);
     }
 }
 
@@ -246,6 +1299,85 @@ bool DBHelper::m_enableForeignKey() noexcept {
     return true;
 }
 
+// the statement is reset and its bindings cleared, so the caller can bind and step it like a new one.
+// a user sql is rarely executed twice, in the LRU it would only evict the internal statements
+sqlite3_stmt* DBHelper::m_acquireStatement(const std::string& vSql, const bool vCached) noexcept {
+    if (!vCached) {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(m_sqliteDb.get(), vSql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            m_lastErrorMsg = sqlite3_errmsg(m_sqliteDb.get());
+            sqlite3_finalize(stmt);
+            return nullptr;
+        }
+        return stmt;  // null for an empty sql or only comments
+    }
+    auto it = m_cachedStatementsIndex.find(vSql);
+    if (it != m_cachedStatementsIndex.end()) {
+        m_cachedStatements.splice(m_cachedStatements.begin(), m_cachedStatements, it->second);
+        auto* stmt = it->second->second;
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        return stmt;
+    }
+    sqlite3_stmt* stmt = nullptr;
+    const auto rc = sqlite3_prepare_v3(m_sqliteDb.get(), vSql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        m_lastErrorMsg = sqlite3_errmsg(m_sqliteDb.get());
+        return nullptr;
+    }
+    if (stmt == nullptr) {  // empty sql or only comments
+        return nullptr;
+    }
+    m_cachedStatements.emplace_front(vSql, stmt);
+    m_cachedStatementsIndex[vSql] = m_cachedStatements.begin();
+    while (m_cachedStatements.size() > m_maxCachedStatements) {
+        auto& last = m_cachedStatements.back();
+        sqlite3_finalize(last.second);
+        m_cachedStatementsIndex.erase(last.first);
+        m_cachedStatements.pop_back();
+    }
+    return stmt;
+}
+
+// reset release the read/write locks held by the statement, it stay in cache for the next use
+void DBHelper::m_releaseStatement(sqlite3_stmt* vStmt, const bool vCached) noexcept {
+    if (!vCached) {
+        sqlite3_finalize(vStmt);
+    } else if (vStmt != nullptr) {
+        sqlite3_reset(vStmt);
+    }
+}
+
+void DBHelper::m_clearStatementCache() noexcept {
+    for (auto& cached : m_cachedStatements) {
+        sqlite3_finalize(cached.second);
+    }
+    m_cachedStatements.clear();
+    m_cachedStatementsIndex.clear();
+}
+
+void DBHelper::m_releaseReadConnection(sqlite3* vDbPtr, const uint32_t vGeneration) noexcept {
+    std::lock_guard<std::mutex> poolLock(m_readPoolMutex);
+    if (vGeneration == m_readPoolGeneration) {
+        m_freeReadConnections.push_back(vDbPtr);
+    } else {
+        // leased before a reset of the pool
+        sqlite3_close_v2(vDbPtr);
+    }
+}
+
+// m_readPoolMutex must be locked
+void DBHelper::m_resetReadPool(const bool vEnabled) noexcept {
+    for (auto* dbPtr : m_freeReadConnections) {
+        sqlite3_close_v2(dbPtr);
+    }
+    m_freeReadConnections.clear();
+    m_readConnectionsCount = 0U;
+    ++m_readPoolGeneration;
+    m_readPoolEnabled = vEnabled;
+    m_readPoolFilePathName = vEnabled ? m_dataBaseFilePathName : std::string();
+}
+
 int32_t DBHelper::m_debugSqlite3Exec(  //
     const std::string& vDebugLabel,    //
     const std::string& vSqlQuery) noexcept {
@@ -19,31 +19,164 @@
 
 #pragma once
 
-#include <variant>
 #include <cstdint>
 #include <memory>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <unordered_map>
 #include <ezlibs/ezClass.hpp>
 #include <ezlibs/ezSingleton.hpp>
+#include <headers/defs.h>
 
 struct sqlite3;
+struct sqlite3_stmt;
 
 // Rsultat gnrique de requte
 struct ColumnInfo {
     std::string name;
     std::string declType;  // Type dclar dans la table (peut tre vide)
+    // origin of the column, empty for an expression or if sqlite is built without SQLITE_ENABLE_COLUMN_METADATA
+    std::string originDatabase;
+    std::string originTable;
+    std::string originColumn;
 };
 
-struct Row {
-    std::vector<std::variant<int64_t, double, std::string, std::vector<uint8_t>, std::nullptr_t>> values;
+// the columns of a result holding the rowid of the origin table of each column, shared by the blocks of a cursor.
+// searched once, at the first value too big to be loaded or for locate a selected cell, in a worker.
+// the internal queries have none, so they never pay the search
+class RowidColumns {
+private:
+    std::string m_sql;
+    std::mutex m_searchMutex;
+    std::atomic<bool> m_isSearched{false};
+    std::vector<int32_t> m_rowidColumns;  // by result column, -1 if none. constant once searched
+
+public:
+    explicit RowidColumns(const std::string& vSql) : m_sql(vSql) {}
+    bool isSearched() const { return m_isSearched; }
+    int32_t get(const size_t vCol) const;  // -1 if none or not searched
+    void search(sqlite3* vDbPtr, const std::vector<ColumnInfo>& vColumns) noexcept;  // nothing if already searched
+};
+
+// where a cell is in the database, for access its blob with sqlite3_blob_open
+struct BlobLocator {
+    std::string database;
+    std::string table;
+    std::string column;
+    int64_t rowid{0};
+};
+
+enum class BlobReadStatus {  //
+    SUCCESS = 0,
+    BUSY,  // the writer is used by another thread, to retry later
+    FAILED
 };
 
+// the cells are stored by column : a type tag, a 8 bytes slot and a size per cell.
+// the slot contain the int64, the bits of the double, or the offset in the arena for the text and the blob.
+// the big blobs are not copied, only their size is kept, they are read on demand with their locator.
+// in the results of the user, only the start of a big text is copied if its cell can be located
 struct QueryResult {
+    static const size_t s_maxLoadedBlobSize;
+    static const size_t s_maxLoadedTextSize;
     std::vector<ColumnInfo> columns;
-    std::vector<Row> rows;
-    bool isValid() const { return (!columns.empty()) && (!rows.empty()); }
+    std::shared_ptr<RowidColumns> rowidColumns;  // only for the results of the user, else the cells are never located
+
+private:
+    struct ColumnDatas {
+        std::vector<SqliteType> types;
+        std::vector<int64_t> slots;
+        std::vector<uint32_t> sizes;  // bytes count of text and blob
+    };
+    std::vector<ColumnDatas> m_columnsDatas;
+    std::vector<char> m_arena;  // texts (zero terminated) and blobs
+    size_t m_rowsCount{0U};
+    bool m_capTexts{false};  // the internal queries need the whole texts
+
+public:
+    bool isValid() const { return (!columns.empty()) && (m_rowsCount > 0U); }
     void clear() { *this = QueryResult(); }
+
+    void reserve(const size_t vRowsCount);
+    void setCapTexts(const bool vCapTexts) { m_capTexts = vCapTexts; }  // before the first row
+    void appendRow(sqlite3_stmt* vStmt);  // read the current row of a stepped statement
+
+    size_t getRowsCount() const { return m_rowsCount; }
+    size_t getColumnsCount() const { return columns.size(); }
+    size_t getMemoryUsage() const;
+    SqliteType getType(const size_t vRow, const size_t vCol) const { return m_columnsDatas[vCol].types[vRow]; }
+    int64_t getInteger(const size_t vRow, const size_t vCol) const;
+    double getReal(const size_t vRow, const size_t vCol) const;
+    std::string_view getText(const size_t vRow, const size_t vCol) const;  // the start only if not loaded
+    bool isTextLoaded(const size_t vRow, const size_t vCol) const;
+    std::string_view getBlob(const size_t vRow, const size_t vCol) const;  // empty if not loaded
+    bool isBlobLoaded(const size_t vRow, const size_t vCol) const { return getSize(vRow, vCol) <= s_maxLoadedBlobSize; }
+    // the cell in its table, for read its blob or write a blob in it. false if the result has not the rowid,
+    // or if its rowid columns are not searched yet (see needRowidSearch)
+    bool getCellLocator(const size_t vRow, const size_t vCol, BlobLocator& vOutLocator) const;
+    bool needRowidSearch() const { return rowidColumns != nullptr && !rowidColumns->isSearched(); }
+    size_t getSize(const size_t vRow, const size_t vCol) const { return m_columnsDatas[vCol].sizes[vRow]; }
+
+private:
+    bool m_isLocated(const size_t vRow, const size_t vCol) const;
+    bool m_isLocated(sqlite3_stmt* vStmt, const size_t vCol);  // on the row not yet appended, search the rowid columns if needed
+};
+
+// result of one statement of a script
+struct StatementResult {
+    std::string sql;
+    size_t offset{0U};  // position of the statement in the script
+    double elapsedMs{0.0};
+    int64_t changesCount{0};  // rows modified by an INSERT, UPDATE or DELETE
+    QueryResult result;
+    std::string errorMsg;
+};
+
+struct ScriptResult {
+    std::vector<StatementResult> statements;
+    bool inTransaction{false};
+    bool isValid() const { return !statements.empty(); }
+    void clear() { *this = ScriptResult(); }
+};
+
+// cancel and timeout controls of a query, shared with the thread who want to stop it
+struct QueryControl {
+    std::atomic<bool> cancelRequested{false};
+    std::atomic<bool> timedOut{false};
+    std::atomic<size_t> rowsCount{0U};
+    int32_t timeoutMs{0};  // 0 => no timeout
+    std::chrono::steady_clock::time_point startTime{};
+    std::string errorMsg;
+    std::mutex connectionMutex;
+    sqlite3* connectionPtr{nullptr};  // connection running the query, set while the control is installed
+    void interrupt() noexcept;        // can be called from any thread
+};
+
+// a read only connection leased from the pool of DBHelper, given back at destruction.
+// a connection is used by one thread at a time, so they are opened without mutex
+class ReadConnection {
+private:
+    sqlite3* m_dbPtr{nullptr};
+    uint32_t m_generation{0U};  // generation of the pool at the lease
+
+public:
+    ReadConnection() = default;
+    ReadConnection(sqlite3* vDbPtr, const uint32_t vGeneration) : m_dbPtr(vDbPtr), m_generation(vGeneration) {}
+    ~ReadConnection() { release(); }
+    ReadConnection(ReadConnection&& vOther) noexcept;
+    ReadConnection& operator=(ReadConnection&& vOther) noexcept;
+    ReadConnection(const ReadConnection&) = delete;
+    ReadConnection& operator=(const ReadConnection&) = delete;
+
+    bool isValid() const { return m_dbPtr != nullptr; }
+    sqlite3* get() const { return m_dbPtr; }
+    void release() noexcept;
 };
 
 struct SqliteDbDeleter final {
@@ -51,18 +184,48 @@ struct SqliteDbDeleter final {
 };
 
 class DBHelper final {
+    friend class ReadConnection;
     IMPLEMENT_SINGLETON(DBHelper)
     DISABLE_CONSTRUCTORS(DBHelper)
     DISABLE_DESTRUCTORS(DBHelper)
 
 private:  // (static)
     static const int32_t m_maxInsertAttempts;
+    static const size_t m_maxCachedStatements;
+    static const size_t m_maxReadConnections;
+    static const int32_t m_backupPagesPerStep;
+    static const size_t m_blobChunkSize;
 
 private:  // (vars)
     std::unique_ptr<sqlite3, SqliteDbDeleter> m_sqliteDb{};
     std::string m_dataBaseFilePathName;
+    bool m_inMemory{false};
     bool m_transactionStarted{false};
     std::string m_lastErrorMsg{};
+    std::recursive_mutex m_dbMutex;  // the connection can be used by the query worker thread
+    // copy of the connection handle for interruptQuery, who can't wait m_dbMutex held by the running query
+    std::mutex m_interruptMutex;
+    sqlite3* m_interruptDbPtr{nullptr};
+
+    // LRU cache of prepared statements keyed by sql text, front is the most recently used
+    typedef std::list<std::pair<std::string, sqlite3_stmt*>> CachedStatements;
+    CachedStatements m_cachedStatements;
+    std::unordered_map<std::string, CachedStatements::iterator> m_cachedStatementsIndex;
+
+    // read only connections, enabled only for WAL databases where readers don't block the writer.
+    // lock order : m_dbMutex before m_readPoolMutex
+    std::mutex m_readPoolMutex;
+    std::vector<sqlite3*> m_freeReadConnections;
+    size_t m_readConnectionsCount{0U};  // free and leased
+    uint32_t m_readPoolGeneration{0U};  // incremented when the pool is reset, the old leases are closed at release
+    bool m_readPoolEnabled{false};
+    std::string m_readPoolFilePathName;
+
+public:
+    // called after each step of a backup with the remaining pages and the pages count, return false for cancel
+    typedef std::function<bool(const int32_t, const int32_t)> BackupProgressFunctor;
+    // bytes done and bytes count, return false for cancel
+    typedef std::function<bool(const size_t, const size_t)> BlobTransferProgressFunctor;
 
 public:  // (methods)
 
@@ -76,6 +239,17 @@ public:  // (methods)
     bool openDBFile(const std::string& vDBFilePathName) noexcept;
     void closeDBFile() noexcept;
 
+    // MEMORY
+    bool openMemoryDB() noexcept;  // close the current db and open an empty in memory db
+    bool isInMemory() const noexcept { return m_inMemory; }
+    // copy the db in a file, or a file in the in memory db, by chunks of pages with the backup api.
+    // the db is released between the chunks when it is copied in the file
+    bool backupWithFile(  //
+        const std::string& vFilePathName,
+        const bool vToFile,
+        const BackupProgressFunctor& vProgressFunctor,
+        std::string* vpOutErrorMsg = nullptr) noexcept;
+
     // TRANSACTIONS
     bool beginDBTransaction() noexcept;
     void commitDBTransaction() noexcept;
@@ -85,16 +259,79 @@ public:  // (methods)
     std::string getLastErrorMsg() const noexcept;
 
     // QUERY
-    QueryResult executeQuery(const std::string& vSql) noexcept;
+    // vCacheStatement : only for the internal sql executed often, the user sql is prepared and finalized each time
+    QueryResult executeQuery(const std::string& vSql, QueryControl* vpControl = nullptr, const bool vCacheStatement = false) noexcept;
+    void interruptQuery() noexcept;  // can be called from any thread
+
+    // SCRIPT
+    bool isScript(const std::string& vSql) noexcept;  // true if the sql contain more than one statement
+    // vInTransaction : all the statements are executed in one transaction, rollbacked on error
+    ScriptResult executeScript(const std::string& vSql, const bool vInTransaction, QueryControl* vpControl = nullptr) noexcept;
+
+    // CURSOR
+    // statement not cached, the caller must finalize it before the db is closed
+    sqlite3_stmt* prepareStatement(const std::string& vSql) noexcept;
+    std::recursive_mutex& getMutexRef() { return m_dbMutex; }
+    void installQueryControl(QueryControl* vpControl) noexcept;
+    void uninstallQueryControl(QueryControl* vpControl, const std::string& vErrorMsg) noexcept;
+    static void installQueryControl(sqlite3* vDbPtr, QueryControl* vpControl) noexcept;
+    static void uninstallQueryControl(sqlite3* vDbPtr, QueryControl* vpControl, const std::string& vErrorMsg) noexcept;
+    static std::vector<ColumnInfo> readColumnInfos(sqlite3_stmt* vStmt) noexcept;
+    // by result column, the column holding the rowid of its origin table, -1 if none
+    static std::vector<int32_t> searchRowidColumns(sqlite3* vDbPtr, const std::string& vSql, const std::vector<ColumnInfo>& vColumns) noexcept;
+    // on a read connection if possible, for locate a cell of a result already fetched
+    void searchRowidColumns(RowidColumns& vRowidColumns, const std::vector<ColumnInfo>& vColumns) noexcept;
+
+    // BLOB
+    // read vSize bytes at vOffset, on a read connection if possible. don't wait for the writer
+    BlobReadStatus readBlob(const BlobLocator& vLocator, const size_t vOffset, char* vBuffer, const size_t vSize, std::string* vpOutErrorMsg = nullptr) noexcept;
+    // the blob is streamed by chunks, it's never fully in memory. the file is removed on error or cancel
+    bool saveBlobToFile(  //
+        const BlobLocator& vLocator,
+        const std::string& vFilePathName,
+        const BlobTransferProgressFunctor& vProgressFunctor,
+        std::string* vpOutErrorMsg = nullptr) noexcept;
+    // the cell is replaced by a zeroblob of the file size, then the file is streamed in it by chunks.
+    // done in a savepoint, rollbacked on error or cancel
+    bool loadBlobFromFile(  //
+        const BlobLocator& vLocator,
+        const std::string& vFilePathName,
+        const BlobTransferProgressFunctor& vProgressFunctor,
+        std::string* vpOutErrorMsg = nullptr) noexcept;
+
+    // READ POOL
+    // invalid if the db is not in WAL mode, if the pool is full or if a transaction is open on the writer.
+    // in this case the writer connection must be used
+    ReadConnection acquireReadConnection() noexcept;
+    bool isReadPoolEnabled() noexcept;
+    void updateReadPoolState() noexcept;  // the journal mode can be changed by a query
+    // a SELECT executed on a read connection if possible, else on the writer
+    QueryResult executeReadQuery(const std::string& vSql, std::string* vpOutErrorMsg = nullptr, const bool vCacheStatement = false) noexcept;
+    // true if the statement can be executed on a read connection (read only, return rows, not a pragma)
+    static bool isReadStatement(sqlite3_stmt* vStmt) noexcept;
 
 protected:  // (methods)
 
 private:    // (methods)
+    static int32_t m_progressHandler(void* vpUserDatas);
+    static const char* m_skipBlankSql(const char* vpSql, const char* vpEnd) noexcept;  // spaces, comments and empty statements
+    static bool m_isRowidColumn(sqlite3* vDbPtr, const ColumnInfo& vColumn) noexcept;  // rowid or its INTEGER PRIMARY KEY alias
+    // count of the instances of a table in the statement (a self join, a subquery..), 0 if unknown
+    static size_t m_countTableInstances(sqlite3* vDbPtr, const std::string& vSql, const std::string& vDatabase, const std::string& vTable) noexcept;
     bool m_openDB() noexcept;
     void m_closeDB() noexcept;
+    void m_resetConnection(sqlite3* vDbPtr) noexcept;
     bool m_createDB() noexcept;
     bool m_enableForeignKey() noexcept;
 
+    // only the cached statements are prepared persistent and kept in the LRU
+    sqlite3_stmt* m_acquireStatement(const std::string& vSql, const bool vCached) noexcept;
+    void m_releaseStatement(sqlite3_stmt* vStmt, const bool vCached) noexcept;
+    void m_clearStatementCache() noexcept;
+
+    void m_releaseReadConnection(sqlite3* vDbPtr, const uint32_t vGeneration) noexcept;
+    void m_resetReadPool(const bool vEnabled) noexcept;
+
     int32_t m_debugSqlite3Exec(          //
         const std::string& vDebugLabel,  //
         const std::string& vSqlQuery) noexcept;
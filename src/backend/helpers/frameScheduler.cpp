@@ -0,0 +1,70 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "frameScheduler.h"
+
+#include <algorithm>
+
+const int32_t FrameScheduler::s_framesAfterInputs = 3;
+const double FrameScheduler::s_animatingTimeoutSec = 0.1;
+const double FrameScheduler::s_idleTimeoutSec = 2.0;
+
+bool FrameScheduler::init() {
+    m_requestedFramesCount = s_framesAfterInputs;
+    return true;
+}
+
+void FrameScheduler::unit() {
+    m_wakeUpFunctor = nullptr;
+}
+
+void FrameScheduler::requestFrames(const int32_t vCount) {
+    m_requestedFramesCount += vCount;
+    if (m_wakeUpFunctor) {
+        m_wakeUpFunctor();
+    }
+}
+
+void FrameScheduler::onInputs() {
+    int32_t count = m_requestedFramesCount;
+    while (count < s_framesAfterInputs && !m_requestedFramesCount.compare_exchange_weak(count, s_framesAfterInputs)) {
+    }
+}
+
+double FrameScheduler::getWaitTimeoutSec(const bool vBusy, const bool vAnimating) {
+    if (!m_eventDriven) {
+        return 0.0;
+    }
+    // only the ui thread decrement it, the others can only increment it
+    if (m_requestedFramesCount > 0) {
+        --m_requestedFramesCount;
+        return 0.0;
+    }
+    if (vBusy) {
+        return 1.0 / static_cast<double>(m_busyFps);
+    }
+    if (vAnimating) {
+        return s_animatingTimeoutSec;
+    }
+    return s_idleTimeoutSec;
+}
+
+void FrameScheduler::setBusyFps(const int32_t vFps) {
+    m_busyFps = std::clamp(vFps, 1, 240);
+}
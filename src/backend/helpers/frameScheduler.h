@@ -0,0 +1,65 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <ezlibs/ezClass.hpp>
+#include <ezlibs/ezSingleton.hpp>
+
+#include <functional>
+#include <cstdint>
+#include <atomic>
+
+// decide how long the ui thread can wait the events before drawing the next frame.
+// idle, it wait the inputs. while a background work run, it draw at a limited rate.
+// a background work finishing request a frame, who wake up the ui thread
+class FrameScheduler {
+    IMPLEMENT_SINGLETON(FrameScheduler)
+    DISABLE_CONSTRUCTORS(FrameScheduler)
+    DISABLE_DESTRUCTORS(FrameScheduler)
+
+public:
+    typedef std::function<void()> WakeUpFunctor;  // called from any thread
+
+private:
+    static const int32_t s_framesAfterInputs;  // imgui need some frames to settle after an input
+    static const double s_animatingTimeoutSec;  // text cursor blinking, tooltip delay, ..
+    static const double s_idleTimeoutSec;
+    std::atomic<int32_t> m_requestedFramesCount{0};
+    WakeUpFunctor m_wakeUpFunctor;
+    bool m_eventDriven{true};  // else a frame is drawn at each vsync
+    int32_t m_busyFps{30};
+
+public:
+    bool init();
+    void unit();
+
+    void setWakeUpFunctor(const WakeUpFunctor& vWakeUpFunctor) { m_wakeUpFunctor = vWakeUpFunctor; }
+
+    void requestFrames(const int32_t vCount = 1);  // thread safe, wake up the ui thread
+    void onInputs();  // to call by the ui thread when inputs was received
+
+    // 0 for no wait. vBusy if a background work is running, vAnimating if imgui need frames without inputs
+    double getWaitTimeoutSec(const bool vBusy, const bool vAnimating);
+
+    bool isEventDriven() const { return m_eventDriven; }
+    void setEventDriven(const bool vEventDriven) { m_eventDriven = vEventDriven; }
+    int32_t getBusyFps() const { return m_busyFps; }
+    void setBusyFps(const int32_t vFps);
+};
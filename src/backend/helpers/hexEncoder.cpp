@@ -0,0 +1,51 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hexEncoder.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HEX_ENCODER_SSE2
+#include <emmintrin.h>
+#endif
+
+void HexEncoder::encode(const uint8_t* vpSrc, const size_t vSize, char* vpDst) {
+    static const char s_digits[] = "0123456789abcdef";
+    size_t i = 0;
+#ifdef HEX_ENCODER_SSE2
+    // nibble n become '0' + n, plus 'a' - '0' - 10 if n > 9
+    const __m128i lowMask = _mm_set1_epi8(0x0F);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i zeroChar = _mm_set1_epi8('0');
+    const __m128i letterOffset = _mm_set1_epi8('a' - '0' - 10);
+    for (; i + 16U <= vSize; i += 16U) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vpSrc + i));
+        const __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), lowMask);
+        const __m128i low = _mm_and_si128(bytes, lowMask);
+        const __m128i highChars = _mm_add_epi8(_mm_add_epi8(high, zeroChar), _mm_and_si128(_mm_cmpgt_epi8(high, nine), letterOffset));
+        const __m128i lowChars = _mm_add_epi8(_mm_add_epi8(low, zeroChar), _mm_and_si128(_mm_cmpgt_epi8(low, nine), letterOffset));
+        // high nibble first for each byte
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(vpDst + i * 2U), _mm_unpacklo_epi8(highChars, lowChars));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(vpDst + i * 2U + 16U), _mm_unpackhi_epi8(highChars, lowChars));
+    }
+#endif
+    for (; i < vSize; ++i) {
+        vpDst[i * 2U] = s_digits[vpSrc[i] >> 4];
+        vpDst[i * 2U + 1U] = s_digits[vpSrc[i] & 0x0F];
+    }
+}
@@ -0,0 +1,153 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "imageDecoder.h"
+
+// the decoder of the thumbnails of ImGuiFileDialog. static, so it can't clash with the implementation of the dialog
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_NO_STDIO
+#define STBI_ONLY_PNG
+#define STBI_ONLY_JPEG
+#define STBI_ONLY_BMP
+#define STBI_MAX_DIMENSIONS 16384  // ImageDecoder::s_maxImageSize
+#include <3rdparty/imgui_imguifiledialog/stb/stb_image.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+const int32_t ImageDecoder::s_maxImageSize = 16384;
+const size_t ImageDecoder::s_maxPixelsCount = 64U * 1024U * 1024U;  // 256 MB in rgba
+
+static bool s_setError(std::string* vpOutErrorMsg, const char* vpMsg) {
+    if (vpOutErrorMsg != nullptr) {
+        *vpOutErrorMsg = (vpMsg != nullptr) ? vpMsg : "Failed to decode the image";
+    }
+    return false;
+}
+
+static bool s_isSizeValid(const int64_t vWidth, const int64_t vHeight) {
+    return vWidth > 0 && vHeight > 0 &&  //
+        vWidth <= ImageDecoder::s_maxImageSize && vHeight <= ImageDecoder::s_maxImageSize &&
+        static_cast<size_t>(vWidth) * static_cast<size_t>(vHeight) <= ImageDecoder::s_maxPixelsCount;
+}
+
+static uint32_t s_readLE32(const uint8_t* vpDatas) {
+    return static_cast<uint32_t>(vpDatas[0]) | (static_cast<uint32_t>(vpDatas[1]) << 8) |  //
+        (static_cast<uint32_t>(vpDatas[2]) << 16) | (static_cast<uint32_t>(vpDatas[3]) << 24);
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//// PUBLIC //////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////
+
+ImageDecoder::Format ImageDecoder::detectFormat(const uint8_t* vpDatas, const size_t vSize) {
+    static const uint8_t s_pngSignature[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+    if (vSize >= 8U && std::memcmp(vpDatas, s_pngSignature, 8U) == 0) {
+        return Format::PNG;
+    }
+    if (vSize >= 3U && vpDatas[0] == 0xFF && vpDatas[1] == 0xD8 && vpDatas[2] == 0xFF) {
+        return Format::JPEG;
+    }
+    if (vSize >= 18U && vpDatas[0] == 'B' && vpDatas[1] == 'M') {
+        const uint32_t headerSize = s_readLE32(vpDatas + 14);
+        if (headerSize == 12U || headerSize == 40U || headerSize == 52U || headerSize == 56U || headerSize == 64U || headerSize == 108U || headerSize == 124U) {
+            return Format::BMP;
+        }
+    }
+    return Format::NONE;
+}
+
+const char* ImageDecoder::getFormatName(const Format vFormat) {
+    switch (vFormat) {
+        case Format::PNG: return "PNG";
+        case Format::JPEG: return "JPEG";
+        case Format::BMP: return "BMP";
+        case Format::NONE:
+        default: break;
+    }
+    return "";
+}
+
+bool ImageDecoder::decode(const uint8_t* vpDatas, const size_t vSize, Image& vOutImage, std::string* vpOutErrorMsg) {
+    vOutImage = {};
+    const auto format = detectFormat(vpDatas, vSize);
+    if (format == Format::NONE) {
+        return s_setError(vpOutErrorMsg, "Unknown image format");
+    }
+    if (vSize > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        return s_setError(vpOutErrorMsg, "The image is too big for be previewed");
+    }
+    const auto size = static_cast<int>(vSize);
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    // the size is read from the header, the pixels are not allocated for a too big image
+    if (stbi_info_from_memory(vpDatas, size, &width, &height, &channels) == 0) {
+        return s_setError(vpOutErrorMsg, stbi_failure_reason());
+    }
+    if (!s_isSizeValid(width, height)) {
+        return s_setError(vpOutErrorMsg, (std::string(getFormatName(format)) + " too big for be previewed").c_str());
+    }
+    stbi_uc* pixels = stbi_load_from_memory(vpDatas, size, &width, &height, &channels, 4);
+    if (pixels == nullptr) {
+        return s_setError(vpOutErrorMsg, stbi_failure_reason());
+    }
+    vOutImage.width = width;
+    vOutImage.height = height;
+    vOutImage.rgba.assign(pixels, pixels + static_cast<size_t>(width) * static_cast<size_t>(height) * 4U);
+    stbi_image_free(pixels);
+    return true;
+}
+
+void ImageDecoder::downscale(Image& ioImage, const int32_t vMaxSize) {
+    const int32_t factor = (std::max(ioImage.width, ioImage.height) + vMaxSize - 1) / vMaxSize;
+    if (factor <= 1) {
+        return;
+    }
+    // each pixel is the average of a square of factor * factor pixels, or less on the right and bottom sides
+    const int32_t width = (ioImage.width + factor - 1) / factor;
+    const int32_t height = (ioImage.height + factor - 1) / factor;
+    std::vector<uint8_t> rgba(static_cast<size_t>(width) * static_cast<size_t>(height) * 4U);
+    for (int32_t y = 0; y < height; ++y) {
+        const int32_t y1 = std::min((y + 1) * factor, ioImage.height);
+        for (int32_t x = 0; x < width; ++x) {
+            const int32_t x1 = std::min((x + 1) * factor, ioImage.width);
+            uint32_t sums[4] = {};
+            for (int32_t sy = y * factor; sy < y1; ++sy) {
+                const uint8_t* pSrc = ioImage.rgba.data() + (static_cast<size_t>(sy) * static_cast<size_t>(ioImage.width) + static_cast<size_t>(x * factor)) * 4U;
+                for (int32_t sx = x * factor; sx < x1; ++sx, pSrc += 4) {
+                    sums[0] += pSrc[0];
+                    sums[1] += pSrc[1];
+                    sums[2] += pSrc[2];
+                    sums[3] += pSrc[3];
+                }
+            }
+            const auto count = static_cast<uint32_t>((y1 - y * factor) * (x1 - x * factor));
+            uint8_t* pDst = rgba.data() + (static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x)) * 4U;
+            for (int32_t c = 0; c < 4; ++c) {
+                pDst[c] = static_cast<uint8_t>((sums[c] + count / 2U) / count);
+            }
+        }
+    }
+    ioImage.width = width;
+    ioImage.height = height;
+    ioImage.rgba = std::move(rgba);
+}
@@ -0,0 +1,52 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// decoding of the images stored in blobs, by the stb_image shipped with ImGuiFileDialog.
+// only PNG, JPEG and BMP are accepted
+class ImageDecoder {
+public:
+    enum class Format {  //
+        NONE = 0,
+        PNG,
+        JPEG,
+        BMP
+    };
+    struct Image {
+        int32_t width{0};
+        int32_t height{0};
+        std::vector<uint8_t> rgba;  // 4 bytes per pixel, top row first
+    };
+    static const int32_t s_maxImageSize;  // in width and in height
+    static const size_t s_maxPixelsCount;
+
+public:
+    // by the signature, only the first bytes are needed
+    static Format detectFormat(const uint8_t* vpDatas, const size_t vSize);
+    static const char* getFormatName(const Format vFormat);
+    static bool decode(const uint8_t* vpDatas, const size_t vSize, Image& vOutImage, std::string* vpOutErrorMsg = nullptr);
+    // box filtered, the greatest side become at most vMaxSize
+    static void downscale(Image& ioImage, const int32_t vMaxSize);
+};
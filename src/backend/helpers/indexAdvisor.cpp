@@ -0,0 +1,382 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "indexAdvisor.h"
+
+#include <backend/helpers/dbHelper.h>
+
+#include <sqlite3/sqlite3.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+
+bool IndexAdvisor::init() {
+    return true;
+}
+
+void IndexAdvisor::unit() {
+    stop();
+    m_job.reset();
+}
+
+bool IndexAdvisor::start(const std::vector<std::string>& vQueries, const CompletionFunctor& vCompletionFunctor) {
+    if (m_job != nullptr || vQueries.empty()) {  // running, or its completion is not called yet
+        return false;
+    }
+    m_queries = vQueries;
+    m_advices.clear();
+    m_errorMsg.clear();
+    m_completionFunctor = vCompletionFunctor;
+    m_state = State::RUNNING;
+    m_job = JobManager::ref().pushJob(  //
+        Job::Priority::INTERACTIVE,
+        [this](Job& vJob) { m_run(vJob); },
+        [this](Job& /*vJob*/) { m_complete(); });
+    return true;
+}
+
+void IndexAdvisor::cancel() {
+    if (m_job != nullptr) {
+        m_job->cancel();
+    }
+}
+
+void IndexAdvisor::stop() {
+    cancel();
+    // a pending job will not run once canceled, a running one releases the lock at its end
+    std::lock_guard<std::mutex> lock(m_runMutex);
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//// PRIVATE /////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////
+
+void IndexAdvisor::m_run(Job& vJob) {
+    std::lock_guard<std::mutex> lock(m_runMutex);
+    if (vJob.isCancelRequested()) {  // canceled by stop() while it was pending
+        return;
+    }
+    sqlite3* scratchDbPtr = nullptr;
+    if (sqlite3_open_v2(":memory:", &scratchDbPtr, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK) {
+        m_errorMsg = (scratchDbPtr != nullptr) ? sqlite3_errmsg(scratchDbPtr) : "Failed to open the advisor db";
+        sqlite3_close(scratchDbPtr);
+        m_state = State::FAILED;
+        return;
+    }
+    if (m_copySchema(scratchDbPtr)) {
+        for (const auto& query : m_queries) {
+            for (const auto& statement : m_splitStatements(scratchDbPtr, query)) {
+                if (vJob.isCancelRequested()) {
+                    break;
+                }
+                IndexAdvice advice;
+                advice.sql = statement;
+                m_adviseStatement(scratchDbPtr, advice);
+                if (advice.beforePlan.isValid() || !advice.errorMsg.empty()) {
+                    m_advices.push_back(std::move(advice));
+                }
+            }
+        }
+    }
+    sqlite3_close(scratchDbPtr);
+    if (vJob.isCancelRequested()) {
+        m_errorMsg = "Index advisor canceled";
+        m_state = State::CANCELED;
+    } else {
+        m_state = m_errorMsg.empty() ? State::DONE : State::FAILED;
+    }
+}
+
+void IndexAdvisor::m_complete() {
+    m_job.reset();
+    if (m_state == State::RUNNING) {  // canceled before it runs
+        m_errorMsg = "Index advisor canceled";
+        m_state = State::CANCELED;
+    }
+    if (m_completionFunctor) {
+        m_completionFunctor(*this);
+    }
+}
+
+// the stats are needed for a planner choosing like on the database
+bool IndexAdvisor::m_copySchema(sqlite3* vScratchDb) {
+    const auto& schema = DBHelper::ref().executeReadQuery(  //
+        "SELECT sql FROM sqlite_schema WHERE sql IS NOT NULL AND type <> 'trigger' AND name NOT LIKE 'sqlite_%' "
+        "ORDER BY CASE type WHEN 'table' THEN 0 WHEN 'index' THEN 1 ELSE 2 END;",
+        &m_errorMsg);
+    if (!m_errorMsg.empty()) {
+        return false;
+    }
+    for (size_t r = 0; r < schema.getRowsCount(); ++r) {
+        // the virtual tables of an unknown module are lost, the statements using them will report an error
+        sqlite3_exec(vScratchDb, std::string(schema.getText(r, 0)).c_str(), nullptr, nullptr, nullptr);
+    }
+    std::string errorMsg;
+    const auto& stats = DBHelper::ref().executeReadQuery("SELECT tbl, idx, stat FROM sqlite_stat1;", &errorMsg);
+    if (errorMsg.empty() && stats.getRowsCount() > 0U) {
+        // ANALYZE create sqlite_stat1, the second one load the inserted stats
+        sqlite3_exec(vScratchDb, "ANALYZE sqlite_schema;", nullptr, nullptr, nullptr);
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(vScratchDb, "INSERT INTO sqlite_stat1(tbl, idx, stat) VALUES(?1, ?2, ?3);", -1, &stmt, nullptr) == SQLITE_OK) {
+            for (size_t r = 0; r < stats.getRowsCount(); ++r) {
+                for (int32_t c = 0; c < 3; ++c) {
+                    if (stats.getType(r, static_cast<size_t>(c)) == SqliteType::TYPE_NULL) {
+                        sqlite3_bind_null(stmt, c + 1);
+                    } else {
+                        const auto text = stats.getText(r, static_cast<size_t>(c));
+                        sqlite3_bind_text(stmt, c + 1, text.data(), static_cast<int>(text.size()), SQLITE_TRANSIENT);
+                    }
+                }
+                sqlite3_step(stmt);
+                sqlite3_reset(stmt);
+            }
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_exec(vScratchDb, "ANALYZE sqlite_schema;", nullptr, nullptr, nullptr);
+    }
+    return true;
+}
+
+// the statements are prepared on the copy, who has the same schema
+std::vector<std::string> IndexAdvisor::m_splitStatements(sqlite3* vScratchDb, const std::string& vSql) {
+    std::vector<std::string> ret;
+    const char* pSql = vSql.c_str();
+    const char* pEnd = pSql + vSql.size();
+    while (pSql < pEnd) {
+        while (pSql < pEnd && std::isspace(static_cast<unsigned char>(*pSql))) {
+            ++pSql;
+        }
+        if (pSql == pEnd) {
+            break;
+        }
+        sqlite3_stmt* stmt = nullptr;
+        const char* pTail = nullptr;
+        if (sqlite3_prepare_v2(vScratchDb, pSql, static_cast<int>(pEnd - pSql), &stmt, &pTail) != SQLITE_OK) {
+            // the end of the script is kept, its error will be reported by the advice
+            ret.emplace_back(pSql, pEnd);
+            break;
+        }
+        if (stmt != nullptr) {
+            ret.emplace_back(sqlite3_sql(stmt));
+            sqlite3_finalize(stmt);
+        }
+        if (pTail == nullptr || pTail <= pSql) {
+            break;
+        }
+        pSql = pTail;
+    }
+    return ret;
+}
+
+void IndexAdvisor::m_adviseStatement(sqlite3* vScratchDb, IndexAdvice& vOutAdvice) {
+    if (!QueryPlan::explain(vOutAdvice.sql, vOutAdvice.beforePlan, &vOutAdvice.errorMsg) || !vOutAdvice.beforePlan.isValid()) {
+        return;
+    }
+    auto candidates = m_getCandidates(vScratchDb, vOutAdvice);
+    if (!vOutAdvice.errorMsg.empty()) {
+        return;
+    }
+    // all the candidates are created at once, the planner choose between them
+    std::vector<Candidate> created;
+    for (auto& candidate : candidates) {
+        if (sqlite3_exec(vScratchDb, candidate.createSql.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK) {
+            created.push_back(std::move(candidate));
+        }
+    }
+    if (m_explain(vScratchDb, vOutAdvice.sql, vOutAdvice.afterPlan, vOutAdvice.errorMsg)) {
+        for (const auto& candidate : created) {
+            const auto pattern = "INDEX " + candidate.name;
+            for (const auto& node : vOutAdvice.afterPlan.nodes) {
+                const auto pos = node.detail.find(pattern);
+                const auto end = pos + pattern.size();
+                if (pos != std::string::npos && (end == node.detail.size() || node.detail[end] == ' ')) {
+                    vOutAdvice.createIndexes.push_back(candidate.createSql);
+                    break;
+                }
+            }
+        }
+    }
+    // the next statement is advised without them
+    for (const auto& candidate : created) {
+        sqlite3_exec(vScratchDb, ("DROP INDEX " + m_quoteId(candidate.name) + ";").c_str(), nullptr, nullptr, nullptr);
+    }
+}
+
+// a single column index for each column read by the statement, and the columns of the automatic indexes
+std::vector<IndexAdvisor::Candidate> IndexAdvisor::m_getCandidates(sqlite3* vScratchDb, IndexAdvice& vAdvice) {
+    std::map<std::string, std::vector<std::string>> readColumns;  // by table
+    sqlite3_set_authorizer(
+        vScratchDb,
+        [](void* vpUserDatas, int vAction, const char* vpTable, const char* vpColumn, const char* vpDatabase, const char*) -> int {
+            if (vAction == SQLITE_READ && vpTable != nullptr && vpColumn != nullptr && vpColumn[0] != '\0' &&  //
+                vpDatabase != nullptr && std::string(vpDatabase) == "main") {
+                auto& columns = (*static_cast<std::map<std::string, std::vector<std::string>>*>(vpUserDatas))[vpTable];
+                if (std::find(columns.begin(), columns.end(), vpColumn) == columns.end()) {
+                    columns.push_back(vpColumn);
+                }
+            }
+            return SQLITE_OK;
+        },
+        &readColumns);
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(vScratchDb, vAdvice.sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        vAdvice.errorMsg = sqlite3_errmsg(vScratchDb);
+    } else {
+        vAdvice.readOnly = (sqlite3_stmt_readonly(stmt) != 0);
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_set_authorizer(vScratchDb, nullptr, nullptr);
+    std::vector<std::pair<std::string, std::vector<std::string>>> wantedIndexes;
+    for (const auto& table : readColumns) {
+        for (const auto& column : table.second) {
+            wantedIndexes.push_back({table.first, {column}});
+        }
+    }
+    // "SEARCH b USING AUTOMATIC COVERING INDEX (a=? AND c=?)", b can be an alias
+    for (const auto& node : vAdvice.beforePlan.nodes) {
+        if (node.kind != QueryPlanNode::Kind::AUTO_INDEX || node.detail.compare(0, 7, "SEARCH ") != 0) {
+            continue;
+        }
+        const auto usingPos = node.detail.find(" USING ");
+        const auto openPos = node.detail.rfind('(');
+        const auto closePos = node.detail.rfind(')');
+        if (usingPos == std::string::npos || openPos == std::string::npos || closePos == std::string::npos || closePos < openPos) {
+            continue;
+        }
+        std::vector<std::string> columns;
+        const auto terms = node.detail.substr(openPos + 1U, closePos - openPos - 1U);
+        size_t start = 0U;
+        while (start < terms.size()) {
+            auto termEnd = terms.find(" AND ", start);
+            if (termEnd == std::string::npos) {
+                termEnd = terms.size();
+            }
+            const auto term = terms.substr(start, termEnd - start);
+            columns.push_back(term.substr(0, term.find_first_of("=<>")));
+            start = termEnd + 5U;
+        }
+        auto table = node.detail.substr(7U, usingPos - 7U);
+        if (readColumns.find(table) == readColumns.end()) {
+            for (const auto& readTable : readColumns) {
+                const auto& tableColumns = readTable.second;
+                if (std::all_of(columns.begin(), columns.end(), [&tableColumns](const std::string& vColumn) {
+                        return std::find(tableColumns.begin(), tableColumns.end(), vColumn) != tableColumns.end();
+                    })) {
+                    table = readTable.first;
+                    break;
+                }
+            }
+        }
+        if (columns.size() > 1U && readColumns.find(table) != readColumns.end()) {
+            wantedIndexes.push_back({table, columns});
+        }
+    }
+    std::vector<Candidate> ret;
+    std::map<std::string, std::vector<std::vector<std::string>>> existingIndexes;  // by table
+    for (const auto& wanted : wantedIndexes) {
+        auto it = existingIndexes.find(wanted.first);
+        if (it == existingIndexes.end()) {
+            it = existingIndexes.emplace(wanted.first, m_getIndexesColumns(vScratchDb, wanted.first)).first;
+        }
+        // an index starting by the same columns is already usable
+        const auto& columns = wanted.second;
+        if (std::any_of(it->second.begin(), it->second.end(), [&columns](const std::vector<std::string>& vIndexColumns) {
+                return vIndexColumns.size() >= columns.size() && std::equal(columns.begin(), columns.end(), vIndexColumns.begin());
+            })) {
+            continue;
+        }
+        it->second.push_back(columns);  // no duplicated candidates
+        Candidate candidate;
+        candidate.table = wanted.first;
+        candidate.columns = columns;
+        candidate.name = wanted.first + "_idx";
+        std::string columnsList;
+        for (const auto& column : columns) {
+            candidate.name += "_" + column;
+            if (!columnsList.empty()) {
+                columnsList += ", ";
+            }
+            columnsList += m_quoteId(column);
+        }
+        candidate.createSql = "CREATE INDEX " + m_quoteId(candidate.name) + " ON " + m_quoteId(candidate.table) + "(" + columnsList + ");";
+        ret.push_back(std::move(candidate));
+    }
+    return ret;
+}
+
+std::vector<std::vector<std::string>> IndexAdvisor::m_getIndexesColumns(sqlite3* vScratchDb, const std::string& vTable) {
+    std::vector<std::vector<std::string>> ret;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(  //
+            vScratchDb,
+            "SELECT il.name, ii.name FROM pragma_index_list(?1) AS il, pragma_index_info(il.name) AS ii ORDER BY il.name, ii.seqno;",
+            -1,
+            &stmt,
+            nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, vTable.c_str(), -1, SQLITE_TRANSIENT);
+        std::string lastIndexName;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            const auto* pIndexName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            const auto* pColumnName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            const std::string indexName = (pIndexName != nullptr) ? pIndexName : "";
+            if (ret.empty() || indexName != lastIndexName) {
+                ret.emplace_back();
+                lastIndexName = indexName;
+            }
+            ret.back().push_back((pColumnName != nullptr) ? pColumnName : "");  // empty for an expression
+        }
+    }
+    sqlite3_finalize(stmt);
+    return ret;
+}
+
+bool IndexAdvisor::m_explain(sqlite3* vScratchDb, const std::string& vSql, QueryPlan& vOutPlan, std::string& vOutErrorMsg) {
+    vOutPlan.sql = vSql;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(vScratchDb, ("EXPLAIN QUERY PLAN " + vSql).c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        vOutErrorMsg = sqlite3_errmsg(vScratchDb);
+        sqlite3_finalize(stmt);
+        return false;
+    }
+    std::vector<QueryPlanNode> rows;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        QueryPlanNode node;
+        node.id = sqlite3_column_int(stmt, 0);
+        node.parentId = sqlite3_column_int(stmt, 1);
+        const auto* pDetail = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+        node.detail = (pDetail != nullptr) ? pDetail : "";
+        rows.push_back(node);
+    }
+    sqlite3_finalize(stmt);
+    vOutPlan.setNodes(std::move(rows));
+    return true;
+}
+
+std::string IndexAdvisor::m_quoteId(const std::string& vId) {
+    std::string ret = "\"";
+    for (const auto c : vId) {
+        if (c == '"') {
+            ret += '"';
+        }
+        ret += c;
+    }
+    ret += '"';
+    return ret;
+}
@@ -0,0 +1,105 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <backend/managers/jobManager.h>
+
+#include <ezlibs/ezClass.hpp>
+#include <ezlibs/ezSingleton.hpp>
+
+#include <backend/helpers/queryPlan.h>
+
+#include <functional>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+struct sqlite3;
+
+// indexes advised for one statement
+struct IndexAdvice {
+    std::string sql;
+    bool readOnly{false};  // only a read only statement can be executed again to time it
+    QueryPlan beforePlan;  // on the database
+    QueryPlan afterPlan;  // with the candidate indexes
+    std::vector<std::string> createIndexes;  // the candidates used by the after plan
+    std::string errorMsg;
+};
+
+// advise indexes like the sqlite expert extension, in a job of the JobManager.
+// the schema and the stats are copied in an in memory db, the candidate indexes are created in it
+// from the columns read by the statement, and kept only if the planner use them
+class IndexAdvisor {
+    IMPLEMENT_SINGLETON(IndexAdvisor)
+    DISABLE_CONSTRUCTORS(IndexAdvisor)
+    DISABLE_DESTRUCTORS(IndexAdvisor)
+
+public:
+    enum class State {  //
+        IDLE = 0,
+        RUNNING,
+        DONE,
+        FAILED,
+        CANCELED
+    };
+    typedef std::function<void(IndexAdvisor&)> CompletionFunctor;  // called in the ui thread
+
+private:
+    struct Candidate {
+        std::string table;
+        std::vector<std::string> columns;
+        std::string name;
+        std::string createSql;
+    };
+    JobPtr m_job;
+    std::mutex m_runMutex;  // held by the job while it advises
+    std::atomic<State> m_state{State::IDLE};
+    std::vector<std::string> m_queries;
+    std::vector<IndexAdvice> m_advices;
+    std::string m_errorMsg;
+    CompletionFunctor m_completionFunctor;
+
+public:
+    bool init();
+    void unit();
+
+    // the scripts are splitted in statements, the statements without plan are ignored
+    bool start(const std::vector<std::string>& vQueries, const CompletionFunctor& vCompletionFunctor);
+    void cancel();
+    void stop();  // cancel and wait the end
+    bool isRunning() const { return m_state == State::RUNNING; }
+
+    State getState() const { return m_state; }
+    const std::vector<IndexAdvice>& getAdvices() const { return m_advices; }  // valid once finished
+    const std::string& getErrorMsg() const { return m_errorMsg; }  // valid once finished
+
+private:
+    void m_run(Job& vJob);
+    void m_complete();
+    bool m_copySchema(sqlite3* vScratchDb);
+    std::vector<std::string> m_splitStatements(sqlite3* vScratchDb, const std::string& vSql);
+    void m_adviseStatement(sqlite3* vScratchDb, IndexAdvice& vOutAdvice);
+    std::vector<Candidate> m_getCandidates(sqlite3* vScratchDb, IndexAdvice& vAdvice);
+    static std::vector<std::vector<std::string>> m_getIndexesColumns(sqlite3* vScratchDb, const std::string& vTable);
+    static bool m_explain(sqlite3* vScratchDb, const std::string& vSql, QueryPlan& vOutPlan, std::string& vOutErrorMsg);
+    static std::string m_quoteId(const std::string& vId);
+};
@@ -0,0 +1,492 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "jsonTree.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+const size_t JsonTree::s_maxSize = std::numeric_limits<uint32_t>::max();
+
+// element types of the jsonb format
+enum JsonbType : uint8_t {  //
+    JSONB_NULL = 0,
+    JSONB_TRUE,
+    JSONB_FALSE,
+    JSONB_INT,
+    JSONB_INT5,
+    JSONB_FLOAT,
+    JSONB_FLOAT5,
+    JSONB_TEXT,  // no escape
+    JSONB_TEXTJ,  // json escapes
+    JSONB_TEXT5,  // json5 escapes
+    JSONB_TEXTRAW,  // to escape for json
+    JSONB_ARRAY,
+    JSONB_OBJECT
+};
+
+static bool s_setError(std::string* vpOutErrorMsg, const char* vpMsg, const size_t vOffset) {
+    if (vpOutErrorMsg != nullptr) {
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer), "%s at offset %zu", vpMsg, vOffset);
+        *vpOutErrorMsg = buffer;
+    }
+    return false;
+}
+
+static bool s_isSpace(const char vChar) {
+    return vChar == ' ' || vChar == '\n' || vChar == '\r' || vChar == '\t';
+}
+
+// true if a byte of the word is vByte
+static uint64_t s_hasByte(const uint64_t vWord, const uint8_t vByte) {
+    const uint64_t x = vWord ^ (0x0101010101010101ULL * vByte);
+    return (x - 0x0101010101010101ULL) & ~x & 0x8080808080808080ULL;
+}
+
+static uint64_t s_readWord(const uint8_t* vpDatas) {
+    uint64_t ret;
+    std::memcpy(&ret, vpDatas, sizeof(ret));
+    return ret;
+}
+
+// the header is a type and a size in one byte, the size can be in the 1, 2, 4 or 8 next bytes
+static bool s_readJsonbHeader(const uint8_t* vpDatas, const size_t vOffset, const size_t vEnd, uint8_t& vOutType, size_t& vOutPayloadOffset, uint64_t& vOutPayloadSize) {
+    if (vOffset >= vEnd) {
+        return false;
+    }
+    const uint8_t header = vpDatas[vOffset];
+    vOutType = header & 0x0FU;
+    const uint8_t sizeCode = header >> 4U;
+    size_t sizeBytes = 0U;
+    switch (sizeCode) {
+        case 12U: sizeBytes = 1U; break;
+        case 13U: sizeBytes = 2U; break;
+        case 14U: sizeBytes = 4U; break;
+        case 15U: sizeBytes = 8U; break;
+        default: break;
+    }
+    if (vOutType > JSONB_OBJECT || sizeBytes > vEnd - vOffset - 1U) {
+        return false;
+    }
+    vOutPayloadSize = (sizeBytes == 0U) ? sizeCode : 0U;
+    for (size_t i = 0U; i < sizeBytes; ++i) {
+        vOutPayloadSize = (vOutPayloadSize << 8U) | vpDatas[vOffset + 1U + i];
+    }
+    vOutPayloadOffset = vOffset + 1U + sizeBytes;
+    return true;
+}
+
+static JsonTree::NodeType s_getJsonbNodeType(const uint8_t vJsonbType) {
+    switch (vJsonbType) {
+        case JSONB_NULL: return JsonTree::NodeType::NULL_VALUE;
+        case JSONB_TRUE: return JsonTree::NodeType::TRUE_VALUE;
+        case JSONB_FALSE: return JsonTree::NodeType::FALSE_VALUE;
+        case JSONB_INT:
+        case JSONB_INT5:
+        case JSONB_FLOAT:
+        case JSONB_FLOAT5: return JsonTree::NodeType::NUMBER;
+        case JSONB_TEXT:
+        case JSONB_TEXTJ:
+        case JSONB_TEXT5:
+        case JSONB_TEXTRAW: return JsonTree::NodeType::STRING;
+        case JSONB_ARRAY: return JsonTree::NodeType::ARRAY;
+        case JSONB_OBJECT: return JsonTree::NodeType::OBJECT;
+        default: break;
+    }
+    return JsonTree::NodeType::NONE;
+}
+
+// cut on a utf8 char start
+static void s_cutPreview(std::string& ioText, const size_t vMaxSize) {
+    if (ioText.size() > vMaxSize) {
+        size_t cut = vMaxSize;
+        while (cut > 0U && (static_cast<uint8_t>(ioText[cut]) & 0xC0U) == 0x80U) {
+            --cut;
+        }
+        ioText.resize(cut);
+        ioText += "...";
+    }
+}
+
+bool JsonTree::isJsonText(const std::string_view vText) {
+    for (const char c : vText) {
+        if (!s_isSpace(c)) {
+            return c == '{' || c == '[';
+        }
+    }
+    return false;
+}
+
+bool JsonTree::isJsonb(const uint8_t* vpDatas, const size_t vDatasSize, const size_t vBlobSize) {
+    uint8_t type = 0U;
+    size_t payloadOffset = 0U;
+    uint64_t payloadSize = 0U;
+    if (!s_readJsonbHeader(vpDatas, 0U, vDatasSize, type, payloadOffset, payloadSize)) {
+        return false;
+    }
+    return (type == JSONB_ARRAY || type == JSONB_OBJECT) && payloadOffset + payloadSize == vBlobSize;
+}
+
+bool JsonTree::build(const std::string_view vDatas, const Encoding vEncoding, std::string* vpOutErrorMsg) {
+    clear();
+    if (vDatas.size() > s_maxSize) {
+        return s_setError(vpOutErrorMsg, "The value is too big for the json view", s_maxSize);
+    }
+    m_datas = vDatas;
+    m_encoding = vEncoding;
+    if (vEncoding == Encoding::JSONB) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(m_datas.data());
+        uint8_t type = 0U;
+        size_t payloadOffset = 0U;
+        uint64_t payloadSize = 0U;
+        if (!s_readJsonbHeader(bytes, 0U, m_datas.size(), type, payloadOffset, payloadSize) ||  //
+            payloadOffset + payloadSize != m_datas.size()) {
+            clear();
+            return s_setError(vpOutErrorMsg, "Invalid jsonb header", 0U);
+        }
+        m_root.type = s_getJsonbNodeType(type);
+        m_root.valueJsonbType = type;
+        m_root.valueOffset = static_cast<uint32_t>(payloadOffset);
+        m_root.valueSize = static_cast<uint32_t>(payloadSize);
+        return true;
+    }
+    if (!m_buildTextIndex(vpOutErrorMsg)) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+void JsonTree::clear() {
+    m_datas = {};
+    m_encoding = Encoding::TEXT;
+    m_root = {};
+    m_containerStarts.clear();
+    m_containerStarts.shrink_to_fit();  // may be big
+    m_containerEnds.clear();
+    m_containerEnds.shrink_to_fit();
+    m_containerNexts.clear();
+    m_containerNexts.shrink_to_fit();
+}
+
+// only the strings and the brackets are looked at. the scalars are checked when their parent is expanded
+bool JsonTree::m_buildTextIndex(std::string* vpOutErrorMsg) {
+    const auto* begin = reinterpret_cast<const uint8_t*>(m_datas.data());
+    const auto* end = begin + m_datas.size();
+    const auto* cursor = begin;
+    std::vector<uint32_t> openeds;  // indexes in m_containerStarts
+    while (cursor < end) {
+        while (cursor < end && *cursor != '"' && *cursor != '{' && *cursor != '[' && *cursor != '}' && *cursor != ']') {
+            ++cursor;
+        }
+        if (cursor == end) {
+            break;
+        }
+        const auto offset = static_cast<uint32_t>(cursor - begin);
+        switch (*cursor) {
+            case '"': {
+                // the strings are the most of the bytes, they are skipped 8 bytes by 8
+                ++cursor;
+                for (;;) {
+                    while (end - cursor >= 8) {
+                        const uint64_t word = s_readWord(cursor);
+                        if (s_hasByte(word, '"') | s_hasByte(word, '\\')) {
+                            break;
+                        }
+                        cursor += 8;
+                    }
+                    while (cursor < end && *cursor != '"' && *cursor != '\\') {
+                        ++cursor;
+                    }
+                    if (cursor >= end || *cursor == '"') {
+                        break;
+                    }
+                    cursor += 2;  // the escaped char
+                }
+                if (cursor >= end) {
+                    return s_setError(vpOutErrorMsg, "Unclosed string", offset);
+                }
+                ++cursor;
+            } break;
+            case '{':
+            case '[': {
+                if (openeds.empty() && !m_containerStarts.empty()) {
+                    return s_setError(vpOutErrorMsg, "Unexpected value after the root", offset);
+                }
+                openeds.push_back(static_cast<uint32_t>(m_containerStarts.size()));
+                m_containerStarts.push_back(offset);
+                m_containerEnds.push_back(0U);
+                m_containerNexts.push_back(0U);
+                ++cursor;
+            } break;
+            default: {
+                const char opening = (*cursor == '}') ? '{' : '[';
+                if (openeds.empty() || begin[m_containerStarts[openeds.back()]] != opening) {
+                    return s_setError(vpOutErrorMsg, (opening == '{') ? "Unexpected }" : "Unexpected ]", offset);
+                }
+                m_containerEnds[openeds.back()] = offset;
+                m_containerNexts[openeds.back()] = static_cast<uint32_t>(m_containerStarts.size());
+                openeds.pop_back();
+                ++cursor;
+            } break;
+        }
+    }
+    if (!openeds.empty()) {
+        return s_setError(vpOutErrorMsg, "Unclosed object or array", m_containerStarts[openeds.back()]);
+    }
+    if (m_containerStarts.empty()) {
+        return s_setError(vpOutErrorMsg, "No object or array", 0U);
+    }
+    const size_t rootStart = m_containerStarts.front();
+    m_root.type = (begin[rootStart] == '{') ? NodeType::OBJECT : NodeType::ARRAY;
+    m_root.valueOffset = static_cast<uint32_t>(rootStart);
+    m_root.valueSize = m_containerEnds.front() + 1U - m_root.valueOffset;
+    m_root.containerIdx = 0U;
+    return true;
+}
+
+size_t JsonTree::m_skipSpaces(size_t vOffset, const size_t vEnd) const {
+    while (vOffset < vEnd && s_isSpace(m_datas[vOffset])) {
+        ++vOffset;
+    }
+    return vOffset;
+}
+
+size_t JsonTree::m_findStringEnd(const size_t vOffset) const {
+    const char* begin = m_datas.data();
+    const char* end = begin + m_datas.size();
+    const char* cursor = begin + vOffset + 1U;
+    while (cursor < end) {
+        const auto* quote = static_cast<const char*>(std::memchr(cursor, '"', static_cast<size_t>(end - cursor)));
+        if (quote == nullptr) {
+            break;
+        }
+        // escaped if after an odd count of backslashes
+        const char* backslashes = quote;
+        while (backslashes > begin + vOffset + 1U && backslashes[-1] == '\\') {
+            --backslashes;
+        }
+        if (((quote - backslashes) & 1) == 0) {
+            return static_cast<size_t>(quote - begin) + 1U;
+        }
+        cursor = quote + 1;
+    }
+    return std::string::npos;
+}
+
+bool JsonTree::getChildren(const Node& vNode, std::vector<Node>& vOutChildren, std::string* vpOutErrorMsg) const {
+    vOutChildren.clear();
+    if (!vNode.isContainer()) {
+        return true;
+    }
+    if (m_encoding == Encoding::JSONB) {
+        return m_getJsonbChildren(vNode, vOutChildren, vpOutErrorMsg);
+    }
+    return m_getTextChildren(vNode, vOutChildren, vpOutErrorMsg);
+}
+
+// the nested containers are jumped with the index, so only the bytes of this level are read.
+// the first nested container follow its parent in the index, and the next one is after its own nested ones
+bool JsonTree::m_getTextChildren(const Node& vNode, std::vector<Node>& vOutChildren, std::string* vpOutErrorMsg) const {
+    const bool isObject = (vNode.type == NodeType::OBJECT);
+    const size_t end = vNode.valueOffset + vNode.valueSize - 1U;  // on the } or ]
+    size_t cursor = m_skipSpaces(vNode.valueOffset + 1U, end);
+    size_t nextContainerIdx = vNode.containerIdx + 1U;  // the first nested one
+    while (cursor < end) {
+        Node child;
+        if (isObject) {
+            if (m_datas[cursor] != '"') {
+                return s_setError(vpOutErrorMsg, "Key expected", cursor);
+            }
+            const size_t keyEnd = m_findStringEnd(cursor);
+            if (keyEnd == std::string::npos || keyEnd > end) {
+                return s_setError(vpOutErrorMsg, "Unclosed key", cursor);
+            }
+            child.hasKey = true;
+            child.keyOffset = static_cast<uint32_t>(cursor);
+            child.keySize = static_cast<uint32_t>(keyEnd - cursor);
+            cursor = m_skipSpaces(keyEnd, end);
+            if (cursor >= end || m_datas[cursor] != ':') {
+                return s_setError(vpOutErrorMsg, "':' expected", cursor);
+            }
+            cursor = m_skipSpaces(cursor + 1U, end);
+            if (cursor >= end) {
+                return s_setError(vpOutErrorMsg, "Value expected", cursor);
+            }
+        }
+        size_t valueEnd = std::string::npos;
+        const char c = m_datas[cursor];
+        if (c == '{' || c == '[') {
+            if (nextContainerIdx >= m_containerStarts.size() || m_containerStarts[nextContainerIdx] != cursor) {
+                return s_setError(vpOutErrorMsg, "Unindexed value", cursor);
+            }
+            child.type = (c == '{') ? NodeType::OBJECT : NodeType::ARRAY;
+            child.containerIdx = static_cast<uint32_t>(nextContainerIdx);
+            valueEnd = m_containerEnds[nextContainerIdx] + 1U;
+            nextContainerIdx = m_containerNexts[nextContainerIdx];
+        } else if (c == '"') {
+            child.type = NodeType::STRING;
+            valueEnd = m_findStringEnd(cursor);
+        } else {
+            switch (c) {
+                case 't': child.type = NodeType::TRUE_VALUE; break;
+                case 'f': child.type = NodeType::FALSE_VALUE; break;
+                case 'n': child.type = NodeType::NULL_VALUE; break;
+                default: child.type = NodeType::NUMBER; break;
+            }
+            valueEnd = cursor;
+            while (valueEnd < end && m_datas[valueEnd] != ',' && !s_isSpace(m_datas[valueEnd])) {
+                ++valueEnd;
+            }
+            if (valueEnd == cursor) {
+                return s_setError(vpOutErrorMsg, "Value expected", cursor);
+            }
+        }
+        if (valueEnd == std::string::npos || valueEnd > end) {
+            return s_setError(vpOutErrorMsg, "Invalid value", cursor);
+        }
+        child.valueOffset = static_cast<uint32_t>(cursor);
+        child.valueSize = static_cast<uint32_t>(valueEnd - cursor);
+        vOutChildren.push_back(child);
+        cursor = m_skipSpaces(valueEnd, end);
+        if (cursor < end) {
+            if (m_datas[cursor] != ',') {
+                return s_setError(vpOutErrorMsg, "',' expected", cursor);
+            }
+            cursor = m_skipSpaces(cursor + 1U, end);
+            if (cursor >= end) {
+                return s_setError(vpOutErrorMsg, "Value expected", cursor);
+            }
+        }
+    }
+    return true;
+}
+
+// the payload of an array is its elements, the payload of an object is its keys and values one after the other
+bool JsonTree::m_getJsonbChildren(const Node& vNode, std::vector<Node>& vOutChildren, std::string* vpOutErrorMsg) const {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(m_datas.data());
+    const bool isObject = (vNode.type == NodeType::OBJECT);
+    const size_t end = static_cast<size_t>(vNode.valueOffset) + vNode.valueSize;
+    size_t cursor = vNode.valueOffset;
+    while (cursor < end) {
+        Node child;
+        uint8_t type = 0U;
+        size_t payloadOffset = 0U;
+        uint64_t payloadSize = 0U;
+        if (isObject) {
+            if (!s_readJsonbHeader(bytes, cursor, end, type, payloadOffset, payloadSize) || payloadSize > end - payloadOffset) {
+                return s_setError(vpOutErrorMsg, "Invalid jsonb key", cursor);
+            }
+            if (s_getJsonbNodeType(type) != NodeType::STRING) {
+                return s_setError(vpOutErrorMsg, "The jsonb key is not a string", cursor);
+            }
+            child.hasKey = true;
+            child.keyJsonbType = type;
+            child.keyOffset = static_cast<uint32_t>(payloadOffset);
+            child.keySize = static_cast<uint32_t>(payloadSize);
+            cursor = payloadOffset + static_cast<size_t>(payloadSize);
+            if (cursor >= end) {
+                return s_setError(vpOutErrorMsg, "Jsonb value expected", cursor);
+            }
+        }
+        if (!s_readJsonbHeader(bytes, cursor, end, type, payloadOffset, payloadSize) || payloadSize > end - payloadOffset) {
+            return s_setError(vpOutErrorMsg, "Invalid jsonb element", cursor);
+        }
+        child.type = s_getJsonbNodeType(type);
+        child.valueJsonbType = type;
+        child.valueOffset = static_cast<uint32_t>(payloadOffset);
+        child.valueSize = static_cast<uint32_t>(payloadSize);
+        vOutChildren.push_back(child);
+        cursor = payloadOffset + static_cast<size_t>(payloadSize);
+    }
+    return true;
+}
+
+std::string JsonTree::getKeyPreview(const Node& vNode, const size_t vMaxSize) const {
+    if (!vNode.hasKey) {
+        return {};
+    }
+    if (m_encoding == Encoding::JSONB) {
+        return m_getPayloadPreview(vNode.keyJsonbType, vNode.keyOffset, vNode.keySize, vMaxSize);
+    }
+    std::string ret(m_datas.substr(vNode.keyOffset, std::min<size_t>(vNode.keySize, vMaxSize + 1U)));
+    s_cutPreview(ret, vMaxSize);
+    return ret;
+}
+
+std::string JsonTree::getValuePreview(const Node& vNode, const size_t vMaxSize) const {
+    if (vNode.type == NodeType::OBJECT) {
+        return "{...}";
+    } else if (vNode.type == NodeType::ARRAY) {
+        return "[...]";
+    } else if (m_encoding == Encoding::JSONB) {
+        return m_getPayloadPreview(vNode.valueJsonbType, vNode.valueOffset, vNode.valueSize, vMaxSize);
+    }
+    std::string ret(m_datas.substr(vNode.valueOffset, std::min<size_t>(vNode.valueSize, vMaxSize + 1U)));
+    s_cutPreview(ret, vMaxSize);
+    return ret;
+}
+
+// the scalars of a jsonb are stored as text. the strings are quoted, and escaped if not done in the payload
+std::string JsonTree::m_getPayloadPreview(const uint8_t vJsonbType, const size_t vOffset, const size_t vSize, const size_t vMaxSize) const {
+    const auto payload = m_datas.substr(vOffset, std::min(vSize, vMaxSize + 1U));
+    std::string ret;
+    switch (vJsonbType) {
+        case JSONB_NULL: return "null";
+        case JSONB_TRUE: return "true";
+        case JSONB_FALSE: return "false";
+        case JSONB_TEXTJ:
+        case JSONB_TEXT5:
+            ret += '"';
+            ret += payload;
+            break;
+        case JSONB_TEXT:
+        case JSONB_TEXTRAW:
+            ret += '"';
+            for (const char c : payload) {
+                switch (c) {
+                    case '"': ret += "\\\""; break;
+                    case '\\': ret += "\\\\"; break;
+                    case '\n': ret += "\\n"; break;
+                    case '\r': ret += "\\r"; break;
+                    case '\t': ret += "\\t"; break;
+                    default:
+                        if (static_cast<uint8_t>(c) < 0x20U) {
+                            char buffer[8];
+                            snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+                            ret += buffer;
+                        } else {
+                            ret += c;
+                        }
+                        break;
+                }
+            }
+            break;
+        default: ret = payload; break;
+    }
+    if (ret.size() > vMaxSize) {
+        s_cutPreview(ret, vMaxSize);
+    } else if (vJsonbType >= JSONB_TEXT && vJsonbType <= JSONB_TEXTRAW) {
+        ret += '"';
+    }
+    return ret;
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// lazy tree of a json text, or of a jsonb blob (the binary json of sqlite 3.45+).
+// for a text, a single pass index the bounds of the objects and arrays, and the children of a node
+// are found only when it's expanded. a jsonb give the size of each element in its header, so it's read as is.
+// the datas are not copied, they must live with the tree
+class JsonTree {
+public:
+    enum class Encoding {  //
+        TEXT = 0,
+        JSONB
+    };
+    enum class NodeType {  //
+        NONE = 0,
+        OBJECT,
+        ARRAY,
+        STRING,
+        NUMBER,
+        TRUE_VALUE,
+        FALSE_VALUE,
+        NULL_VALUE
+    };
+    struct Node {
+        NodeType type{NodeType::NONE};
+        uint8_t valueJsonbType{0U};  // for the rendering of a jsonb payload
+        uint8_t keyJsonbType{0U};
+        bool hasKey{false};  // member of an object
+        uint32_t keyOffset{0U};  // the quoted key for a text, the payload for a jsonb
+        uint32_t keySize{0U};
+        uint32_t valueOffset{0U};  // the whole value for a text, the payload for a jsonb
+        uint32_t valueSize{0U};
+        uint32_t containerIdx{0U};  // in the index of a text
+        bool isContainer() const { return type == NodeType::OBJECT || type == NodeType::ARRAY; }
+    };
+    static const size_t s_maxSize;  // the offsets are on 32 bits
+
+private:
+    std::string_view m_datas;
+    Encoding m_encoding{Encoding::TEXT};
+    Node m_root;
+    std::vector<uint32_t> m_containerStarts;  // offsets of the { and [ of a text, in order
+    std::vector<uint32_t> m_containerEnds;  // offsets of the matching } and ]
+    std::vector<uint32_t> m_containerNexts;  // index of the next container after the nested ones
+
+public:
+    // an object or an array, the value of a cell as a scalar is not worth a tree
+    static bool isJsonText(const std::string_view vText);
+    // the first bytes are enough, the header must give the full size of the blob
+    static bool isJsonb(const uint8_t* vpDatas, const size_t vDatasSize, const size_t vBlobSize);
+
+    bool build(const std::string_view vDatas, const Encoding vEncoding, std::string* vpOutErrorMsg = nullptr);
+    void clear();
+    bool isEmpty() const { return m_root.type == NodeType::NONE; }
+    const Node& getRoot() const { return m_root; }
+    size_t getContainersCount() const { return m_containerStarts.size(); }
+    // the children found before an error are kept
+    bool getChildren(const Node& vNode, std::vector<Node>& vOutChildren, std::string* vpOutErrorMsg = nullptr) const;
+    // on one line, cut after about vMaxSize bytes
+    std::string getKeyPreview(const Node& vNode, const size_t vMaxSize) const;
+    std::string getValuePreview(const Node& vNode, const size_t vMaxSize) const;
+
+private:
+    bool m_buildTextIndex(std::string* vpOutErrorMsg);
+    size_t m_skipSpaces(size_t vOffset, const size_t vEnd) const;
+    size_t m_findStringEnd(const size_t vOffset) const;  // after the closing quote, npos if not closed
+    bool m_getTextChildren(const Node& vNode, std::vector<Node>& vOutChildren, std::string* vpOutErrorMsg) const;
+    bool m_getJsonbChildren(const Node& vNode, std::vector<Node>& vOutChildren, std::string* vpOutErrorMsg) const;
+    std::string m_getPayloadPreview(const uint8_t vJsonbType, const size_t vOffset, const size_t vSize, const size_t vMaxSize) const;
+};
@@ -0,0 +1,260 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "queryCursor.h"
+
+#include <sqlite3/sqlite3.hpp>
+
+const size_t QueryCursor::s_blockSize = 256U;
+const size_t QueryCursor::s_maxWindowBlocks = 32U;
+
+QueryCursor::~QueryCursor() {
+    close();
+}
+
+bool QueryCursor::open(const std::string& vSql) {
+    close();
+    m_readConnection = DBHelper::ref().acquireReadConnection();
+    if (m_readConnection.isValid()) {
+        if (sqlite3_prepare_v2(m_readConnection.get(), vSql.c_str(), -1, &m_stmt, nullptr) != SQLITE_OK ||  //
+            !DBHelper::isReadStatement(m_stmt)) {
+            // writes and errors are for the writer connection
+            sqlite3_finalize(m_stmt);
+            m_stmt = nullptr;
+            m_readConnection.release();
+        }
+    }
+    if (m_stmt == nullptr) {
+        m_stmt = DBHelper::ref().prepareStatement(vSql);
+    }
+    if (m_stmt == nullptr) {
+        m_lastErrorMsg = DBHelper::ref().getLastErrorMsg();
+        return false;
+    }
+    m_columns = DBHelper::readColumnInfos(m_stmt);
+    m_rowidColumns = std::make_shared<RowidColumns>(vSql);  // searched only if a big value must be located
+    return true;
+}
+
+void QueryCursor::open(QueryResult&& vResult) {
+    close();
+    m_columns = vResult.columns;
+    m_rowidColumns = vResult.rowidColumns;
+    m_nextRowIdx = vResult.getRowsCount();
+    m_exhausted = true;
+    m_detached = true;
+    m_detachedResult = std::move(vResult);
+}
+
+void QueryCursor::close() {
+    if (m_stmt != nullptr) {
+        std::unique_lock<std::recursive_mutex> lock(DBHelper::ref().getMutexRef(), std::defer_lock);
+        if (!m_readConnection.isValid()) {
+            lock.lock();
+        }
+        sqlite3_finalize(m_stmt);
+        m_stmt = nullptr;
+    }
+    m_readConnection.release();
+    m_columns.clear();
+    m_rowidColumns.reset();
+    m_window.clear();
+    m_firstBlockIdx = 0U;
+    m_nextRowIdx = 0U;
+    m_exhausted = false;
+    m_detached = false;
+    m_detachedResult.clear();
+    m_lastErrorMsg.clear();
+    m_batch = Batch();
+}
+
+bool QueryCursor::fetch(const size_t vStart, const size_t vEnd, QueryControl* vpControl) {
+    readBlocks(vStart, vEnd, vpControl);
+    return applyBlocks();
+}
+
+bool QueryCursor::materialize(QueryControl* vpControl) {
+    if (m_stmt == nullptr || m_detached) {
+        return m_lastErrorMsg.empty();
+    }
+    QueryResult result;
+    result.columns = m_columns;
+    result.rowidColumns = m_rowidColumns;
+    result.setCapTexts(true);
+    std::unique_lock<std::recursive_mutex> lock(DBHelper::ref().getMutexRef(), std::defer_lock);
+    if (!m_readConnection.isValid()) {
+        lock.lock();
+    }
+    auto* dbPtr = sqlite3_db_handle(m_stmt);
+    DBHelper::installQueryControl(dbPtr, vpControl);
+    while (true) {
+        const auto rc = sqlite3_step(m_stmt);
+        if (rc != SQLITE_ROW) {
+            if (rc != SQLITE_DONE) {
+                m_lastErrorMsg = sqlite3_errmsg(dbPtr);
+            }
+            break;
+        }
+        if (!m_columns.empty()) {
+            result.appendRow(m_stmt);
+        }
+        if (vpControl != nullptr) {
+            ++vpControl->rowsCount;
+        }
+    }
+    DBHelper::uninstallQueryControl(dbPtr, vpControl, m_lastErrorMsg);
+    sqlite3_finalize(m_stmt);
+    m_stmt = nullptr;
+    m_readConnection.release();
+    m_window.clear();
+    m_firstBlockIdx = 0U;
+    m_nextRowIdx = result.getRowsCount();
+    m_exhausted = true;
+    m_detached = true;
+    m_detachedResult = std::move(result);
+    return m_lastErrorMsg.empty();
+}
+
+bool QueryCursor::needFetch(const size_t vStart, const size_t vEnd) const {
+    if (vEnd <= vStart || m_detached || m_stmt == nullptr) {
+        return false;
+    }
+    if (vStart >= m_getWindowStart() && (vEnd <= m_nextRowIdx || m_exhausted)) {
+        return false;  // already in the window, or nothing more to fetch
+    }
+    return true;
+}
+
+void QueryCursor::readBlocks(const size_t vStart, const size_t vEnd, QueryControl* vpControl) {
+    m_batch = Batch();
+    m_batch.isRead = true;
+    m_batch.nextRowIdx = m_nextRowIdx;
+    m_batch.exhausted = m_exhausted;
+    if (!needFetch(vStart, vEnd)) {
+        return;
+    }
+    std::unique_lock<std::recursive_mutex> lock(DBHelper::ref().getMutexRef(), std::defer_lock);
+    if (!m_readConnection.isValid()) {  // a read connection is used only by this cursor
+        lock.lock();
+    }
+    if (vStart < m_getWindowStart()) {
+        // the rows before the window are read again. only for the read only statements, the others are materialized
+        sqlite3_reset(m_stmt);
+        m_batch.replaceWindow = true;
+        m_batch.nextRowIdx = 0U;
+        m_batch.exhausted = false;
+    }
+    const size_t firstBlock = vStart / s_blockSize;
+    size_t endBlock = (vEnd + s_blockSize - 1U) / s_blockSize;
+    if (endBlock - firstBlock > s_maxWindowBlocks) {
+        endBlock = firstBlock + s_maxWindowBlocks;
+    }
+    // blocks before firstBlock are kept only if the window have room for them
+    const size_t backwardMargin = s_maxWindowBlocks - (endBlock - firstBlock);
+    auto* dbPtr = sqlite3_db_handle(m_stmt);
+    DBHelper::installQueryControl(dbPtr, vpControl);
+    auto& blocks = m_batch.blocks;
+    while (!m_batch.exhausted && m_batch.nextRowIdx < endBlock * s_blockSize) {
+        const auto rc = sqlite3_step(m_stmt);
+        if (rc == SQLITE_ROW) {
+            const size_t blockIdx = m_batch.nextRowIdx / s_blockSize;
+            if (blockIdx + backwardMargin < firstBlock) {
+                // this block will be out of the window, we skip it
+                m_batch.replaceWindow = true;
+                blocks.clear();
+            } else {
+                if (blocks.empty() || m_batch.firstBlockIdx + blocks.size() <= blockIdx) {
+                    if (blocks.empty()) {
+                        m_batch.firstBlockIdx = blockIdx;
+                    }
+                    blocks.emplace_back();
+                    blocks.back().columns = m_columns;
+                    blocks.back().rowidColumns = m_rowidColumns;
+                    blocks.back().setCapTexts(true);  // the big texts are read on demand by the value viewer
+                    blocks.back().reserve(s_blockSize);
+                }
+                blocks.back().appendRow(m_stmt);
+                if (blocks.size() > s_maxWindowBlocks) {
+                    blocks.pop_front();
+                    ++m_batch.firstBlockIdx;
+                }
+            }
+            ++m_batch.nextRowIdx;
+            if (vpControl != nullptr) {
+                ++vpControl->rowsCount;
+            }
+        } else {
+            if (rc != SQLITE_DONE) {
+                m_batch.errorMsg = sqlite3_errmsg(dbPtr);
+            }
+            m_batch.exhausted = true;
+            // release the read lock held by the statement, the window is kept
+            sqlite3_reset(m_stmt);
+        }
+    }
+    DBHelper::uninstallQueryControl(dbPtr, vpControl, m_batch.errorMsg);
+}
+
+bool QueryCursor::applyBlocks() {
+    if (!m_batch.isRead) {
+        return m_lastErrorMsg.empty();  // readBlocks was not called, the fetch was canceled before
+    }
+    if (m_batch.replaceWindow) {
+        m_window.clear();
+    }
+    for (auto& block : m_batch.blocks) {
+        if (m_window.empty()) {
+            m_firstBlockIdx = m_batch.firstBlockIdx;
+        }
+        m_window.push_back(std::move(block));
+        if (m_window.size() > s_maxWindowBlocks) {
+            m_window.pop_front();
+            ++m_firstBlockIdx;
+        }
+    }
+    m_nextRowIdx = m_batch.nextRowIdx;
+    m_exhausted = m_batch.exhausted;
+    m_lastErrorMsg = m_batch.errorMsg;
+    m_batch = Batch();
+    return m_lastErrorMsg.empty();
+}
+
+bool QueryCursor::isReadOnly() const {
+    return (m_stmt == nullptr) || (sqlite3_stmt_readonly(m_stmt) != 0);
+}
+
+const QueryResult* QueryCursor::getRowBlock(const size_t vIdx, size_t& vOutBlockRow) const {
+    if (m_detached) {
+        vOutBlockRow = vIdx;
+        return (vIdx < m_nextRowIdx) ? &m_detachedResult : nullptr;
+    }
+    if (vIdx >= m_getWindowStart() && vIdx < m_nextRowIdx) {
+        const size_t blockIdx = vIdx / s_blockSize;
+        vOutBlockRow = vIdx % s_blockSize;
+        return &m_window.at(blockIdx - m_firstBlockIdx);
+    }
+    return nullptr;
+}
+
+size_t QueryCursor::m_getWindowStart() const {
+    if (m_window.empty()) {
+        return m_nextRowIdx;
+    }
+    return m_firstBlockIdx * s_blockSize;
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <backend/helpers/dbHelper.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+
+struct sqlite3_stmt;
+
+// keep a statement open and fetch its rows on demand in a bounded window of blocks.
+// sqlite statements are forward only, so going before the window rewind the statement.
+// a cursor can also be detached, it expose rows already in memory (the results of a script).
+// a read statement is executed on a read connection of the pool if possible, so it don't lock the writer.
+// a statement who write can't be rewound (it would write again), its rows are materialized once.
+// the rows can be read in a worker thread (readBlocks) while the ui use the window, then merged in it (applyBlocks)
+class QueryCursor {
+private:
+    static const size_t s_blockSize;        // rows are fetched by blocks
+    static const size_t s_maxWindowBlocks;  // max blocks kept in memory
+
+private:
+    // blocks read by readBlocks, not yet in the window
+    struct Batch {
+        bool isRead{false};
+        bool replaceWindow{false};  // the statement was rewound, or the window is too far
+        size_t firstBlockIdx{0};
+        std::deque<QueryResult> blocks;
+        size_t nextRowIdx{0};
+        bool exhausted{false};
+        std::string errorMsg;
+    };
+
+private:
+    sqlite3_stmt* m_stmt{nullptr};
+    ReadConnection m_readConnection;  // if valid, m_stmt belong to it, else to the writer connection
+    std::vector<ColumnInfo> m_columns;
+    std::shared_ptr<RowidColumns> m_rowidColumns;  // shared by the blocks of the cursor
+    std::deque<QueryResult> m_window;  // consecutive blocks, the first one is the block m_firstBlockIdx
+    size_t m_firstBlockIdx{0};
+    size_t m_nextRowIdx{0};  // index of the row the next sqlite3_step will give
+    bool m_exhausted{false};
+    bool m_detached{false};
+    QueryResult m_detachedResult;
+    std::string m_lastErrorMsg;
+    Batch m_batch;
+
+public:
+    QueryCursor() = default;
+    ~QueryCursor();
+    QueryCursor(const QueryCursor&) = delete;
+    QueryCursor& operator=(const QueryCursor&) = delete;
+
+    bool open(const std::string& vSql);
+    void open(QueryResult&& vResult);  // detached
+    void close();
+
+    // ensure the rows [vStart, vEnd) are in the window, as far as the result go
+    bool fetch(const size_t vStart, const size_t vEnd, QueryControl* vpControl = nullptr);
+    // read all the rows and detach the cursor. used for the statements who write
+    bool materialize(QueryControl* vpControl = nullptr);
+    // true if fetch(vStart, vEnd) have rows to read
+    bool needFetch(const size_t vStart, const size_t vEnd) const;
+    // fetch in two steps : readBlocks can run in another thread while the window is used, it only touch the statement.
+    // applyBlocks merge the read blocks in the window, in the thread using the window
+    void readBlocks(const size_t vStart, const size_t vEnd, QueryControl* vpControl);
+    bool applyBlocks();
+
+    bool isOpen() const { return m_stmt != nullptr; }
+    bool isReadOnly() const;  // false if the statement write, it must be materialized
+    bool isOnReadConnection() const { return m_readConnection.isValid(); }
+    bool isExhausted() const { return m_exhausted; }
+    bool isValid() const { return !m_columns.empty(); }
+    const std::vector<ColumnInfo>& getColumns() const { return m_columns; }
+    size_t getKnownRowsCount() const { return m_nextRowIdx; }  // rows reached by the statement until now
+    size_t getBlockSize() const { return s_blockSize; }
+    // return the block containing the row vIdx and the row index in this block. nullptr if not in the window
+    const QueryResult* getRowBlock(const size_t vIdx, size_t& vOutBlockRow) const;
+    const std::string& getLastErrorMsg() const { return m_lastErrorMsg; }
+
+private:
+    size_t m_getWindowStart() const;
+};
@@ -0,0 +1,102 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "queryPlan.h"
+#include <backend/helpers/dbHelper.h>
+
+#include <functional>
+#include <map>
+
+size_t QueryPlan::getWarningsCount() const {
+    size_t ret = 0U;
+    for (const auto& node : nodes) {
+        if (node.kind != QueryPlanNode::Kind::NORMAL) {
+            ++ret;
+        }
+    }
+    return ret;
+}
+
+bool QueryPlan::explain(const std::string& vSql, QueryPlan& vOutPlan, std::string* vpOutErrorMsg) {
+    vOutPlan.sql = vSql;
+    vOutPlan.nodes.clear();
+    vOutPlan.elapsedMs = -1.0;
+    std::string errorMsg;
+    const auto& results = DBHelper::ref().executeReadQuery("EXPLAIN QUERY PLAN " + vSql, &errorMsg);
+    if (vpOutErrorMsg != nullptr) {
+        *vpOutErrorMsg = errorMsg;
+    }
+    if (!errorMsg.empty()) {
+        return false;
+    }
+    // columns are id, parent, notused, detail
+    std::vector<QueryPlanNode> rows;
+    rows.reserve(results.getRowsCount());
+    for (size_t r = 0; r < results.getRowsCount(); ++r) {
+        QueryPlanNode node;
+        node.id = static_cast<int32_t>(results.getInteger(r, 0));
+        node.parentId = static_cast<int32_t>(results.getInteger(r, 1));
+        node.detail = results.getText(r, 3);
+        rows.push_back(node);
+    }
+    vOutPlan.setNodes(std::move(rows));
+    return true;
+}
+
+// the rows are not always in the tree order
+void QueryPlan::setNodes(std::vector<QueryPlanNode>&& vRows) {
+    nodes.clear();
+    std::map<int32_t, std::vector<size_t>> childrenByParent;
+    for (size_t idx = 0; idx < vRows.size(); ++idx) {
+        vRows[idx].kind = getNodeKind(vRows[idx].detail);
+        childrenByParent[vRows[idx].parentId].push_back(idx);
+    }
+    std::function<void(int32_t, int32_t)> addChildren = [&](int32_t vParentId, int32_t vDepth) {
+        auto it = childrenByParent.find(vParentId);
+        if (it == childrenByParent.end()) {
+            return;
+        }
+        const auto children = std::move(it->second);
+        childrenByParent.erase(it);  // a malformed plan can not loop
+        for (const auto idx : children) {
+            auto node = vRows.at(idx);
+            node.depth = vDepth;
+            node.hasChildren = (childrenByParent.find(node.id) != childrenByParent.end());
+            nodes.push_back(node);
+            addChildren(node.id, vDepth + 1);
+        }
+    };
+    addChildren(0, 0);
+}
+
+QueryPlanNode::Kind QueryPlan::getNodeKind(const std::string& vDetail) {
+    if (vDetail.find("AUTOMATIC") != std::string::npos) {
+        return QueryPlanNode::Kind::AUTO_INDEX;
+    }
+    if (vDetail.find("TEMP B-TREE") != std::string::npos) {
+        return QueryPlanNode::Kind::TEMP_BTREE;
+    }
+    // SCAN t USING INDEX i walk the index, SCAN CONSTANT ROW read nothing
+    if (vDetail.compare(0, 5, "SCAN ") == 0 &&  //
+        vDetail.find(" USING ") == std::string::npos &&  //
+        vDetail != "SCAN CONSTANT ROW") {
+        return QueryPlanNode::Kind::FULL_SCAN;
+    }
+    return QueryPlanNode::Kind::NORMAL;
+}
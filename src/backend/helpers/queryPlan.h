@@ -0,0 +1,53 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct QueryPlanNode {
+    enum class Kind {
+        NORMAL = 0,
+        FULL_SCAN,   // SCAN of a table without index
+        TEMP_BTREE,  // USE TEMP B-TREE, a sort, a distinct or a compound without index
+        AUTO_INDEX,  // AUTOMATIC INDEX, built at each execution
+    };
+    int32_t id{};
+    int32_t parentId{};
+    int32_t depth{};
+    bool hasChildren{false};
+    Kind kind{Kind::NORMAL};
+    std::string detail;
+};
+
+struct QueryPlan {
+    size_t number{};  // number of the plan in the history
+    std::string sql;
+    std::vector<QueryPlanNode> nodes;  // in the depth first order of the tree
+    double elapsedMs{-1.0};  // -1 if explained without execution
+    bool isValid() const { return !nodes.empty(); }
+    size_t getWarningsCount() const;
+    // build the tree from the EXPLAIN QUERY PLAN rows, only id, parentId and detail are needed
+    void setNodes(std::vector<QueryPlanNode>&& vRows);
+    // run EXPLAIN QUERY PLAN on the first statement of vSql
+    static bool explain(const std::string& vSql, QueryPlan& vOutPlan, std::string* vpOutErrorMsg = nullptr);
+    static QueryPlanNode::Kind getNodeKind(const std::string& vDetail);
+};
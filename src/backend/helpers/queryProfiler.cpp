@@ -0,0 +1,167 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "queryProfiler.h"
+
+#include <sqlite3/sqlite3.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+const size_t QueryProfiler::s_maxProfiles = 2000U;
+
+bool ScanStatus::isEstimateMismatch() const {
+    const auto actualRows = getActualRows();
+    if (actualRows < 0.0 || estimatedRows < 0.0) {
+        return false;
+    }
+    const auto ratio = std::max(actualRows, 1.0) / std::max(estimatedRows, 1.0);
+    return (ratio >= 10.0) || (ratio <= 0.1);
+}
+
+bool QueryProfiler::init() {
+    clear();
+    return true;
+}
+
+void QueryProfiler::unit() {
+    clear();
+}
+
+void QueryProfiler::attach(sqlite3* vDbPtr) noexcept {
+    if (vDbPtr != nullptr) {
+        sqlite3_trace_v2(vDbPtr, SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE, s_traceCallback, this);
+    }
+}
+
+void QueryProfiler::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_profiles.clear();
+    m_runningTriggersCounts.clear();
+    ++m_generation;
+}
+
+std::vector<StatementProfile> QueryProfiler::getProfiles() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::vector<StatementProfile>(m_profiles.begin(), m_profiles.end());
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//// PRIVATE /////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////
+
+int QueryProfiler::s_traceCallback(unsigned vType, void* vpContext, void* vpP, void* vpX) {
+    auto* pProfiler = static_cast<QueryProfiler*>(vpContext);
+    if (!pProfiler->m_enabled) {
+        return 0;
+    }
+    auto* stmt = static_cast<sqlite3_stmt*>(vpP);
+    if (vType == SQLITE_TRACE_STMT) {
+        pProfiler->m_onStatementStart(stmt, static_cast<const char*>(vpX));
+    } else if (vType == SQLITE_TRACE_PROFILE) {
+        pProfiler->m_onStatementEnd(stmt, *static_cast<const sqlite3_int64*>(vpX));
+    }
+    return 0;
+}
+
+void QueryProfiler::m_onStatementStart(sqlite3_stmt* vStmt, const char* vpSql) {
+    // a trigger program is reported as "-- TRIGGER name", then its statements as "-- statement"
+    const bool isTrigger = (vpSql != nullptr) && (std::strncmp(vpSql, "-- TRIGGER ", 11) == 0);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& triggersCount = m_runningTriggersCounts[vStmt];
+    if (isTrigger) {
+        ++triggersCount;
+    }
+}
+
+void QueryProfiler::m_onStatementEnd(sqlite3_stmt* vStmt, const int64_t vNanoSeconds) {
+    StatementProfile profile;
+    const char* sql = sqlite3_sql(vStmt);
+    profile.sql = (sql != nullptr) ? sql : "";
+    profile.elapsedMs = static_cast<double>(vNanoSeconds) / 1000000.0;
+    // the counters are reset, the cached statements are executed many times
+    profile.vmSteps = sqlite3_stmt_status(vStmt, SQLITE_STMTSTATUS_VM_STEP, 1);
+    profile.fullScanSteps = sqlite3_stmt_status(vStmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+    profile.sortsCount = sqlite3_stmt_status(vStmt, SQLITE_STMTSTATUS_SORT, 1);
+    profile.autoIndexesCount = sqlite3_stmt_status(vStmt, SQLITE_STMTSTATUS_AUTOINDEX, 1);
+    profile.memUsed = sqlite3_stmt_status(vStmt, SQLITE_STMTSTATUS_MEMUSED, 0);
+    profile.repreparesCount = sqlite3_stmt_status(vStmt, SQLITE_STMTSTATUS_REPREPARE, 1);
+    profile.onReadConnection = (sqlite3_db_readonly(sqlite3_db_handle(vStmt), "main") == 1);
+    m_readScanStatus(vStmt, profile);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_runningTriggersCounts.find(vStmt);
+    if (it != m_runningTriggersCounts.end()) {
+        profile.triggersCount = it->second;
+        m_runningTriggersCounts.erase(it);
+    }
+    m_profiles.push_back(std::move(profile));
+    while (m_profiles.size() > s_maxProfiles) {
+        m_profiles.pop_front();
+    }
+    ++m_generation;
+}
+
+void QueryProfiler::m_readScanStatus(sqlite3_stmt* vStmt, StatementProfile& vOutProfile) {
+#ifdef SQLITE_ENABLE_STMT_SCANSTATUS
+    // the complex mode report the sorts and the subqueries too, not only the loops
+    const int flags = SQLITE_SCANSTAT_COMPLEX;
+    sqlite3_int64 cycles = -1;
+    sqlite3_stmt_scanstatus_v2(vStmt, -1, SQLITE_SCANSTAT_NCYCLE, flags, &cycles);
+    vOutProfile.cycles = cycles;
+    std::unordered_map<int32_t, int32_t> depths;  // by select id
+    for (int idx = 0;; ++idx) {
+        ScanStatus scan;
+        sqlite3_int64 count = -1;
+        if (sqlite3_stmt_scanstatus_v2(vStmt, idx, SQLITE_SCANSTAT_NLOOP, flags, &count) != 0) {
+            break;  // no more elements
+        }
+        scan.loopsCount = count;
+        count = -1;
+        sqlite3_stmt_scanstatus_v2(vStmt, idx, SQLITE_SCANSTAT_NVISIT, flags, &count);
+        scan.visitsCount = count;
+        count = -1;
+        sqlite3_stmt_scanstatus_v2(vStmt, idx, SQLITE_SCANSTAT_NCYCLE, flags, &count);
+        scan.cycles = count;
+        double estimatedRows = -1.0;
+        sqlite3_stmt_scanstatus_v2(vStmt, idx, SQLITE_SCANSTAT_EST, flags, &estimatedRows);
+        scan.estimatedRows = estimatedRows;
+        int id = 0;
+        sqlite3_stmt_scanstatus_v2(vStmt, idx, SQLITE_SCANSTAT_SELECTID, flags, &id);
+        scan.selectId = id;
+        id = 0;
+        sqlite3_stmt_scanstatus_v2(vStmt, idx, SQLITE_SCANSTAT_PARENTID, flags, &id);
+        scan.parentId = id;
+        const char* pText = nullptr;
+        sqlite3_stmt_scanstatus_v2(vStmt, idx, SQLITE_SCANSTAT_NAME, flags, &pText);
+        scan.name = (pText != nullptr) ? pText : "";
+        pText = nullptr;
+        sqlite3_stmt_scanstatus_v2(vStmt, idx, SQLITE_SCANSTAT_EXPLAIN, flags, &pText);
+        scan.explain = (pText != nullptr) ? pText : "";
+        const auto it = depths.find(scan.parentId);
+        scan.depth = (it != depths.end()) ? it->second + 1 : 0;
+        depths[scan.selectId] = scan.depth;
+        vOutProfile.scans.push_back(std::move(scan));
+    }
+    // like the stmt_status counters, a cached statement must report only its next run
+    sqlite3_stmt_scanstatus_reset(vStmt);
+#else
+    (void)vStmt;
+    (void)vOutProfile;
+#endif
+}
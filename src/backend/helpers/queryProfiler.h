@@ -0,0 +1,101 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <ezlibs/ezClass.hpp>
+#include <ezlibs/ezSingleton.hpp>
+
+#include <unordered_map>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+// a loop, a sort or a subquery of the plan, read with sqlite3_stmt_scanstatus_v2. -1 if not available
+struct ScanStatus {
+    int32_t selectId{};  // id of the EXPLAIN QUERY PLAN node
+    int32_t parentId{};
+    int32_t depth{};
+    std::string name;  // table or index
+    std::string explain;  // EXPLAIN QUERY PLAN text
+    int64_t loopsCount{-1};
+    int64_t visitsCount{-1};  // actual rows of all the loops
+    double estimatedRows{-1.0};  // by loop
+    int64_t cycles{-1};
+    double getActualRows() const { return (loopsCount > 0) ? static_cast<double>(visitsCount) / static_cast<double>(loopsCount) : -1.0; }
+    bool isEstimateMismatch() const;  // the planner was wrong by 10x or more
+};
+
+// counters of one execution of a statement, read when sqlite report its end
+struct StatementProfile {
+    std::string sql;
+    double elapsedMs{0.0};
+    int64_t vmSteps{0};
+    int64_t fullScanSteps{0};  // rows stepped by full table scans, an index can be missing
+    int64_t sortsCount{0};
+    int64_t autoIndexesCount{0};  // rows inserted in automatic indexes, an index can be missing
+    int64_t memUsed{0};  // bytes used by the statement
+    int64_t repreparesCount{0};  // reprepares after a schema change
+    int64_t triggersCount{0};  // trigger programs started by the statement
+    bool onReadConnection{false};
+    int64_t cycles{-1};  // of the whole statement
+    std::vector<ScanStatus> scans;  // empty if sqlite is built without SQLITE_ENABLE_STMT_SCANSTATUS
+};
+
+// collect the profiles of all the statements executed by the connections of DBHelper,
+// the internal ones included. the callbacks come from the threads using the connections
+class QueryProfiler {
+    IMPLEMENT_SINGLETON(QueryProfiler)
+    DISABLE_CONSTRUCTORS(QueryProfiler)
+    DISABLE_DESTRUCTORS(QueryProfiler)
+
+private:  // (static)
+    static const size_t s_maxProfiles;  // the oldest profiles are dropped
+
+private:
+    mutable std::mutex m_mutex;
+    std::deque<StatementProfile> m_profiles;  // the most recent at the back
+    std::unordered_map<sqlite3_stmt*, int64_t> m_runningTriggersCounts;  // by running statement
+    std::atomic<bool> m_enabled{true};
+    std::atomic<uint64_t> m_generation{0U};  // incremented at each change of the profiles
+
+public:
+    bool init();
+    void unit();
+
+    void attach(sqlite3* vDbPtr) noexcept;  // to call for each opened connection
+
+    void setEnabled(const bool vEnabled) { m_enabled = vEnabled; }
+    bool isEnabled() const { return m_enabled; }
+    void clear();
+    std::vector<StatementProfile> getProfiles() const;  // copy, the oldest first
+    uint64_t getGeneration() const { return m_generation; }
+
+private:
+    static int s_traceCallback(unsigned vType, void* vpContext, void* vpP, void* vpX);
+    void m_onStatementStart(sqlite3_stmt* vStmt, const char* vpSql);
+    void m_onStatementEnd(sqlite3_stmt* vStmt, const int64_t vNanoSeconds);
+    static void m_readScanStatus(sqlite3_stmt* vStmt, StatementProfile& vOutProfile);
+};
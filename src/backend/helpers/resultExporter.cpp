@@ -0,0 +1,498 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "resultExporter.h"
+
+#include <backend/helpers/dbHelper.h>
+#include <backend/helpers/hexEncoder.h>
+#include <sqlite3/sqlite3.hpp>
+
+#include <system_error>
+#include <algorithm>
+#include <filesystem>
+#include <charconv>
+#include <fstream>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <cmath>
+#include <new>
+
+namespace fs = std::filesystem;
+
+//////////////////////////////////////////////////////////////////////////////////
+//// BUFFERED FILE WRITER ////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////
+
+// the stream is not buffered, the datas are written by blocks of s_bufferSize from an aligned buffer
+class BufferedFileWriter {
+private:
+    static constexpr size_t s_bufferSize = 1024U * 1024U;
+    static constexpr size_t s_bufferAlignment = 4096U;
+    struct AlignedDeleter {
+        void operator()(char* vPtr) const { ::operator delete(vPtr, std::align_val_t(s_bufferAlignment)); }
+    };
+
+private:
+    std::unique_ptr<char, AlignedDeleter> m_buffer;
+    size_t m_bufferPos{0U};
+    std::ofstream m_file;
+    std::atomic<size_t>& m_bytesCountRef;
+
+public:
+    explicit BufferedFileWriter(std::atomic<size_t>& vBytesCountRef) : m_bytesCountRef(vBytesCountRef) {}
+
+    bool open(const std::string& vFilePathName) {
+        m_buffer.reset(static_cast<char*>(::operator new(s_bufferSize, std::align_val_t(s_bufferAlignment))));
+        m_file.rdbuf()->pubsetbuf(nullptr, 0);  // must be done before the open
+        m_file.open(fs::u8path(vFilePathName), std::ios::binary | std::ios::trunc);
+        return m_file.is_open();
+    }
+
+    bool close() {
+        flush();
+        m_file.close();
+        return !m_file.fail();
+    }
+
+    bool isOk() const { return m_file.good(); }
+
+    void flush() {
+        if (m_bufferPos > 0U) {
+            m_file.write(m_buffer.get(), static_cast<std::streamsize>(m_bufferPos));
+            m_bytesCountRef += m_bufferPos;
+            m_bufferPos = 0U;
+        }
+    }
+
+    void append(const char* vDatas, size_t vSize) {
+        while (vSize > 0U) {
+            if (m_bufferPos == s_bufferSize) {
+                flush();
+            }
+            const size_t count = std::min(vSize, s_bufferSize - m_bufferPos);
+            std::memcpy(m_buffer.get() + m_bufferPos, vDatas, count);
+            m_bufferPos += count;
+            vDatas += count;
+            vSize -= count;
+        }
+    }
+
+    void append(const char vChar) {
+        if (m_bufferPos == s_bufferSize) {
+            flush();
+        }
+        m_buffer.get()[m_bufferPos++] = vChar;
+    }
+
+    void append(const std::string& vStr) { append(vStr.data(), vStr.size()); }
+
+    void appendInteger(const int64_t vValue) {
+        char str[24];
+        const auto res = std::to_chars(str, str + sizeof(str), vValue);
+        append(str, static_cast<size_t>(res.ptr - str));
+    }
+
+    // shortest representation who give back the same double
+    void appendReal(const double vValue) {
+        char str[32];
+        const auto res = std::to_chars(str, str + sizeof(str), vValue);
+        append(str, static_cast<size_t>(res.ptr - str));
+    }
+
+    void appendHex(const uint8_t* vDatas, const size_t vSize) {
+        char buf[512];
+        for (size_t i = 0; i < vSize; i += sizeof(buf) / 2U) {
+            const size_t count = std::min(vSize - i, sizeof(buf) / 2U);
+            HexEncoder::encode(vDatas + i, count, buf);
+            append(buf, count * 2U);
+        }
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////////////
+//// FORMATS /////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////
+
+// quoted only if needed, "" for the quotes
+static void s_writeCsvText(BufferedFileWriter& vWriter, const char* vText, const size_t vSize) {
+    bool needQuotes = false;
+    for (size_t i = 0; i < vSize && !needQuotes; ++i) {
+        const char c = vText[i];
+        needQuotes = (c == ',' || c == '"' || c == '\r' || c == '\n');
+    }
+    if (!needQuotes) {
+        vWriter.append(vText, vSize);
+        return;
+    }
+    vWriter.append('"');
+    size_t start = 0U;
+    for (size_t i = 0; i < vSize; ++i) {
+        if (vText[i] == '"') {
+            vWriter.append(vText + start, i + 1U - start);
+            vWriter.append('"');
+            start = i + 1U;
+        }
+    }
+    vWriter.append(vText + start, vSize - start);
+    vWriter.append('"');
+}
+
+// tab, line ends and backslash are escaped with a backslash
+static void s_writeTsvText(BufferedFileWriter& vWriter, const char* vText, const size_t vSize) {
+    size_t start = 0U;
+    for (size_t i = 0; i < vSize; ++i) {
+        char escaped = 0;
+        switch (vText[i]) {
+            case '\t': escaped = 't'; break;
+            case '\n': escaped = 'n'; break;
+            case '\r': escaped = 'r'; break;
+            case '\\': escaped = '\\'; break;
+            default: break;
+        }
+        if (escaped != 0) {
+            vWriter.append(vText + start, i - start);
+            vWriter.append('\\');
+            vWriter.append(escaped);
+            start = i + 1U;
+        }
+    }
+    vWriter.append(vText + start, vSize - start);
+}
+
+static void s_writeJsonText(BufferedFileWriter& vWriter, const char* vText, const size_t vSize) {
+    static const char s_digits[] = "0123456789abcdef";
+    vWriter.append('"');
+    size_t start = 0U;
+    for (size_t i = 0; i < vSize; ++i) {
+        const auto c = static_cast<uint8_t>(vText[i]);
+        if (c == '"' || c == '\\' || c < 0x20U) {
+            vWriter.append(vText + start, i - start);
+            vWriter.append('\\');
+            switch (c) {
+                case '"': vWriter.append('"'); break;
+                case '\\': vWriter.append('\\'); break;
+                case '\n': vWriter.append('n'); break;
+                case '\r': vWriter.append('r'); break;
+                case '\t': vWriter.append('t'); break;
+                default: {
+                    vWriter.append("u00", 3U);
+                    vWriter.append(s_digits[c >> 4]);
+                    vWriter.append(s_digits[c & 0x0F]);
+                    break;
+                }
+            }
+            start = i + 1U;
+        }
+    }
+    vWriter.append(vText + start, vSize - start);
+    vWriter.append('"');
+}
+
+static void s_writeCell(BufferedFileWriter& vWriter, sqlite3_stmt* vStmt, const int vCol, const ResultExporter::Format vFormat) {
+    switch (sqlite3_column_type(vStmt, vCol)) {
+        case SQLITE_INTEGER: {
+            vWriter.appendInteger(sqlite3_column_int64(vStmt, vCol));
+            break;
+        }
+        case SQLITE_FLOAT: {
+            const double value = sqlite3_column_double(vStmt, vCol);
+            if (vFormat == ResultExporter::Format::JSONL && !std::isfinite(value)) {
+                vWriter.append("null", 4U);  // not representable in json
+            } else {
+                vWriter.appendReal(value);
+            }
+            break;
+        }
+        case SQLITE_TEXT: {
+            const auto* text = reinterpret_cast<const char*>(sqlite3_column_text(vStmt, vCol));
+            const auto size = static_cast<size_t>(sqlite3_column_bytes(vStmt, vCol));
+            switch (vFormat) {
+                case ResultExporter::Format::CSV: s_writeCsvText(vWriter, text, size); break;
+                case ResultExporter::Format::TSV: s_writeTsvText(vWriter, text, size); break;
+                case ResultExporter::Format::JSONL: s_writeJsonText(vWriter, text, size); break;
+            }
+            break;
+        }
+        case SQLITE_BLOB: {  // in hexa
+            const auto* datas = static_cast<const uint8_t*>(sqlite3_column_blob(vStmt, vCol));
+            const auto size = static_cast<size_t>(sqlite3_column_bytes(vStmt, vCol));
+            if (vFormat == ResultExporter::Format::JSONL) {
+                vWriter.append('"');
+                vWriter.appendHex(datas, size);
+                vWriter.append('"');
+            } else {
+                vWriter.appendHex(datas, size);
+            }
+            break;
+        }
+        case SQLITE_NULL:
+        default: {
+            if (vFormat == ResultExporter::Format::JSONL) {
+                vWriter.append("null", 4U);
+            }
+            break;
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//// PUBLIC //////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////
+
+const char* ResultExporter::getFormatName(const Format vFormat) {
+    switch (vFormat) {
+        case Format::CSV: return "CSV";
+        case Format::TSV: return "TSV";
+        case Format::JSONL: return "JSON Lines";
+    }
+    return "";
+}
+
+const char* ResultExporter::getFormatFilter(const Format vFormat) {
+    switch (vFormat) {
+        case Format::CSV: return ".csv";
+        case Format::TSV: return ".tsv";
+        case Format::JSONL: return ".jsonl";
+    }
+    return "";
+}
+
+bool ResultExporter::init() {
+    return true;
+}
+
+void ResultExporter::unit() {
+    stop();
+    m_job.reset();
+}
+
+bool ResultExporter::start(  //
+    const std::string& vSql,
+    const std::string& vFilePathName,
+    const Format vFormat,
+    const size_t vExpectedRowsCount,
+    const CompletionFunctor& vCompletionFunctor) {
+    if (m_job != nullptr || vSql.empty()) {  // running, or its completion is not called yet
+        return false;
+    }
+    m_sql = vSql;
+    m_filePathName = vFilePathName;
+    m_format = vFormat;
+    m_expectedRowsCount = vExpectedRowsCount;
+    m_errorMsg.clear();
+    m_rowsCount = 0U;
+    m_bytesCount = 0U;
+    m_elapsedMs = 0.0;
+    m_completionFunctor = vCompletionFunctor;
+    m_startTime = std::chrono::steady_clock::now();
+    m_state = State::RUNNING;
+    m_job = JobManager::ref().pushJob(  //
+        Job::Priority::INTERACTIVE,
+        [this](Job& vJob) { m_run(vJob); },
+        [this](Job& /*vJob*/) { m_complete(); });
+    return true;
+}
+
+void ResultExporter::cancel() {
+    if (m_job != nullptr) {
+        m_job->cancel();
+    }
+}
+
+void ResultExporter::stop() {
+    cancel();
+    // a pending job will not run once canceled, a running one releases the lock at its end
+    std::lock_guard<std::mutex> lock(m_runMutex);
+}
+
+float ResultExporter::getProgress() const {
+    if (m_expectedRowsCount == 0U) {
+        return 0.0f;
+    }
+    return std::min(static_cast<float>(static_cast<double>(m_rowsCount) / static_cast<double>(m_expectedRowsCount)), 1.0f);
+}
+
+double ResultExporter::getElapsedMs() const {
+    if (m_state == State::RUNNING) {
+        const auto elapsed = std::chrono::steady_clock::now() - m_startTime;
+        return std::chrono::duration<double, std::milli>(elapsed).count();
+    }
+    return m_elapsedMs;
+}
+
+double ResultExporter::getRowsPerSecond() const {
+    const auto elapsedMs = getElapsedMs();
+    return (elapsedMs > 0.0) ? static_cast<double>(m_rowsCount) * 1000.0 / elapsedMs : 0.0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//// PRIVATE /////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////
+
+void ResultExporter::m_run(Job& vJob) {
+    std::lock_guard<std::mutex> lock(m_runMutex);
+    if (vJob.isCancelRequested()) {  // canceled by stop() while it was pending
+        return;
+    }
+    const bool ok = m_export(vJob);
+    const auto elapsed = std::chrono::steady_clock::now() - m_startTime;
+    m_elapsedMs = std::chrono::duration<double, std::milli>(elapsed).count();
+    if (vJob.isCancelRequested()) {
+        m_errorMsg = "Export canceled";
+        m_state = State::CANCELED;
+    } else {
+        m_state = ok ? State::DONE : State::FAILED;
+    }
+}
+
+void ResultExporter::m_complete() {
+    m_job.reset();
+    if (m_state == State::RUNNING) {  // canceled before it runs
+        m_errorMsg = "Export canceled";
+        m_elapsedMs = 0.0;
+        m_state = State::CANCELED;
+    }
+    if (m_completionFunctor) {
+        m_completionFunctor(*this);
+    }
+}
+
+bool ResultExporter::m_export(Job& vJob) {
+    auto& db = DBHelper::ref();
+    // on a read connection the export don't block the queries of the writer
+    sqlite3_stmt* stmt = nullptr;
+    auto readConnection = db.acquireReadConnection();
+    if (readConnection.isValid()) {
+        if (sqlite3_prepare_v2(readConnection.get(), m_sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK ||  //
+            !DBHelper::isReadStatement(stmt)) {
+            sqlite3_finalize(stmt);
+            stmt = nullptr;
+            readConnection.release();
+        }
+    }
+    // on the writer the lock is held for the whole export, else a COMMIT, a ROLLBACK or a write
+    // of another thread could run between two steps of the statement
+    std::unique_lock<std::recursive_mutex> dbLock(db.getMutexRef(), std::defer_lock);
+    if (!readConnection.isValid()) {
+        dbLock.lock();
+        stmt = db.prepareStatement(m_sql);
+    }
+    if (stmt == nullptr) {
+        m_errorMsg = db.getLastErrorMsg();
+        return false;
+    }
+    // the query is executed again, it must not modify the db
+    if (sqlite3_stmt_readonly(stmt) == 0) {
+        sqlite3_finalize(stmt);
+        m_errorMsg = "Only the read only queries can be exported";
+        return false;
+    }
+
+    BufferedFileWriter writer(m_bytesCount);
+    if (!writer.open(m_filePathName)) {
+        sqlite3_finalize(stmt);
+        m_errorMsg = "Failed to open the file " + m_filePathName;
+        return false;
+    }
+
+    const int colCount = sqlite3_column_count(stmt);
+    const char separator = (m_format == Format::TSV) ? '\t' : ',';
+    std::vector<std::string> jsonKeys;  // escaped once
+    for (int c = 0; c < colCount; ++c) {
+        const char* name = sqlite3_column_name(stmt, c);
+        const size_t nameSize = std::strlen(name);
+        switch (m_format) {
+            case Format::CSV:
+            case Format::TSV: {
+                if (c > 0) {
+                    writer.append(separator);
+                }
+                if (m_format == Format::CSV) {
+                    s_writeCsvText(writer, name, nameSize);
+                } else {
+                    s_writeTsvText(writer, name, nameSize);
+                }
+                break;
+            }
+            case Format::JSONL: {
+                std::string key = (c > 0) ? "," : "{";
+                key += '"';
+                for (size_t i = 0; i < nameSize; ++i) {
+                    if (name[i] == '"' || name[i] == '\\') {
+                        key += '\\';
+                    }
+                    key += name[i];
+                }
+                key += "\":";
+                jsonKeys.push_back(key);
+                break;
+            }
+        }
+    }
+    if (m_format != Format::JSONL) {
+        writer.append('\n');
+    }
+
+    bool ok = true;
+    while (ok && !vJob.isCancelRequested()) {
+        const auto rc = sqlite3_step(stmt);
+        if (rc == SQLITE_ROW) {
+            for (int c = 0; c < colCount; ++c) {
+                if (m_format == Format::JSONL) {
+                    writer.append(jsonKeys[c]);
+                } else if (c > 0) {
+                    writer.append(separator);
+                }
+                s_writeCell(writer, stmt, c, m_format);
+            }
+            if (m_format == Format::JSONL) {
+                writer.append(colCount > 0 ? "}\n" : "{}\n", colCount > 0 ? 2U : 3U);
+            } else {
+                writer.append('\n');
+            }
+            ++m_rowsCount;
+            if (!writer.isOk()) {
+                m_errorMsg = "Failed to write in the file " + m_filePathName;
+                ok = false;
+            }
+        } else if (rc == SQLITE_DONE) {
+            break;
+        } else {
+            m_errorMsg = sqlite3_errmsg(sqlite3_db_handle(stmt));
+            ok = false;
+        }
+    }
+    sqlite3_finalize(stmt);
+    if (dbLock.owns_lock()) {
+        dbLock.unlock();
+    }
+    readConnection.release();
+
+    if (!writer.close() && ok) {
+        m_errorMsg = "Failed to write in the file " + m_filePathName;
+        ok = false;
+    }
+    if (!ok || vJob.isCancelRequested()) {
+        std::error_code ec;
+        fs::remove(fs::u8path(m_filePathName), ec);  // no partial file
+        return false;
+    }
+    return true;
+}
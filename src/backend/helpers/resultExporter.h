@@ -0,0 +1,104 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <backend/managers/jobManager.h>
+
+#include <ezlibs/ezClass.hpp>
+#include <ezlibs/ezSingleton.hpp>
+
+#include <functional>
+#include <cstdint>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+// export the rows of a query in a file, straight from the statement to a buffered writer.
+// nothing is materialized, so the size of the result is not limited by the memory.
+// the export is a job of the JobManager
+class ResultExporter {
+    IMPLEMENT_SINGLETON(ResultExporter)
+    DISABLE_CONSTRUCTORS(ResultExporter)
+    DISABLE_DESTRUCTORS(ResultExporter)
+
+public:
+    enum class Format {  //
+        CSV = 0,
+        TSV,
+        JSONL
+    };
+    enum class State {  //
+        IDLE = 0,
+        RUNNING,
+        DONE,
+        FAILED,
+        CANCELED
+    };
+    typedef std::function<void(ResultExporter&)> CompletionFunctor;  // called in the ui thread
+
+private:
+    JobPtr m_job;
+    std::mutex m_runMutex;  // held by the job while it exports
+    std::atomic<State> m_state{State::IDLE};
+    std::atomic<size_t> m_rowsCount{0U};
+    std::atomic<size_t> m_bytesCount{0U};
+    size_t m_expectedRowsCount{0U};  // 0 if unknown
+    std::chrono::steady_clock::time_point m_startTime{};
+    double m_elapsedMs{0.0};
+    std::string m_sql;
+    std::string m_filePathName;
+    Format m_format{Format::CSV};
+    std::string m_errorMsg;
+    CompletionFunctor m_completionFunctor;
+
+public:
+    static const char* getFormatName(const Format vFormat);
+    static const char* getFormatFilter(const Format vFormat);  // for the file dialog
+
+    bool init();
+    void unit();
+
+    // only the read only queries can be exported, they are executed again.
+    // vExpectedRowsCount : for the progress, 0 if unknown
+    bool start(  //
+        const std::string& vSql,
+        const std::string& vFilePathName,
+        const Format vFormat,
+        const size_t vExpectedRowsCount,
+        const CompletionFunctor& vCompletionFunctor);
+    void cancel();
+    void stop();  // cancel and wait the end of the export
+    bool isRunning() const { return m_state == State::RUNNING; }
+
+    State getState() const { return m_state; }
+    float getProgress() const;  // [0:1], 0 if the rows count is unknown
+    size_t getRowsCount() const { return m_rowsCount; }
+    size_t getBytesCount() const { return m_bytesCount; }
+    double getElapsedMs() const;  // live value while running
+    double getRowsPerSecond() const;
+    const std::string& getFilePathName() const { return m_filePathName; }
+    const std::string& getErrorMsg() const { return m_errorMsg; }  // valid once finished
+
+private:
+    void m_run(Job& vJob);
+    void m_complete();
+    bool m_export(Job& vJob);
+};
@@ -23,20 +23,40 @@
 #include <ezlibs/ezFile.hpp>
 
 #include <backend/helpers/dbHelper.h>
+#include <backend/helpers/dbBackup.h>
+#include <backend/helpers/blobTransfer.h>
+#include <backend/helpers/csvImporter.h>
+#include <backend/helpers/resultExporter.h>
+#include <backend/helpers/indexAdvisor.h>
+#include <backend/managers/queryManager.h>
+#include <backend/managers/jobManager.h>
 #include <backend/controller/controller.h>
 
 #include <LayoutManager.h>
 
 void DBManager::clear() {
+    DBBackup::ref().stop();
+    BlobTransfer::ref().stop();
+    IndexAdvisor::ref().stop();
+    CsvImporter::ref().stop();
+    ResultExporter::ref().stop();
+    QueryManager::ref().cancelAllQueries();
+    JobManager::ref().cancelAllJobs();
+    Controller::ref().clearResults();
+    DBHelper::ref().closeDBFile();
     m_databaseFilePathName.clear();
     m_databaseFileName.clear();
     m_databaseFilePath.clear();
     m_isLoaded = false;
 }
 
-void DBManager::newDatabaseFromMemory() {
+bool DBManager::newDatabaseFromMemory() {
     clear();
-    m_isLoaded = true;
+    if (DBHelper::ref().openMemoryDB()) {
+        Controller::ref().clearAnalyze();
+        m_isLoaded = true;
+    }
+    return m_isLoaded;
 }
 
 bool DBManager::newDatabaseFromFile(const std::string& vFilePathName) {
@@ -66,13 +86,16 @@ bool DBManager::loadDatabaseFromFile(const std::string& vFilePathName) {
         const auto filePathName = ez::file::simplifyFilePath(vFilePathName);
         if (DBHelper::ref().isFileASqlite3DB(filePathName)) {
             auto ps = ez::file::parsePathFileName(filePathName);
-            if (ps.isOk) {
+            // the connection stay opened until the database is closed or another one is loaded
+            if (ps.isOk && DBHelper::ref().openDBFile(filePathName)) {
                 Controller::ref().clearAnalyze();
                 if (Controller::ref().analyzeDatabase(filePathName)) {
                     m_databaseFilePathName = filePathName;
                     m_databaseFileName = ps.name;
                     m_databaseFilePath = ps.path;
                     m_isLoaded = true;
+                } else {
+                    DBHelper::ref().closeDBFile();
                 }
             }
         }
@@ -80,10 +103,47 @@ bool DBManager::loadDatabaseFromFile(const std::string& vFilePathName) {
     return m_isLoaded;
 }
 
+// the db is copied page by page in an in memory db, so the queries have no disk latency
+bool DBManager::loadDatabaseInMemory(const std::string& vFilePathName) {
+    clear();
+    const auto filePathName = ez::file::simplifyFilePath(vFilePathName);
+    if (!DBHelper::ref().isFileASqlite3DB(filePathName) || !DBHelper::ref().openMemoryDB()) {
+        return false;
+    }
+    return DBBackup::ref().start(DBBackup::Operation::LOAD_IN_MEMORY, filePathName, [this](DBBackup& vBackup) {
+        if (vBackup.getState() == DBBackup::State::DONE) {
+            LogVarInfo("%s loaded in memory in %.2f s", vBackup.getFilePathName().c_str(), vBackup.getElapsedMs() / 1000.0);
+            Controller::ref().clearAnalyze();
+            Controller::ref().analyzeDatabase({});
+            m_isLoaded = true;
+        } else {
+            LogVarError("Failed to load %s in memory : %s", vBackup.getFilePathName().c_str(), vBackup.getErrorMsg().c_str());
+            DBHelper::ref().closeDBFile();
+        }
+    });
+}
+
+bool DBManager::saveMemoryDatabaseToFile(const std::string& vFilePathName) {
+    if (!isDatabaseInMemory()) {
+        return false;
+    }
+    return DBBackup::ref().start(DBBackup::Operation::SAVE_TO_FILE, vFilePathName, [](DBBackup& vBackup) {
+        if (vBackup.getState() == DBBackup::State::DONE) {
+            LogVarInfo("Memory database saved in %s in %.2f s", vBackup.getFilePathName().c_str(), vBackup.getElapsedMs() / 1000.0);
+        } else {
+            LogVarError("Failed to save the memory database in %s : %s", vBackup.getFilePathName().c_str(), vBackup.getErrorMsg().c_str());
+        }
+    });
+}
+
 bool DBManager::isDatabaseLoaded() const {
     return m_isLoaded;
 }
 
+bool DBManager::isDatabaseInMemory() const {
+    return m_isLoaded && DBHelper::ref().isInMemory();
+}
+
 void DBManager::newFrame() {
 
 }
@@ -40,11 +40,14 @@ private:  // dont save
 
 public:
     void clear();
-    void newDatabaseFromMemory();
+    bool newDatabaseFromMemory();
     bool newDatabaseFromFile(const std::string& vFilePathName);
     bool loadDatabaseFromFile();
     bool loadDatabaseFromFile(const std::string& vFilePathName);
+    bool loadDatabaseInMemory(const std::string& vFilePathName);  // asynchronous, the db is loaded at the end of the copy
+    bool saveMemoryDatabaseToFile(const std::string& vFilePathName);  // asynchronous
     bool isDatabaseLoaded() const;
+    bool isDatabaseInMemory() const;
 
     void newFrame();
 
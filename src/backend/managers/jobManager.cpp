@@ -0,0 +1,192 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "jobManager.h"
+
+#include <backend/helpers/frameScheduler.h>
+
+#include <algorithm>
+
+thread_local size_t JobManager::s_workerIdx = SIZE_MAX;
+const size_t JobManager::s_minWorkersCount = 4U;
+
+bool JobManager::init() {
+    // a thread is kept for the ui
+    const size_t workersCount = std::max<size_t>(std::max<size_t>(std::thread::hardware_concurrency(), 2U) - 1U, s_minWorkersCount);
+    m_stopWorkers = false;
+    m_pendingJobsCount = 0U;
+    for (size_t idx = 0; idx < workersCount; ++idx) {
+        m_queues.push_back(std::make_unique<WorkerQueues>());
+    }
+    for (size_t idx = 0; idx < workersCount; ++idx) {
+        m_workers.emplace_back(&JobManager::m_workerLoop, this, idx);
+    }
+    return true;
+}
+
+void JobManager::unit() {
+    cancelAllJobs();
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopWorkers = true;
+    }
+    m_sleepCv.notify_all();
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    m_workers.clear();
+    m_queues.clear();
+    m_deleteCompletions();
+}
+
+JobPtr JobManager::pushJob(const Job::Priority vPriority, const Job::WorkFunctor& vWorkFunctor, const Job::CompletionFunctor& vCompletionFunctor) {
+    auto job = std::make_shared<Job>();
+    job->m_priority = vPriority;
+    job->m_workFunctor = vWorkFunctor;
+    job->m_completionFunctor = vCompletionFunctor;
+    if (m_queues.empty()) {  // not initialized
+        job->m_state = Job::State::CANCELED;
+        return job;
+    }
+    size_t queueIdx = s_workerIdx;
+    if (queueIdx >= m_queues.size()) {
+        queueIdx = m_nextQueueIdx++ % m_queues.size();
+    }
+    {
+        auto& queues = *m_queues.at(queueIdx);
+        std::lock_guard<std::mutex> lock(queues.mutex);
+        queues.jobs[static_cast<size_t>(vPriority)].push_back(job);
+        ++m_pendingJobsCount;
+    }
+    {
+        // taken to not lose the notification between the check and the wait of a worker
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCv.notify_one();
+    return job;
+}
+
+// the pending jobs stay in the queues, they are finished as canceled without execution
+void JobManager::cancelAllJobs() {
+    for (auto& pQueues : m_queues) {
+        std::lock_guard<std::mutex> lock(pQueues->mutex);
+        for (auto& jobs : pQueues->jobs) {
+            for (auto& job : jobs) {
+                job->cancel();
+            }
+        }
+    }
+}
+
+void JobManager::processCompletions() {
+    auto* pNode = m_completedJobs.exchange(nullptr, std::memory_order_acquire);
+    CompletionNode* pFirstFinished = nullptr;
+    while (pNode != nullptr) {
+        auto* pNext = pNode->pNext;
+        pNode->pNext = pFirstFinished;
+        pFirstFinished = pNode;
+        pNode = pNext;
+    }
+    while (pFirstFinished != nullptr) {
+        auto* pNext = pFirstFinished->pNext;
+        auto& job = *pFirstFinished->job;
+        if (job.m_completionFunctor) {
+            job.m_completionFunctor(job);
+        }
+        delete pFirstFinished;
+        pFirstFinished = pNext;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//// PRIVATE /////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////
+
+void JobManager::m_workerLoop(const size_t vWorkerIdx) {
+    s_workerIdx = vWorkerIdx;
+    while (true) {
+        const auto job = m_takeJob(vWorkerIdx);
+        if (job != nullptr) {
+            m_runJob(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepCv.wait(lock, [this]() { return m_stopWorkers || m_pendingJobsCount > 0U; });
+        if (m_stopWorkers) {
+            break;
+        }
+    }
+}
+
+// by priority : the newest job of its own queue, then the oldest job of the others
+JobPtr JobManager::m_takeJob(const size_t vWorkerIdx) {
+    const size_t queuesCount = m_queues.size();
+    for (size_t priority = 0; priority < static_cast<size_t>(Job::Priority::Count); ++priority) {
+        for (size_t offset = 0; offset < queuesCount; ++offset) {
+            auto& queues = *m_queues.at((vWorkerIdx + offset) % queuesCount);
+            std::lock_guard<std::mutex> lock(queues.mutex);
+            auto& jobs = queues.jobs[priority];
+            if (jobs.empty()) {
+                continue;
+            }
+            JobPtr job;
+            if (offset == 0U) {
+                job = std::move(jobs.back());
+                jobs.pop_back();
+            } else {
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            ++m_runningJobsCount;
+            --m_pendingJobsCount;
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobManager::m_runJob(const JobPtr& vJob) {
+    if (!vJob->m_cancelRequested) {
+        vJob->m_state = Job::State::RUNNING;
+        if (vJob->m_workFunctor) {
+            vJob->m_workFunctor(*vJob);
+        }
+    }
+    vJob->m_state = vJob->m_cancelRequested ? Job::State::CANCELED : Job::State::DONE;
+    m_pushCompletion(vJob);
+    --m_runningJobsCount;
+    FrameScheduler::ref().requestFrames();  // the completion is called at the next frame
+}
+
+void JobManager::m_pushCompletion(const JobPtr& vJob) {
+    auto* pNode = new CompletionNode{vJob, m_completedJobs.load(std::memory_order_relaxed)};
+    while (!m_completedJobs.compare_exchange_weak(pNode->pNext, pNode, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+void JobManager::m_deleteCompletions() {
+    auto* pNode = m_completedJobs.exchange(nullptr, std::memory_order_acquire);
+    while (pNode != nullptr) {
+        auto* pNext = pNode->pNext;
+        delete pNode;
+        pNode = pNext;
+    }
+}
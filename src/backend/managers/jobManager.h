@@ -0,0 +1,121 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <ezlibs/ezClass.hpp>
+#include <ezlibs/ezSingleton.hpp>
+
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+class Job;
+typedef std::shared_ptr<Job> JobPtr;
+
+// handle of a task executed by a worker of the JobManager. the job is also its cancellation token
+class Job {
+    friend class JobManager;
+
+public:
+    enum class Priority {  //
+        INTERACTIVE = 0,  // waited by the user, taken first
+        MAINTENANCE,  // stats, caches, ..
+        Count
+    };
+    enum class State {  //
+        PENDING = 0,
+        RUNNING,
+        DONE,
+        CANCELED
+    };
+    typedef std::function<void(Job&)> WorkFunctor;  // called in a worker, must check isCancelRequested in its long loops
+    typedef std::function<void(Job&)> CompletionFunctor;  // called in the ui thread, even if canceled
+
+private:
+    Priority m_priority{Priority::INTERACTIVE};
+    std::atomic<State> m_state{State::PENDING};
+    std::atomic<bool> m_cancelRequested{false};
+    WorkFunctor m_workFunctor;
+    CompletionFunctor m_completionFunctor;
+
+public:
+    Priority getPriority() const { return m_priority; }
+    State getState() const { return m_state; }
+    bool isFinished() const { return m_state >= State::DONE; }
+    void cancel() { m_cancelRequested = true; }  // a pending job will not be executed
+    bool isCancelRequested() const { return m_cancelRequested; }
+};
+
+// pool of workers sized to the hardware. each worker has its own queues, and steal the jobs of the others when its queues are empty.
+// the finished jobs are pushed in a lock free list, their completion functors are called once per frame in the ui thread
+class JobManager {
+    IMPLEMENT_SINGLETON(JobManager)
+    DISABLE_CONSTRUCTORS(JobManager)
+    DISABLE_DESTRUCTORS(JobManager)
+
+private:
+    struct WorkerQueues {
+        std::mutex mutex;
+        std::deque<JobPtr> jobs[static_cast<size_t>(Job::Priority::Count)];
+    };
+    struct CompletionNode {
+        JobPtr job;
+        CompletionNode* pNext{nullptr};
+    };
+    static thread_local size_t s_workerIdx;  // index of the worker running the current thread, else SIZE_MAX
+    static const size_t s_minWorkersCount;  // the imports, exports, backups, .. hold a worker until their end
+
+private:
+    std::vector<std::unique_ptr<WorkerQueues>> m_queues;  // by worker
+    std::vector<std::thread> m_workers;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCv;
+    std::atomic<size_t> m_pendingJobsCount{0U};
+    std::atomic<size_t> m_runningJobsCount{0U};
+    std::atomic<size_t> m_nextQueueIdx{0U};  // the jobs pushed by the ui thread are spread over the workers
+    std::atomic<bool> m_stopWorkers{false};
+    std::atomic<CompletionNode*> m_completedJobs{nullptr};  // the last finished first
+
+public:
+    bool init();
+    void unit();  // the running jobs are waited, the completions not called
+
+    // a job pushed from a worker go in the queues of this worker
+    JobPtr pushJob(const Job::Priority vPriority, const Job::WorkFunctor& vWorkFunctor, const Job::CompletionFunctor& vCompletionFunctor);
+    void cancelAllJobs();
+    size_t getWorkersCount() const { return m_workers.size(); }
+    bool isBusy() const { return (m_pendingJobsCount > 0U) || (m_runningJobsCount > 0U); }
+
+    // call the completion functors of the finished jobs, in the finish order. to call once per frame in the ui thread
+    void processCompletions();
+
+private:
+    void m_workerLoop(const size_t vWorkerIdx);
+    JobPtr m_takeJob(const size_t vWorkerIdx);
+    void m_runJob(const JobPtr& vJob);
+    void m_pushCompletion(const JobPtr& vJob);
+    void m_deleteCompletions();
+};
@@ -0,0 +1,254 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "queryManager.h"
+
+#include <backend/helpers/frameScheduler.h>
+
+#include <algorithm>
+
+double QueryJob::getElapsedMs() const {
+    if (m_state == State::PENDING) {
+        return 0.0;
+    } else if (m_state == State::RUNNING) {
+        const auto elapsed = std::chrono::steady_clock::now() - m_control.startTime;
+        return std::chrono::duration<double, std::milli>(elapsed).count();
+    }
+    return m_elapsedMs;
+}
+
+const size_t QueryManager::s_workersCount = 4U;
+
+bool QueryManager::init() {
+    unit();
+    m_stopWorker = false;
+    for (size_t i = 0; i < s_workersCount; ++i) {
+        m_workers.emplace_back(&QueryManager::m_workerLoop, this);
+    }
+    return true;
+}
+
+void QueryManager::unit() {
+    if (!m_workers.empty()) {
+        cancelAllQueries();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopWorker = true;
+        }
+        m_cv.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+        m_workers.clear();
+    }
+    m_pendingJobs.clear();
+    m_finishedJobs.clear();
+    m_runningJobs.clear();
+}
+
+QueryJobPtr QueryManager::pushQuery(const std::string& vSql, const int32_t vTimeoutMs, const QueryJob::CompletionFunctor& vCompletionFunctor) {
+    auto job = std::make_shared<QueryJob>();
+    job->m_sql = vSql;
+    job->m_control.timeoutMs = vTimeoutMs;
+    job->m_completionFunctor = vCompletionFunctor;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingJobs.push_back(job);
+    }
+    m_cv.notify_one();
+    return job;
+}
+
+QueryJobPtr QueryManager::pushCursorQuery(  //
+    const std::string& vSql,
+    const int32_t vTimeoutMs,
+    const bool vScriptInTransaction,
+    const bool vExplain,
+    std::unique_ptr<QueryCursor>&& vPreviousCursor,
+    const QueryJobPtr& vPreviousFetch,
+    const QueryJob::CompletionFunctor& vCompletionFunctor) {
+    auto job = std::make_shared<QueryJob>();
+    job->m_sql = vSql;
+    job->m_control.timeoutMs = vTimeoutMs;
+    job->m_scriptInTransaction = vScriptInTransaction;
+    job->m_explain = vExplain;
+    job->m_previousCursor = std::move(vPreviousCursor);
+    job->m_previousFetch = vPreviousFetch;
+    job->m_cursor = std::make_unique<QueryCursor>();
+    job->m_completionFunctor = vCompletionFunctor;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingJobs.push_back(job);
+    }
+    m_cv.notify_one();
+    return job;
+}
+
+QueryJobPtr QueryManager::pushCursorFetch(  //
+    QueryCursor* vpCursor,
+    const size_t vStart,
+    const size_t vEnd,
+    const int32_t vTimeoutMs,
+    const QueryJob::CompletionFunctor& vCompletionFunctor) {
+    auto job = std::make_shared<QueryJob>();
+    job->m_control.timeoutMs = vTimeoutMs;
+    job->m_fetchedCursor = vpCursor;
+    job->m_fetchStart = vStart;
+    job->m_fetchEnd = vEnd;
+    job->m_completionFunctor = vCompletionFunctor;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingJobs.push_back(job);
+    }
+    m_cv.notify_one();
+    return job;
+}
+
+void QueryManager::cancelQuery(const QueryJobPtr& vJob) {
+    if (vJob == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    vJob->m_control.cancelRequested = true;
+    if (std::find(m_runningJobs.begin(), m_runningJobs.end(), vJob) != m_runningJobs.end()) {
+        // interrupt only the connection running this query, the others can run queries of other jobs
+        vJob->m_control.interrupt();
+    } else {
+        auto it = std::find(m_pendingJobs.begin(), m_pendingJobs.end(), vJob);
+        if (it != m_pendingJobs.end()) {
+            vJob->m_state = QueryJob::State::CANCELED;
+            m_finishedJobs.push_back(vJob);
+            m_pendingJobs.erase(it);
+        }
+    }
+}
+
+void QueryManager::cancelQueryAndWait(const QueryJobPtr& vJob) {
+    if (vJob == nullptr) {
+        return;
+    }
+    cancelQuery(vJob);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finishedCv.wait(lock, [this, &vJob]() {  //
+        return std::find(m_runningJobs.begin(), m_runningJobs.end(), vJob) == m_runningJobs.end();
+    });
+}
+
+void QueryManager::cancelAllQueries() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& job : m_pendingJobs) {
+        job->m_control.cancelRequested = true;
+        job->m_state = QueryJob::State::CANCELED;
+        m_finishedJobs.push_back(job);
+    }
+    m_pendingJobs.clear();
+    for (auto& job : m_runningJobs) {
+        job->m_control.cancelRequested = true;
+        job->m_control.interrupt();
+    }
+}
+
+bool QueryManager::isBusy() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_runningJobs.empty() || !m_pendingJobs.empty();
+}
+
+void QueryManager::newFrame() {
+    std::vector<QueryJobPtr> finishedJobs;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        finishedJobs.swap(m_finishedJobs);
+    }
+    for (auto& job : finishedJobs) {
+        m_closePreviousCursor(*job);  // if canceled before its run
+        if (job->m_completionFunctor) {
+            job->m_completionFunctor(*job);
+        }
+    }
+}
+
+void QueryManager::m_workerLoop() {
+    while (true) {
+        QueryJobPtr job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_stopWorker || !m_pendingJobs.empty(); });
+            if (m_stopWorker) {
+                break;
+            }
+            job = m_pendingJobs.front();
+            m_pendingJobs.pop_front();
+            m_runningJobs.push_back(job);
+        }
+        m_runJob(*job);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_runningJobs.erase(std::find(m_runningJobs.begin(), m_runningJobs.end(), job));
+            m_finishedJobs.push_back(job);
+        }
+        m_finishedCv.notify_all();
+        FrameScheduler::ref().requestFrames();  // the completion is called at the next frame
+    }
+}
+
+void QueryManager::m_runJob(QueryJob& vJob) {
+    vJob.m_control.startTime = std::chrono::steady_clock::now();
+    vJob.m_state = QueryJob::State::RUNNING;
+    m_closePreviousCursor(vJob);
+    if (vJob.m_cursor != nullptr && DBHelper::ref().isScript(vJob.m_sql)) {
+        vJob.m_cursor.reset();
+        vJob.m_scriptResult = DBHelper::ref().executeScript(vJob.m_sql, vJob.m_scriptInTransaction, &vJob.m_control);
+    } else if (vJob.m_cursor != nullptr) {
+        if (vJob.m_explain) {
+            (void)QueryPlan::explain(vJob.m_sql, vJob.m_plan);  // no plan on error, the execution report it
+        }
+        if (!vJob.m_cursor->open(vJob.m_sql)) {
+            vJob.m_control.errorMsg = vJob.m_cursor->getLastErrorMsg();
+        } else if (vJob.m_cursor->isReadOnly()) {
+            vJob.m_cursor->fetch(0U, vJob.m_cursor->getBlockSize(), &vJob.m_control);
+        } else {
+            // a rewind would execute the writes again
+            vJob.m_cursor->materialize(&vJob.m_control);
+        }
+    } else if (vJob.m_fetchedCursor != nullptr) {
+        vJob.m_fetchedCursor->readBlocks(vJob.m_fetchStart, vJob.m_fetchEnd, &vJob.m_control);
+    } else {
+        vJob.m_result = DBHelper::ref().executeQuery(vJob.m_sql, &vJob.m_control);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - vJob.m_control.startTime;
+    vJob.m_elapsedMs = std::chrono::duration<double, std::milli>(elapsed).count();
+    vJob.m_errorMsg = vJob.m_control.errorMsg;
+    if (vJob.m_control.timedOut) {
+        vJob.m_state = QueryJob::State::TIMED_OUT;
+    } else if (vJob.m_control.cancelRequested) {
+        vJob.m_state = QueryJob::State::CANCELED;
+    } else if (!vJob.m_errorMsg.empty()) {
+        vJob.m_state = QueryJob::State::FAILED;
+    } else {
+        vJob.m_state = QueryJob::State::DONE;
+    }
+}
+
+void QueryManager::m_closePreviousCursor(QueryJob& vJob) {
+    if (vJob.m_previousCursor != nullptr) {
+        cancelQueryAndWait(vJob.m_previousFetch);
+        vJob.m_previousFetch.reset();
+        vJob.m_previousCursor.reset();
+    }
+}
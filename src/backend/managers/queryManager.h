@@ -0,0 +1,148 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <ezlibs/ezClass.hpp>
+#include <ezlibs/ezSingleton.hpp>
+#include <backend/helpers/dbHelper.h>
+#include <backend/helpers/queryCursor.h>
+#include <backend/helpers/queryPlan.h>
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+class QueryJob;
+typedef std::shared_ptr<QueryJob> QueryJobPtr;
+
+// handle of a query executed by a db worker thread
+class QueryJob {
+    friend class QueryManager;
+
+public:
+    enum class State {  //
+        PENDING = 0,
+        RUNNING,
+        DONE,
+        FAILED,
+        CANCELED,
+        TIMED_OUT
+    };
+    typedef std::function<void(QueryJob&)> CompletionFunctor;  // called in the ui thread
+
+private:
+    std::string m_sql;
+    QueryControl m_control;
+    std::atomic<State> m_state{State::PENDING};
+    QueryResult m_result;
+    std::unique_ptr<QueryCursor> m_cursor;  // only for the cursor queries
+    std::unique_ptr<QueryCursor> m_previousCursor;  // closed before the query, it can lock the tables
+    QueryJobPtr m_previousFetch;  // of m_previousCursor, ended before its close
+    bool m_explain{false};
+    QueryPlan m_plan;  // taken before the execution if m_explain, it would fail after a CREATE or a DROP
+    QueryCursor* m_fetchedCursor{nullptr};  // only for the cursor fetches, not owned
+    size_t m_fetchStart{0U};
+    size_t m_fetchEnd{0U};
+    bool m_scriptInTransaction{false};
+    ScriptResult m_scriptResult;  // filled instead of the cursor when the sql contain many statements
+    std::string m_errorMsg;
+    double m_elapsedMs{0.0};
+    CompletionFunctor m_completionFunctor;
+
+public:
+    const std::string& getSql() const { return m_sql; }
+    State getState() const { return m_state; }
+    bool isFinished() const { return m_state >= State::DONE; }
+    bool isSucceeded() const { return m_state == State::DONE; }
+    size_t getRowsCount() const { return m_control.rowsCount; }
+    double getElapsedMs() const;  // live value while running
+    QueryResult& getResultRef() { return m_result; }
+    std::unique_ptr<QueryCursor> takeCursor() { return std::move(m_cursor); }
+    bool isScript() const { return m_scriptResult.isValid(); }
+    QueryPlan takePlan() { return std::move(m_plan); }
+    ScriptResult takeScriptResult() { return std::move(m_scriptResult); }
+    const std::string& getErrorMsg() const { return m_errorMsg; }
+};
+
+class QueryManager {
+    IMPLEMENT_SINGLETON(QueryManager)
+    DISABLE_CONSTRUCTORS(QueryManager)
+    DISABLE_DESTRUCTORS(QueryManager)
+
+private:
+    // the read queries of many workers run in parallel on the read connections of DBHelper,
+    // the others are serialized by the writer connection
+    static const size_t s_workersCount;
+
+private:
+    std::vector<std::thread> m_workers;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::condition_variable m_finishedCv;  // a running job is finished
+    std::deque<QueryJobPtr> m_pendingJobs;
+    std::vector<QueryJobPtr> m_finishedJobs;
+    std::vector<QueryJobPtr> m_runningJobs;
+    bool m_stopWorker{false};
+
+public:
+    bool init();
+    void unit();
+
+    // vTimeoutMs : 0 => no timeout
+    QueryJobPtr pushQuery(const std::string& vSql, const int32_t vTimeoutMs, const QueryJob::CompletionFunctor& vCompletionFunctor);
+    // the statement is kept open in a cursor, only the first block of rows is fetched by the worker.
+    // if the sql contain many statements, they are all executed as a script with materialized results.
+    // vPreviousCursor is closed by the worker, after the end of vPreviousFetch, so the ui never wait the writer.
+    // vExplain : the plan of a single statement is taken before its execution
+    QueryJobPtr pushCursorQuery(  //
+        const std::string& vSql,
+        const int32_t vTimeoutMs,
+        const bool vScriptInTransaction,
+        const bool vExplain,
+        std::unique_ptr<QueryCursor>&& vPreviousCursor,
+        const QueryJobPtr& vPreviousFetch,
+        const QueryJob::CompletionFunctor& vCompletionFunctor);
+    // read the rows [vStart, vEnd) of an opened cursor, applied in the window by QueryCursor::applyBlocks
+    // in the completion. the cursor must live until the job is finished, see cancelQueryAndWait
+    QueryJobPtr pushCursorFetch(  //
+        QueryCursor* vpCursor,
+        const size_t vStart,
+        const size_t vEnd,
+        const int32_t vTimeoutMs,
+        const QueryJob::CompletionFunctor& vCompletionFunctor);
+    void cancelQuery(const QueryJobPtr& vJob);
+    void cancelQueryAndWait(const QueryJobPtr& vJob);  // return once the job is not running
+    void cancelAllQueries();
+    bool isBusy() const;
+
+    // call the completion functors of the finished jobs, to call at frame start in the ui thread
+    void newFrame();
+
+private:
+    void m_workerLoop();
+    void m_runJob(QueryJob& vJob);
+    void m_closePreviousCursor(QueryJob& vJob);
+};
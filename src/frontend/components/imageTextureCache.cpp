@@ -0,0 +1,197 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "imageTextureCache.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+const size_t ImageTextureCache::s_bytesBudget = 256U * 1024U * 1024U;
+const size_t ImageTextureCache::s_maxEntriesCount = 256U;
+const size_t ImageTextureCache::s_maxBlobSize = 64U * 1024U * 1024U;
+const int32_t ImageTextureCache::s_maxTextureSize = 4096;  // 64 MB in rgba
+
+const ImageTextureCache::Entry* ImageTextureCache::get(const Key& vKey) {
+    auto it = m_slots.find(vKey);
+    if (it == m_slots.end()) {
+        return nullptr;
+    }
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lruIt);
+    return &it->second.entry;
+}
+
+const ImageTextureCache::Entry& ImageTextureCache::request(const Key& vKey, std::string&& vDatas) {
+    return m_request(vKey, std::move(vDatas), {}, 0U, false);
+}
+
+const ImageTextureCache::Entry& ImageTextureCache::request(const Key& vKey, const BlobLocator& vLocator, const size_t vSize) {
+    return m_request(vKey, {}, vLocator, vSize, true);
+}
+
+void ImageTextureCache::clear() {
+    while (!m_slots.empty()) {
+        m_erase(m_slots.begin());
+    }
+    m_bytesCount = 0U;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//// PRIVATE /////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////
+
+const ImageTextureCache::Entry& ImageTextureCache::m_request(  //
+    const Key& vKey,
+    std::string&& vDatas,
+    const BlobLocator& vLocator,
+    const size_t vSize,
+    const bool vIsLocated) {
+    const auto* pEntry = get(vKey);
+    if (pEntry != nullptr) {
+        return *pEntry;
+    }
+    for (auto it = m_slots.begin(); it != m_slots.end();) {
+        auto itNext = std::next(it);
+        if (it->second.job != nullptr) {
+            m_erase(it);
+        }
+        it = itNext;
+    }
+    if (m_maxTextureSize == 0) {
+        GLint maxTextureSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+        m_maxTextureSize = std::min<int32_t>(std::max<GLint>(maxTextureSize, 1024), s_maxTextureSize);
+    }
+    auto& slot = m_slots[vKey];
+    m_lru.push_front(vKey);
+    slot.lruIt = m_lru.begin();
+    auto pDecoding = std::make_shared<Decoding>();
+    pDecoding->datas = std::move(vDatas);
+    pDecoding->locator = vLocator;
+    pDecoding->size = vSize;
+    pDecoding->isLocated = vIsLocated;
+    const int32_t maxTextureSize = m_maxTextureSize;
+    slot.job = JobManager::ref().pushJob(  //
+        Job::Priority::INTERACTIVE,
+        [pDecoding, maxTextureSize](Job& vJob) {
+            auto& decoding = *pDecoding;
+            if (decoding.isLocated) {
+                if (decoding.size > s_maxBlobSize) {
+                    decoding.errorMsg = "The blob is too big for be previewed";
+                    return;
+                }
+                // read by chunks, the cancel is checked between them
+                static const size_t s_chunkSize = 1024U * 1024U;
+                decoding.datas.resize(decoding.size);
+                size_t offset = 0U;
+                while (offset < decoding.size && !vJob.isCancelRequested()) {
+                    const size_t count = std::min(s_chunkSize, decoding.size - offset);
+                    const auto status = DBHelper::ref().readBlob(decoding.locator, offset, &decoding.datas[offset], count, &decoding.errorMsg);
+                    if (status == BlobReadStatus::BUSY) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));  // the writer is locked
+                    } else if (status == BlobReadStatus::SUCCESS) {
+                        offset += count;
+                    } else {
+                        return;
+                    }
+                }
+            }
+            if (vJob.isCancelRequested()) {
+                return;
+            }
+            const auto* pDatas = reinterpret_cast<const uint8_t*>(decoding.datas.data());
+            if (ImageDecoder::decode(pDatas, decoding.datas.size(), decoding.image, &decoding.errorMsg)) {
+                decoding.imageWidth = decoding.image.width;
+                decoding.imageHeight = decoding.image.height;
+                ImageDecoder::downscale(decoding.image, maxTextureSize);
+            }
+            decoding.datas.clear();
+            decoding.datas.shrink_to_fit();
+        },
+        [this, vKey, pDecoding](Job& vJob) {  //
+            m_onDecoded(vKey, vJob, *pDecoding);
+        });
+    m_evict(vKey);
+    return slot.entry;
+}
+
+// in the ui thread
+void ImageTextureCache::m_onDecoded(const Key& vKey, Job& vJob, Decoding& vDecoding) {
+    auto it = m_slots.find(vKey);
+    if (it == m_slots.end() || it->second.job.get() != &vJob) {
+        return;  // erased or cleared meanwhile
+    }
+    auto& slot = it->second;
+    slot.job.reset();
+    if (vJob.getState() == Job::State::CANCELED) {
+        m_erase(it);
+        return;
+    }
+    auto& entry = slot.entry;
+    auto& image = vDecoding.image;
+    if (image.rgba.empty()) {
+        entry.state = State::FAILED;
+        entry.errorMsg = vDecoding.errorMsg.empty() ? "Failed to decode the image" : vDecoding.errorMsg;
+        return;
+    }
+    GLuint texture = 0U;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.rgba.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+    entry.state = State::READY;
+    entry.texture = texture;
+    entry.imageWidth = vDecoding.imageWidth;
+    entry.imageHeight = vDecoding.imageHeight;
+    entry.textureWidth = image.width;
+    entry.textureHeight = image.height;
+    m_bytesCount += static_cast<size_t>(image.width) * static_cast<size_t>(image.height) * 4U;
+    image = {};
+    m_evict(vKey);
+}
+
+void ImageTextureCache::m_erase(std::map<Key, Slot>::iterator vIt) {
+    auto& slot = vIt->second;
+    if (slot.job != nullptr) {
+        slot.job->cancel();
+    }
+    if (slot.entry.texture != 0U) {
+        const auto texture = static_cast<GLuint>(slot.entry.texture);
+        glDeleteTextures(1, &texture);
+        m_bytesCount -= static_cast<size_t>(slot.entry.textureWidth) * static_cast<size_t>(slot.entry.textureHeight) * 4U;
+    }
+    m_lru.erase(slot.lruIt);
+    m_slots.erase(vIt);
+}
+
+// the least recently shown first, vKeptKey is kept even if it exceed the budget alone
+void ImageTextureCache::m_evict(const Key& vKeptKey) {
+    while ((m_bytesCount > s_bytesBudget || m_slots.size() > s_maxEntriesCount) && m_lru.size() > 1U) {
+        const Key key = (m_lru.back() != vKeptKey) ? m_lru.back() : *std::prev(m_lru.end(), 2);
+        m_erase(m_slots.find(key));
+    }
+}
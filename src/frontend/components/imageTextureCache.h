@@ -0,0 +1,93 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <backend/helpers/dbHelper.h>
+#include <backend/helpers/imageDecoder.h>
+#include <backend/managers/jobManager.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <list>
+#include <map>
+
+// textures of the images previewed from the blobs. the blobs are read and decoded by the workers of the JobManager,
+// then uploaded in the ui thread. the least recently shown textures are deleted when they exceed the bytes budget
+class ImageTextureCache {
+public:
+    typedef std::pair<int32_t, int32_t> Key;  // row and column of the cell in the shown result
+    enum class State {  //
+        DECODING = 0,
+        READY,
+        FAILED
+    };
+    struct Entry {
+        State state{State::DECODING};
+        uint32_t texture{0U};  // gl texture, 0 if not ready
+        int32_t imageWidth{0};
+        int32_t imageHeight{0};
+        int32_t textureWidth{0};  // smaller than the image if it was downscaled
+        int32_t textureHeight{0};
+        std::string errorMsg;
+    };
+
+private:
+    static const size_t s_bytesBudget;  // of the textures
+    static const size_t s_maxEntriesCount;  // the failed and decoding entries are counted too
+    static const size_t s_maxBlobSize;  // bigger blobs are not previewed
+    static const int32_t s_maxTextureSize;  // the bigger images are downscaled
+    // shared by the worker and the completion
+    struct Decoding {
+        std::string datas;
+        BlobLocator locator;
+        size_t size{0U};
+        bool isLocated{false};
+        ImageDecoder::Image image;
+        int32_t imageWidth{0};  // before the downscale
+        int32_t imageHeight{0};
+        std::string errorMsg;
+    };
+    struct Slot {
+        Entry entry;
+        JobPtr job;  // null once finished
+        std::list<Key>::iterator lruIt;
+    };
+    std::map<Key, Slot> m_slots;
+    std::list<Key> m_lru;  // the most recently shown first
+    size_t m_bytesCount{0U};
+    int32_t m_maxTextureSize{0};  // of the gl driver and s_maxTextureSize
+
+public:
+    // the entry of a cell, and mark it as the most recently shown. nullptr if not requested
+    const Entry* get(const Key& vKey);
+    // decode the blob in a worker, the others decodings are canceled : only the shown image is needed
+    const Entry& request(const Key& vKey, std::string&& vDatas);  // already loaded
+    const Entry& request(const Key& vKey, const BlobLocator& vLocator, const size_t vSize);  // read in the worker
+    // delete the textures, to call in the ui thread while the gl context exist
+    void clear();
+    size_t getBytesCount() const { return m_bytesCount; }
+
+private:
+    const Entry& m_request(const Key& vKey, std::string&& vDatas, const BlobLocator& vLocator, const size_t vSize, const bool vIsLocated);
+    void m_onDecoded(const Key& vKey, Job& vJob, Decoding& vDecoding);
+    void m_erase(std::map<Key, Slot>::iterator vIt);
+    void m_evict(const Key& vKeptKey);
+};
@@ -0,0 +1,143 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "jsonViewer.h"
+
+const size_t JsonViewer::s_maxPreviewSize = 256U;
+
+void JsonViewer::setTree(JsonTree&& vTree, const std::string& vBuildErrorMsg) {
+    clear();
+    m_errorMsg = vBuildErrorMsg;
+    if (vTree.isEmpty()) {
+        return;
+    }
+    m_tree = std::move(vTree);
+    Row root;
+    root.node = m_tree.getRoot();
+    m_rows.push_back(root);
+    m_expand(0U);
+}
+
+void JsonViewer::clear() {
+    m_tree.clear();
+    m_rows.clear();
+    m_rows.shrink_to_fit();  // may be big
+    m_children.clear();
+    m_children.shrink_to_fit();
+    m_errorMsg.clear();
+}
+
+// the children are inserted after their parent, the nested ones after them when expanded
+void JsonViewer::m_expand(const size_t vRowIdx) {
+    if (m_rows[vRowIdx].isExpanded) {
+        return;
+    }
+    m_tree.getChildren(m_rows[vRowIdx].node, m_children, &m_errorMsg);  // the children before an error are shown
+    const uint32_t depth = m_rows[vRowIdx].depth + 1U;
+    m_rows.insert(m_rows.begin() + static_cast<ptrdiff_t>(vRowIdx) + 1, m_children.size(), Row{});
+    for (size_t i = 0U; i < m_children.size(); ++i) {
+        auto& row = m_rows[vRowIdx + 1U + i];
+        row.node = m_children[i];
+        row.depth = depth;
+        row.itemIdx = static_cast<uint32_t>(i);
+    }
+    auto& row = m_rows[vRowIdx];
+    row.childrenCount = static_cast<uint32_t>(m_children.size());
+    row.isCountKnown = true;
+    row.isExpanded = true;
+}
+
+void JsonViewer::m_collapse(const size_t vRowIdx) {
+    const uint32_t depth = m_rows[vRowIdx].depth;
+    size_t end = vRowIdx + 1U;
+    while (end < m_rows.size() && m_rows[end].depth > depth) {
+        ++end;
+    }
+    m_rows.erase(m_rows.begin() + static_cast<ptrdiff_t>(vRowIdx) + 1, m_rows.begin() + static_cast<ptrdiff_t>(end));
+    m_rows[vRowIdx].isExpanded = false;
+}
+
+void JsonViewer::draw() {
+    if (ImGui::SmallContrastedButton("Collapse all") && !m_rows.empty()) {
+        m_collapse(0U);
+        m_expand(0U);
+    }
+    if (!m_errorMsg.empty()) {
+        ImGui::SameLine();
+        ImGui::TextColored(ImGui::CustomStyle::BadColor, "%s", m_errorMsg.c_str());
+    }
+    if (ImGui::BeginChild("##JsonTree", ImVec2(0.0f, 0.0f), ImGuiChildFlags_None, ImGuiWindowFlags_HorizontalScrollbar)) {
+        static ImGuiTreeNodeFlags leaf = ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+        // the open state is kept in the rows, they are not nested in the imgui tree
+        static ImGuiTreeNodeFlags tflags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+        const float indentSpacing = ImGui::GetStyle().IndentSpacing;
+        size_t toggledRowIdx = SIZE_MAX;  // applied after the clipper, the rows are moved by it
+        m_clipper.Begin(static_cast<int>(m_rows.size()), ImGui::GetTextLineHeightWithSpacing());
+        while (m_clipper.Step()) {
+            for (int i = m_clipper.DisplayStart; i < m_clipper.DisplayEnd; ++i) {
+                const auto& row = m_rows[static_cast<size_t>(i)];
+                const float indent = indentSpacing * static_cast<float>(row.depth);
+                if (indent > 0.0f) {
+                    ImGui::Indent(indent);
+                }
+                ImGui::PushID(i);
+                std::string label;
+                if (row.node.hasKey) {
+                    label = m_tree.getKeyPreview(row.node, s_maxPreviewSize);
+                } else if (row.depth > 0U) {
+                    label = "[" + std::to_string(row.itemIdx) + "]";
+                } else {
+                    label = "$";  // the root, as in the json paths of sqlite
+                }
+                if (row.node.isContainer()) {
+                    ImGui::SetNextItemOpen(row.isExpanded);
+                    if (ImGui::TreeNodeEx("##node", tflags, "%s", label.c_str()) != row.isExpanded) {
+                        toggledRowIdx = static_cast<size_t>(i);
+                    }
+                    ImGui::SameLine();
+                    const bool isObject = (row.node.type == JsonTree::NodeType::OBJECT);
+                    if (row.isCountKnown) {
+                        ImGui::TextDisabled(isObject ? "{%u}" : "[%u]", row.childrenCount);
+                    } else {
+                        ImGui::TextDisabled("%s", m_tree.getValuePreview(row.node, s_maxPreviewSize).c_str());
+                    }
+                    ImGui::SameLine();
+                    ImGui::TextDisabled("%u bytes", row.node.valueSize);
+                } else {
+                    ImGui::TreeNodeEx("##node", leaf, "%s", label.c_str());
+                    ImGui::SameLine();
+                    ImGui::TextUnformatted(m_tree.getValuePreview(row.node, s_maxPreviewSize).c_str());
+                }
+                ImGui::PopID();
+                if (indent > 0.0f) {
+                    ImGui::Unindent(indent);
+                }
+            }
+        }
+        m_clipper.End();
+        if (toggledRowIdx != SIZE_MAX) {
+            if (m_rows[toggledRowIdx].isExpanded) {
+                m_collapse(toggledRowIdx);
+            } else {
+                m_expand(toggledRowIdx);
+            }
+        }
+    }
+    ImGui::EndChild();
+}
@@ -0,0 +1,61 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <imguipack.h>
+#include <backend/helpers/jsonTree.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// tree view of a json text or of a jsonb blob. the rows exist only for the expanded nodes,
+// and only the visible ones are drawn, so the first paint don't depend on the value size
+class JsonViewer {
+private:
+    static const size_t s_maxPreviewSize;  // bytes of a key or of a scalar on its row
+    struct Row {
+        JsonTree::Node node;
+        uint32_t depth{0U};
+        uint32_t itemIdx{0U};  // in its array
+        uint32_t childrenCount{0U};  // known once expanded
+        bool isCountKnown{false};
+        bool isExpanded{false};
+    };
+    JsonTree m_tree;
+    std::vector<Row> m_rows;  // in the display order
+    std::vector<JsonTree::Node> m_children;  // reused by the expansions
+    std::string m_errorMsg;
+    ImGuiListClipper m_clipper;
+
+public:
+    // the tree is built in a worker, empty if its build failed with vBuildErrorMsg.
+    // its datas are not copied, they must live with the viewer. the root is expanded
+    void setTree(JsonTree&& vTree, const std::string& vBuildErrorMsg);
+    void clear();
+    bool isEmpty() const { return m_rows.empty(); }
+    const std::string& getErrorMsg() const { return m_errorMsg; }
+    void draw();
+
+private:
+    void m_expand(const size_t vRowIdx);
+    void m_collapse(const size_t vRowIdx);
+};
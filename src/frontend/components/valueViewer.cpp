@@ -0,0 +1,568 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "valueViewer.h"
+#include <backend/helpers/hexEncoder.h>
+#include <backend/helpers/frameScheduler.h>
+
+#include <thread>
+#include <chrono>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+
+const size_t ValueViewer::s_maxLineSize = 4096U;
+const size_t ValueViewer::s_wrapBytesPerFrame = 64U * 1024U;
+const size_t ValueViewer::s_blobPageSize = 65536U;
+const size_t ValueViewer::s_maxBlobPages = 16U;
+const size_t ValueViewer::s_bytesPerHexLine = 16U;
+const size_t ValueViewer::s_maxJsonbSize = 256U * 1024U * 1024U;
+
+// the line starts, with the chunks of the long lines
+static void s_indexLines(const std::string& vText, const size_t vMaxLineSize, std::vector<size_t>& vOutLineStarts) {
+    const char* begin = vText.data();
+    const char* end = begin + vText.size();
+    const char* lineStart = begin;
+    while (lineStart < end) {
+        vOutLineStarts.push_back(static_cast<size_t>(lineStart - begin));
+        const size_t remaining = static_cast<size_t>(end - lineStart);
+        const auto* eol = static_cast<const char*>(std::memchr(lineStart, '\n', std::min(remaining, vMaxLineSize)));
+        if (eol != nullptr) {
+            lineStart = eol + 1;
+        } else if (remaining > vMaxLineSize) {
+            // a chunk of a long line, cut on a utf8 char start
+            const char* cut = lineStart + vMaxLineSize;
+            while (cut > lineStart && (static_cast<uint8_t>(*cut) & 0xC0) == 0x80) {
+                --cut;
+            }
+            lineStart = (cut > lineStart) ? cut : lineStart + vMaxLineSize;
+        } else {
+            break;
+        }
+    }
+}
+
+// read by chunks, the cancel is checked between them
+static bool s_readLocated(const BlobLocator& vLocator, const size_t vSize, Job& vJob, std::string& vOutDatas, std::string* vpOutErrorMsg) {
+    static const size_t s_chunkSize = 1024U * 1024U;
+    vOutDatas.resize(vSize);
+    size_t offset = 0U;
+    while (offset < vSize && !vJob.isCancelRequested()) {
+        const size_t count = std::min(s_chunkSize, vSize - offset);
+        const auto status = DBHelper::ref().readBlob(vLocator, offset, &vOutDatas[offset], count, vpOutErrorMsg);
+        if (status == BlobReadStatus::BUSY) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));  // the writer is locked
+        } else if (status == BlobReadStatus::SUCCESS) {
+            offset += count;
+        } else {
+            return false;
+        }
+    }
+    return !vJob.isCancelRequested();
+}
+
+void ValueViewer::setText(std::string&& vText) {
+    clear();
+    m_text = std::move(vText);
+    m_isJson = JsonTree::isJsonText(m_text);
+    s_indexLines(m_text, s_maxLineSize, m_lineStarts);
+}
+
+void ValueViewer::setText(const BlobLocator& vLocator, const size_t vSize) {
+    clear();
+    auto pLoading = std::make_shared<TextLoading>();
+    pLoading->locator = vLocator;
+    pLoading->size = vSize;
+    m_textLoading = pLoading;
+    m_textJob = JobManager::ref().pushJob(  //
+        Job::Priority::INTERACTIVE,
+        [pLoading](Job& vJob) {
+            auto& loading = *pLoading;
+            if (s_readLocated(loading.locator, loading.size, vJob, loading.text, &loading.errorMsg)) {
+                loading.isJson = JsonTree::isJsonText(loading.text);
+                s_indexLines(loading.text, s_maxLineSize, loading.lineStarts);
+            }
+        },
+        [this, pLoading](Job& vJob) {
+            if (m_textLoading != pLoading) {
+                return;  // the value was changed
+            }
+            m_textJob.reset();
+            m_textLoading.reset();
+            if (vJob.getState() == Job::State::CANCELED) {
+                m_textErrorMsg = "The read of the text was canceled";
+            } else if (!pLoading->errorMsg.empty()) {
+                m_textErrorMsg = pLoading->errorMsg;
+            } else {
+                m_text = std::move(pLoading->text);
+                m_lineStarts = std::move(pLoading->lineStarts);
+                m_isJson = pLoading->isJson;
+            }
+        });
+}
+
+void ValueViewer::setBlob(std::string&& vDatas, const ImageTextureCache::Key& vImageKey) {
+    clear();
+    m_isBlob = true;
+    m_blobSize = vDatas.size();
+    m_imageKey = vImageKey;
+    m_imageFormat = ImageDecoder::detectFormat(reinterpret_cast<const uint8_t*>(vDatas.data()), vDatas.size());
+    m_isJson = JsonTree::isJsonb(reinterpret_cast<const uint8_t*>(vDatas.data()), vDatas.size(), vDatas.size()) && vDatas.size() <= s_maxJsonbSize;
+    m_isBlobFormatKnown = true;
+    for (size_t offset = 0U; offset < vDatas.size(); offset += s_blobPageSize) {
+        m_blobPages[offset / s_blobPageSize] = vDatas.substr(offset, s_blobPageSize);
+    }
+}
+
+void ValueViewer::setBlob(const BlobLocator& vLocator, const size_t vSize, const ImageTextureCache::Key& vImageKey) {
+    clear();
+    m_isBlob = true;
+    m_blobLocator = vLocator;
+    m_isBlobLocated = true;
+    m_blobSize = vSize;
+    m_imageKey = vImageKey;
+}
+
+void ValueViewer::setBlobError(const size_t vSize, const std::string& vErrorMsg) {
+    clear();
+    m_isBlob = true;
+    m_blobSize = vSize;
+    m_blobErrorMsg = vErrorMsg;
+}
+
+void ValueViewer::clear() {
+    if (m_textJob != nullptr) {
+        m_textJob->cancel();
+        m_textJob.reset();
+    }
+    m_textLoading.reset();
+    m_textErrorMsg.clear();
+    m_jsonViewer.clear();  // before its datas
+    if (m_jsonJob != nullptr) {
+        m_jsonJob->cancel();
+        m_jsonJob.reset();
+    }
+    m_jsonLoading.reset();  // the job keep its own ref until its end
+    m_isJson = false;
+    m_isBlob = false;
+    m_blobLocator = {};
+    m_isBlobLocated = false;
+    m_blobSize = 0U;
+    m_blobPages.clear();
+    m_blobErrorMsg.clear();
+    m_imageKey = {-1, -1};
+    m_imageFormat = ImageDecoder::Format::NONE;
+    m_isBlobFormatKnown = false;
+    m_text.clear();
+    m_text.shrink_to_fit();  // may be big
+    m_lineStarts.clear();
+    m_wrappedLineStarts.clear();
+    m_wrappedLineEnds.clear();
+    m_wrapWidth = -1.0f;
+    m_wrapNextLine = 0U;
+    m_matchPos = std::string::npos;
+    m_matchSize = 0U;
+    m_scrollToMatch = false;
+    m_matchNotFound = false;
+}
+
+void ValueViewer::clearImages() {
+    m_imageCache.clear();
+}
+
+size_t ValueViewer::m_getLineEnd(const std::vector<size_t>& vLineStarts, const size_t vIdx) const {
+    size_t end = (vIdx + 1U < vLineStarts.size()) ? vLineStarts[vIdx + 1U] : m_text.size();
+    while (end > vLineStarts[vIdx] && (m_text[end - 1U] == '\n' || m_text[end - 1U] == '\r')) {
+        --end;
+    }
+    return end;
+}
+
+void ValueViewer::m_resetWrappedLines(const float vWidth) {
+    m_wrappedLineStarts.clear();
+    m_wrappedLineEnds.clear();
+    m_wrapWidth = vWidth;
+    m_wrapNextLine = 0U;
+}
+
+// CalcWordWrapPosition can bake glyphs in the font atlas, so it stay in the ui thread.
+// the lines already wrapped are shown while the next ones are wrapped in the next frames
+void ValueViewer::m_wrapLines() {
+    if (m_wrapNextLine >= m_lineStarts.size()) {
+        return;
+    }
+    auto* fontPtr = ImGui::GetFont();
+    const float fontSize = ImGui::GetFontSize();
+    const char* text = m_text.data();
+    size_t wrappedBytes = 0U;
+    while (m_wrapNextLine < m_lineStarts.size() && wrappedBytes < s_wrapBytesPerFrame) {
+        const size_t i = m_wrapNextLine++;
+        const char* lineEnd = text + m_getLineEnd(m_lineStarts, i);
+        const char* begin = text + m_lineStarts[i];
+        wrappedBytes += static_cast<size_t>(lineEnd - begin) + 1U;
+        do {
+            m_wrappedLineStarts.push_back(static_cast<size_t>(begin - text));
+            const char* end = fontPtr->CalcWordWrapPosition(fontSize, begin, lineEnd, m_wrapWidth);
+            if (end <= begin) {  // at least one char by line
+                end = std::min(begin + 1, lineEnd);
+            }
+            m_wrappedLineEnds.push_back(static_cast<size_t>(end - text));
+            begin = end;
+            while (begin < lineEnd && *begin == ' ') {
+                ++begin;
+            }
+        } while (begin < lineEnd);
+    }
+    if (m_wrapNextLine < m_lineStarts.size()) {
+        FrameScheduler::ref().requestFrames();
+    }
+}
+
+void ValueViewer::m_find(const bool vForward) {
+    const std::string_view needle(m_searchBuffer);
+    m_matchNotFound = false;
+    if (needle.empty()) {
+        m_matchPos = std::string::npos;
+        return;
+    }
+    const std::string_view text(m_text);
+    size_t pos = std::string::npos;
+    if (vForward) {
+        const size_t from = (m_matchPos == std::string::npos) ? 0U : m_matchPos + 1U;
+        pos = text.find(needle, from);
+        if (pos == std::string::npos && from > 0U) {  // loop to the start
+            pos = text.find(needle);
+        }
+    } else {
+        if (m_matchPos != std::string::npos && m_matchPos > 0U) {
+            pos = text.rfind(needle, m_matchPos - 1U);
+        }
+        if (pos == std::string::npos) {  // loop to the end
+            pos = text.rfind(needle);
+        }
+    }
+    m_matchPos = pos;
+    m_matchSize = needle.size();
+    m_matchNotFound = (pos == std::string::npos);
+    m_scrollToMatch = !m_matchNotFound;
+}
+
+void ValueViewer::draw() {
+    if (m_isBlob) {
+        m_drawBlob();
+    } else if (m_textLoading != nullptr) {
+        ImGui::TextDisabled("Reading the text of %zu bytes..", m_textLoading->size);
+    } else if (!m_textErrorMsg.empty()) {
+        ImGui::TextColored(ImGui::CustomStyle::BadColor, "%s", m_textErrorMsg.c_str());
+    } else if (!m_text.empty()) {
+        if (m_isJson) {
+            if (ImGui::RadioButton("JSON", !m_showRawJson)) {
+                m_showRawJson = false;
+            }
+            ImGui::SameLine();
+            if (ImGui::RadioButton("Text", m_showRawJson)) {
+                m_showRawJson = true;
+            }
+            ImGui::SameLine();
+            if (!m_showRawJson) {
+                m_drawJson();
+                return;
+            }
+        }
+        m_drawText();
+    }
+}
+
+const std::string* ValueViewer::m_getBlobPage(const size_t vPageIdx) {
+    auto it = m_blobPages.find(vPageIdx);
+    if (it != m_blobPages.end()) {
+        return &it->second;
+    }
+    if (!m_isBlobLocated || !m_blobErrorMsg.empty()) {
+        return nullptr;
+    }
+    const size_t offset = vPageIdx * s_blobPageSize;
+    std::string page(std::min(s_blobPageSize, m_blobSize - offset), '\0');
+    const auto status = DBHelper::ref().readBlob(m_blobLocator, offset, &page[0], page.size(), &m_blobErrorMsg);
+    if (status == BlobReadStatus::BUSY) {
+        FrameScheduler::ref().requestFrames();  // tried again at the next frame
+        return nullptr;
+    } else if (status != BlobReadStatus::SUCCESS) {
+        return nullptr;
+    }
+    if (m_blobPages.size() >= s_maxBlobPages) {
+        const auto first = m_blobPages.begin();
+        const auto last = std::prev(m_blobPages.end());
+        if (vPageIdx - std::min(vPageIdx, first->first) > last->first - std::min(last->first, vPageIdx)) {
+            m_blobPages.erase(first);
+        } else {
+            m_blobPages.erase(last);
+        }
+    }
+    return &m_blobPages.emplace(vPageIdx, std::move(page)).first->second;
+}
+
+void ValueViewer::m_drawBlob() {
+    ImGui::Text("BLOB of %zu bytes", m_blobSize);
+    if (m_isBlobLocated) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("(%s.%s, rowid %lld)", m_blobLocator.table.c_str(), m_blobLocator.column.c_str(), static_cast<long long>(m_blobLocator.rowid));
+    }
+    if (!m_blobErrorMsg.empty()) {
+        ImGui::TextColored(ImGui::CustomStyle::BadColor, "%s", m_blobErrorMsg.c_str());
+    }
+    if (!m_isBlobFormatKnown && m_blobErrorMsg.empty()) {
+        // the signature or the jsonb header is in the first page
+        const auto* pagePtr = m_getBlobPage(0U);
+        if (pagePtr != nullptr) {
+            const auto* bytes = reinterpret_cast<const uint8_t*>(pagePtr->data());
+            m_imageFormat = ImageDecoder::detectFormat(bytes, pagePtr->size());
+            m_isJson = JsonTree::isJsonb(bytes, pagePtr->size(), m_blobSize) && m_blobSize <= s_maxJsonbSize;
+            m_isBlobFormatKnown = true;
+        }
+    }
+    if (m_imageFormat != ImageDecoder::Format::NONE || m_isJson) {
+        if (ImGui::RadioButton(m_isJson ? "JSON" : "Image", !m_showHexa)) {
+            m_showHexa = false;
+        }
+        ImGui::SameLine();
+        if (ImGui::RadioButton("Hexa", m_showHexa)) {
+            m_showHexa = true;
+        }
+        if (!m_showHexa) {
+            if (m_isJson) {
+                ImGui::SameLine();
+                m_drawJson();
+            } else {
+                m_drawImage();
+            }
+            return;
+        }
+    }
+    if (ImGui::BeginChild("##BlobHexa", ImVec2(0.0f, 0.0f), ImGuiChildFlags_None, ImGuiWindowFlags_HorizontalScrollbar)) {
+        // offset, hexa by group of 8 bytes, then ascii at a fixed pos
+        char line[8U + 2U + s_bytesPerHexLine * 3U + 2U];
+        char hexa[s_bytesPerHexLine * 2U];
+        const float asciiPosX = ImGui::CalcTextSize("00000000  ").x + ImGui::CalcTextSize("00 ").x * static_cast<float>(s_bytesPerHexLine) + ImGui::CalcTextSize("  ").x;
+        const size_t linesCount = (m_blobSize + s_bytesPerHexLine - 1U) / s_bytesPerHexLine;
+        m_clipper.Begin(static_cast<int>(linesCount), ImGui::GetTextLineHeightWithSpacing());
+        while (m_clipper.Step()) {
+            for (int i = m_clipper.DisplayStart; i < m_clipper.DisplayEnd; ++i) {
+                const size_t offset = static_cast<size_t>(i) * s_bytesPerHexLine;
+                const auto* pagePtr = m_getBlobPage(offset / s_blobPageSize);
+                if (pagePtr == nullptr) {
+                    ImGui::TextDisabled("%08zx  ...", offset);
+                    continue;
+                }
+                const auto* bytes = reinterpret_cast<const uint8_t*>(pagePtr->data() + offset % s_blobPageSize);
+                const size_t count = std::min(s_bytesPerHexLine, m_blobSize - offset);
+                HexEncoder::encode(bytes, count, hexa);
+                char* cursor = line + snprintf(line, sizeof(line), "%08zx  ", offset);
+                for (size_t b = 0U; b < count; ++b) {
+                    *cursor++ = hexa[b * 2U];
+                    *cursor++ = hexa[b * 2U + 1U];
+                    *cursor++ = ' ';
+                    if (b == 7U) {
+                        *cursor++ = ' ';
+                    }
+                }
+                ImGui::TextUnformatted(line, cursor);
+                char ascii[s_bytesPerHexLine];
+                for (size_t b = 0U; b < count; ++b) {
+                    ascii[b] = (bytes[b] >= 0x20 && bytes[b] < 0x7F) ? static_cast<char>(bytes[b]) : '.';
+                }
+                ImGui::SameLine(asciiPosX);
+                ImGui::TextUnformatted(ascii, ascii + count);
+            }
+        }
+    }
+    ImGui::EndChild();
+}
+
+// the decoded image stay in the cache, so a cell shown again cost nothing
+void ValueViewer::m_drawImage() {
+    const auto* pEntry = m_imageCache.get(m_imageKey);
+    if (pEntry == nullptr) {
+        if (m_isBlobLocated) {
+            pEntry = &m_imageCache.request(m_imageKey, m_blobLocator, m_blobSize);
+        } else {
+            std::string datas;
+            datas.reserve(m_blobSize);
+            for (const auto& page : m_blobPages) {
+                datas += page.second;
+            }
+            pEntry = &m_imageCache.request(m_imageKey, std::move(datas));
+        }
+    }
+    const char* formatName = ImageDecoder::getFormatName(m_imageFormat);
+    if (pEntry->state == ImageTextureCache::State::DECODING) {
+        ImGui::TextDisabled("Decoding the %s image..", formatName);
+        return;
+    } else if (pEntry->state == ImageTextureCache::State::FAILED) {
+        ImGui::TextColored(ImGui::CustomStyle::BadColor, "%s image : %s", formatName, pEntry->errorMsg.c_str());
+        return;
+    }
+    ImGui::Text("%s image of %ix%i", formatName, pEntry->imageWidth, pEntry->imageHeight);
+    if (pEntry->textureWidth != pEntry->imageWidth) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("(previewed in %ix%i)", pEntry->textureWidth, pEntry->textureHeight);
+    }
+    if (ImGui::BeginChild("##BlobImage", ImVec2(0.0f, 0.0f), ImGuiChildFlags_None, ImGuiWindowFlags_HorizontalScrollbar)) {
+        // reduced to fit the pane, never enlarged
+        const ImVec2 avail = ImGui::GetContentRegionAvail();
+        const ImVec2 size(static_cast<float>(pEntry->textureWidth), static_cast<float>(pEntry->textureHeight));
+        const float scale = std::min(1.0f, std::min(avail.x / size.x, avail.y / size.y));
+        ImTextureRef ref;
+        ref._TexID = static_cast<ImTextureID>(pEntry->texture);
+        ImGui::Image(ref, ImVec2(std::max(size.x * scale, 1.0f), std::max(size.y * scale, 1.0f)));
+    }
+    ImGui::EndChild();
+}
+
+// the blob is read in one piece, and the index of the tree is built, in a worker.
+// the text is copied, the job can end after the value is changed
+void ValueViewer::m_loadJson() {
+    auto pLoading = std::make_shared<JsonLoading>();
+    if (!m_isBlob) {
+        pLoading->datas = m_text;
+        pLoading->encoding = JsonTree::Encoding::TEXT;
+    } else {
+        pLoading->encoding = JsonTree::Encoding::JSONB;
+        pLoading->isLocated = m_isBlobLocated;
+        pLoading->locator = m_blobLocator;
+        pLoading->size = m_blobSize;
+        if (!m_isBlobLocated) {  // all the pages are loaded
+            pLoading->datas.reserve(m_blobSize);
+            for (const auto& page : m_blobPages) {
+                pLoading->datas += page.second;
+            }
+        }
+    }
+    m_jsonLoading = pLoading;
+    m_jsonJob = JobManager::ref().pushJob(  //
+        Job::Priority::INTERACTIVE,
+        [pLoading](Job& vJob) {
+            auto& loading = *pLoading;
+            if (loading.isLocated && !s_readLocated(loading.locator, loading.size, vJob, loading.datas, &loading.errorMsg)) {
+                return;
+            }
+            if (vJob.isCancelRequested()) {
+                return;
+            }
+            if (!loading.tree.build(loading.datas, loading.encoding, &loading.errorMsg)) {
+                loading.tree.clear();
+            }
+        },
+        [this, pLoading](Job& vJob) {
+            if (m_jsonLoading != pLoading) {
+                return;  // the value was changed
+            }
+            m_jsonJob.reset();
+            if (vJob.getState() == Job::State::CANCELED) {
+                m_jsonLoading.reset();  // loaded again at the next draw
+                return;
+            }
+            m_jsonViewer.setTree(std::move(pLoading->tree), pLoading->errorMsg);
+        });
+}
+
+void ValueViewer::m_drawJson() {
+    if (m_jsonLoading == nullptr) {
+        m_loadJson();
+    }
+    if (m_jsonJob != nullptr) {
+        ImGui::TextDisabled(m_isBlobLocated ? "Reading the blob.." : "Loading the tree..");
+        return;
+    }
+    m_jsonViewer.draw();
+}
+
+void ValueViewer::m_drawText() {
+    ImGui::SetNextItemWidth(200.0f);
+    if (ImGui::InputTextWithHint("##search", "Search", m_searchBuffer, sizeof(m_searchBuffer), ImGuiInputTextFlags_EnterReturnsTrue)) {
+        m_find(true);
+    }
+    ImGui::SameLine();
+    if (ImGui::SmallContrastedButton("<")) {
+        m_find(false);
+    }
+    ImGui::SameLine();
+    if (ImGui::SmallContrastedButton(">")) {
+        m_find(true);
+    }
+    if (m_matchNotFound) {
+        ImGui::SameLine();
+        ImGui::TextColored(ImGui::CustomStyle::BadColor, "Not found");
+    }
+    ImGui::SameLine();
+    if (ImGui::Checkbox("Word wrap", &m_wordWrap)) {
+        m_wrapWidth = -1.0f;
+    }
+    ImGui::SameLine();
+    if (ImGui::SmallContrastedButton("Copy")) {
+        ImGui::SetClipboardText(m_text.c_str());
+    }
+    ImGui::SameLine();
+    ImGui::TextDisabled("%zu bytes", m_text.size());
+
+    if (ImGui::BeginChild("##ValueText", ImVec2(0.0f, 0.0f), ImGuiChildFlags_None, m_wordWrap ? ImGuiWindowFlags_None : ImGuiWindowFlags_HorizontalScrollbar)) {
+        if (m_wordWrap) {
+            const float width = ImGui::GetContentRegionAvail().x;
+            if (m_wrapWidth < 0.0f || std::abs(width - m_wrapWidth) >= 1.0f) {  // built again on resize
+                m_resetWrappedLines(width);
+            }
+            m_wrapLines();
+        }
+        const auto& lineStarts = m_wordWrap ? m_wrappedLineStarts : m_lineStarts;
+        const float lineHeight = ImGui::GetTextLineHeightWithSpacing();
+        // a match not yet wrapped is scrolled to in a next frame
+        const bool isMatchWrapped = !m_wordWrap || m_wrapNextLine >= m_lineStarts.size() || m_matchPos < m_lineStarts[m_wrapNextLine];
+        if (m_scrollToMatch && m_matchPos != std::string::npos && isMatchWrapped) {
+            const auto it = std::upper_bound(lineStarts.begin(), lineStarts.end(), m_matchPos);
+            const auto lineIdx = static_cast<float>(std::max<ptrdiff_t>(it - lineStarts.begin() - 1, 0));
+            ImGui::SetScrollY(std::max(lineIdx * lineHeight - ImGui::GetWindowHeight() * 0.5f, 0.0f));
+            m_scrollToMatch = false;
+        }
+        const char* text = m_text.data();
+        m_clipper.Begin(static_cast<int>(lineStarts.size()), lineHeight);
+        while (m_clipper.Step()) {
+            for (int i = m_clipper.DisplayStart; i < m_clipper.DisplayEnd; ++i) {
+                const size_t idx = static_cast<size_t>(i);
+                const size_t begin = lineStarts[idx];
+                const size_t end = m_wordWrap ? m_wrappedLineEnds[idx] : m_getLineEnd(lineStarts, idx);
+                if (m_matchPos != std::string::npos && m_matchPos >= begin && m_matchPos < std::max(end, begin + 1U)) {
+                    // highlight of the match, on its first line
+                    const ImVec2 pos = ImGui::GetCursorScreenPos();
+                    const float x0 = ImGui::CalcTextSize(text + begin, text + m_matchPos).x;
+                    const float x1 = ImGui::CalcTextSize(text + begin, text + std::min(m_matchPos + m_matchSize, end)).x;
+                    ImGui::GetWindowDrawList()->AddRectFilled(  //
+                        ImVec2(pos.x + x0, pos.y),
+                        ImVec2(pos.x + std::max(x1, x0 + 2.0f), pos.y + ImGui::GetTextLineHeight()),
+                        ImGui::GetColorU32(ImGuiCol_TextSelectedBg));
+                }
+                ImGui::TextUnformatted(text + begin, text + end);
+            }
+        }
+    }
+    ImGui::EndChild();
+}
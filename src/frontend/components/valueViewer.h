@@ -0,0 +1,124 @@
+/*
+ * This file is part of ezSqlite.
+ *
+ * Copyright (C) 2025 Stephane Cuillerdier (Aka aiekick)
+ *
+ * ezSqlite is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ezSqlite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ezSqlite.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <imguipack.h>
+#include <backend/helpers/dbHelper.h>
+#include <backend/helpers/imageDecoder.h>
+#include <backend/managers/jobManager.h>
+#include <frontend/components/imageTextureCache.h>
+#include <frontend/components/jsonViewer.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+
+// viewer of a cell value of any size. the line starts are indexed once, and only the visible lines are drawn.
+// very long lines are cut in chunks, so a line never cost more than a chunk to draw.
+// a big text not loaded with the result is read from the database, and indexed, in a worker.
+// a blob is shown in hexa, and read by pages from the database if it was not loaded with the result.
+// a png, jpeg or bmp blob is also shown as an image, decoded in a worker.
+// an object or an array in json, or a jsonb blob, is also shown as a tree expanded on demand
+class ValueViewer {
+private:
+    static const size_t s_maxLineSize;  // bytes
+    static const size_t s_wrapBytesPerFrame;  // the wrap of a big text is spread on the frames
+    static const size_t s_blobPageSize;  // multiple of the bytes per hexa line
+    static const size_t s_maxBlobPages;  // the farthest page from the needed one is dropped
+    static const size_t s_bytesPerHexLine;
+    static const size_t s_maxJsonbSize;  // a jsonb blob is read in full for its tree
+    // the full text and its lines, filled by a job
+    struct TextLoading {
+        BlobLocator locator;
+        size_t size{0U};
+        std::string text;
+        std::vector<size_t> lineStarts;
+        bool isJson{false};
+        std::string errorMsg;
+    };
+    // the datas of the json tree and the tree, filled by a job
+    struct JsonLoading {
+        std::string datas;  // a copy of the text, or the jsonb blob
+        bool isLocated{false};  // the blob is read by the job
+        BlobLocator locator;
+        size_t size{0U};
+        JsonTree::Encoding encoding{JsonTree::Encoding::TEXT};
+        JsonTree tree;
+        std::string errorMsg;
+    };
+    bool m_isBlob{false};
+    BlobLocator m_blobLocator;
+    bool m_isBlobLocated{false};  // else all the pages are loaded
+    size_t m_blobSize{0U};
+    std::map<size_t, std::string> m_blobPages;  // by page index
+    std::string m_blobErrorMsg;
+    ImageTextureCache m_imageCache;  // valid for one result, the keys are its cells
+    ImageTextureCache::Key m_imageKey{-1, -1};
+    ImageDecoder::Format m_imageFormat{ImageDecoder::Format::NONE};
+    bool m_isBlobFormatKnown{false};  // the first page of a located blob is needed
+    bool m_showHexa{false};  // else the image or the json tree, kept for the next selections
+    JsonViewer m_jsonViewer;  // on the datas of m_jsonLoading
+    std::shared_ptr<JsonLoading> m_jsonLoading;  // started at the first draw of the tree
+    JobPtr m_jsonJob;  // running while the tree is loading
+    bool m_isJson{false};  // json text or jsonb blob
+    bool m_showRawJson{false};  // else the tree, kept for the next selections
+    std::shared_ptr<TextLoading> m_textLoading;  // while the text is read
+    JobPtr m_textJob;
+    std::string m_textErrorMsg;
+    std::string m_text;
+    std::vector<size_t> m_lineStarts;  // offsets of the lines in m_text, with the chunks of the long lines
+    std::vector<size_t> m_wrappedLineStarts;  // the lines cut for m_wrapWidth
+    std::vector<size_t> m_wrappedLineEnds;
+    float m_wrapWidth{-1.0f};  // width of m_wrappedLineStarts, -1 if to build
+    size_t m_wrapNextLine{0U};  // in m_lineStarts, the first line not yet wrapped
+    bool m_wordWrap{false};
+    char m_searchBuffer[256]{};
+    size_t m_matchPos{std::string::npos};
+    size_t m_matchSize{0U};
+    bool m_scrollToMatch{false};
+    bool m_matchNotFound{false};
+    ImGuiListClipper m_clipper;
+
+public:
+    void setText(std::string&& vText);
+    void setText(const BlobLocator& vLocator, const size_t vSize);  // read on demand
+    void setBlob(std::string&& vDatas, const ImageTextureCache::Key& vImageKey);  // already loaded
+    void setBlob(const BlobLocator& vLocator, const size_t vSize, const ImageTextureCache::Key& vImageKey);  // read on demand
+    void setBlobError(const size_t vSize, const std::string& vErrorMsg);  // can't be read
+    void clear();
+    void clearImages();  // when the result change, in the ui thread
+    bool isEmpty() const { return m_text.empty() && !m_isBlob && m_textLoading == nullptr; }
+    const std::string& getText() const { return m_text; }
+    void draw();
+
+private:
+    void m_drawText();
+    void m_drawBlob();
+    void m_drawImage();
+    void m_drawJson();
+    void m_loadJson();
+    const std::string* m_getBlobPage(const size_t vPageIdx);  // nullptr if not readed yet
+    void m_resetWrappedLines(const float vWidth);
+    void m_wrapLines();  // a slice of the lines by frame
+    void m_find(const bool vForward);
+    size_t m_getLineEnd(const std::vector<size_t>& vLineStarts, const size_t vIdx) const;  // without the end of line
+};
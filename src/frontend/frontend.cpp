@@ -25,12 +25,19 @@
 #include <headers/ezSqliteBuild.h>
 
 #include <backend/managers/dbManager.h>
+#include <backend/helpers/dbBackup.h>
+#include <backend/helpers/blobTransfer.h>
+#include <backend/helpers/csvImporter.h>
+#include <backend/helpers/frameScheduler.h>
 #include <backend/controller/controller.h>
 
 #include <frontend/panes/messagePane.h>
 #include <frontend/panes/codeEditorPane.h>
 #include <frontend/panes/dbStructurePane.h>
 #include <frontend/panes/queryHistoryPane.h>
+#include <frontend/panes/queryProfilerPane.h>
+#include <frontend/panes/queryPlansPane.h>
+#include <frontend/panes/indexAdvisorPane.h>
 #include <frontend/panes/queryResultsTablePane.h>
 #include <frontend/panes/queryResultsValuePane.h>
 
@@ -67,6 +74,9 @@ bool Frontend::init() {
     DBStructurePane::initSingleton();
     QueryHistoryPane::initSingleton();
     QueryResultsTablePane::initSingleton();
+    QueryProfilerPane::initSingleton();
+    QueryPlansPane::initSingleton();
+    IndexAdvisorPane::initSingleton();
     QueryResultsValuePane::initSingleton();
     MessagePane::initSingleton();
 
@@ -75,6 +85,9 @@ bool Frontend::init() {
 
     // Views
     LayoutManager::ref().AddPane(QueryResultsTablePane::ref(), "Results", "", "CENTRAL", 0.0f, true, false);
+    LayoutManager::ref().AddPane(QueryProfilerPane::ref(), "Profiler", "", "CENTRAL", 0.0f, true, false);
+    LayoutManager::ref().AddPane(QueryPlansPane::ref(), "Plans", "", "CENTRAL", 0.0f, true, false);
+    LayoutManager::ref().AddPane(IndexAdvisorPane::ref(), "Index advisor", "", "CENTRAL", 0.0f, true, false);
     LayoutManager::ref().AddPane(MessagePane::ref(), "Console", "", "BOTTOM", 0.25f, false, false);
     LayoutManager::ref().AddPane(CodeEditorPane::ref(), "Editor", "", "TOP", 0.25f, true, true);
     LayoutManager::ref().AddPane(DBStructurePane::ref(), "Structure", "", "LEFT", 0.25f, true, false);
@@ -100,6 +113,9 @@ void Frontend::unit() {
     QueryHistoryPane::unitSingleton();
     QueryResultsValuePane::unitSingleton();
     QueryResultsTablePane::unitSingleton();
+    QueryProfilerPane::unitSingleton();
+    QueryPlansPane::unitSingleton();
+    IndexAdvisorPane::unitSingleton();
     MessagePane::unitSingleton();
 }
 
@@ -269,13 +285,31 @@ void Frontend::m_drawMainMenuBar() {
                 ActionMenuOpenDatabase();
             }
 
+            ImGui::Separator();
+
+            if (ImGui::MenuItem(" New in-memory database")) {
+                ActionMenuNewMemoryDatabase();
+            }
+
+            if (ImGui::MenuItem(" Load database in memory")) {
+                ActionMenuLoadDatabaseInMemory();
+            }
+
             if (DBManager::ref().isDatabaseLoaded()) {
                 ImGui::Separator();
 
-                if (ImGui::MenuItem(" Reopen database")) {
+                if (DBManager::ref().isDatabaseInMemory()) {
+                    if (ImGui::MenuItem(" Save memory database to file", nullptr, false, !DBBackup::ref().isRunning())) {
+                        ActionMenuSaveMemoryDatabase();
+                    }
+                } else if (ImGui::MenuItem(" Reopen database")) {
                     ActionMenuReOpenDatabase();
                 }
 
+                if (ImGui::MenuItem(" Import CSV", nullptr, false, !CsvImporter::ref().isRunning())) {
+                    ActionMenuImportDatas();
+                }
+
                 ImGui::Separator();
 
                 if (ImGui::MenuItem(" Close database")) {
@@ -303,6 +337,23 @@ void Frontend::m_drawMainMenuBar() {
         }
         */
 
+        if (ImGui::BeginMenu("Settings")) {
+            auto& scheduler = FrameScheduler::ref();
+            bool eventDriven = scheduler.isEventDriven();
+            if (ImGui::MenuItem("Event driven rendering", nullptr, &eventDriven)) {
+                scheduler.setEventDriven(eventDriven);
+            }
+            if (ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("Draw only on inputs and background works.\nElse a frame is drawn at each vsync");
+            }
+            int32_t busyFps = scheduler.getBusyFps();
+            ImGui::SetNextItemWidth(100.0f);
+            if (ImGui::SliderInt("Frame rate during jobs", &busyFps, 1, 120)) {
+                scheduler.setBusyFps(busyFps);
+            }
+            ImGui::EndMenu();
+        }
+
         if (ImGui::BeginMenu("Help")) {
             if (ImGui::MenuItem(" About")) {
                 m_showAboutDialog = true;
@@ -344,6 +395,73 @@ void Frontend::m_drawMainStatusBar() {
     if (ImGui::BeginMainStatusBar()) {
         Messaging::ref().DrawStatusBar();
 
+        auto& importer = CsvImporter::ref();
+        if (importer.isRunning()) {
+            ImGui::Separator();
+            ImGui::Text("Import %s", importer.getFilePathName().c_str());
+            ImGui::ProgressBar(importer.getProgress(), ImVec2(150.0f, 0.0f));
+            ImGui::Text(  //
+                "%zu rows (%.0f rows/s, %.1f MB/s)",
+                importer.getRowsCount(),
+                importer.getRowsPerSecond(),
+                importer.getMegaBytesPerSecond());
+            if (ImGui::SmallContrastedButton("Cancel##import")) {
+                importer.cancel();
+            }
+        }
+
+        auto& backup = DBBackup::ref();
+        if (backup.isRunning()) {
+            ImGui::Separator();
+            if (backup.getOperation() == DBBackup::Operation::LOAD_IN_MEMORY) {
+                ImGui::Text("Load in memory %s", backup.getFilePathName().c_str());
+            } else {
+                ImGui::Text("Save memory in %s", backup.getFilePathName().c_str());
+            }
+            ImGui::ProgressBar(backup.getProgress(), ImVec2(150.0f, 0.0f));
+            if (ImGui::SmallContrastedButton("Cancel##backup")) {
+                backup.cancel();
+            }
+        }
+
+        auto& transfer = BlobTransfer::ref();
+        if (transfer.isRunning()) {
+            ImGui::Separator();
+            if (transfer.getOperation() == BlobTransfer::Operation::SAVE_TO_FILE) {
+                ImGui::Text("Save cell in %s", transfer.getFilePathName().c_str());
+            } else {
+                ImGui::Text("Load %s in cell", transfer.getFilePathName().c_str());
+            }
+            ImGui::ProgressBar(transfer.getProgress(), ImVec2(150.0f, 0.0f));
+            const double elapsedSec = transfer.getElapsedMs() / 1000.0;
+            const double doneMB = static_cast<double>(transfer.getBytesDone()) / (1024.0 * 1024.0);
+            ImGui::Text(  //
+                "%.1f / %.1f MB (%.1f MB/s)",
+                doneMB,
+                static_cast<double>(transfer.getBytesCount()) / (1024.0 * 1024.0),
+                (elapsedSec > 0.0) ? doneMB / elapsedSec : 0.0);
+            if (ImGui::SmallContrastedButton("Cancel##blob")) {
+                transfer.cancel();
+            }
+        }
+
+        auto& exporter = ResultExporter::ref();
+        if (exporter.isRunning()) {
+            ImGui::Separator();
+            ImGui::Text("Export %s", exporter.getFilePathName().c_str());
+            if (exporter.getProgress() > 0.0f) {
+                ImGui::ProgressBar(exporter.getProgress(), ImVec2(150.0f, 0.0f));
+            }
+            ImGui::Text(  //
+                "%zu rows, %.1f MB (%.0f rows/s)",
+                exporter.getRowsCount(),
+                static_cast<double>(exporter.getBytesCount()) / (1024.0 * 1024.0),
+                exporter.getRowsPerSecond());
+            if (ImGui::SmallContrastedButton("Cancel##export")) {
+                exporter.cancel();
+            }
+        }
+
 #ifdef _DEBUG
         const auto& io = ImGui::GetIO();
         const auto fps = ez::str::toStr("%.1f ms/frame (%.1f fps)", 1000.0f / io.Framerate, io.Framerate);
@@ -402,16 +520,88 @@ void Frontend::ActionMenuOpenDatabase() {
     m_actionsSystem.pushBackConditonalAction([this]() { return m_displayOpenDatabaseDialog(); });
 }
 
+void Frontend::ActionMenuNewMemoryDatabase() {
+    m_actionsSystem.clear();
+    m_actionsSystem.pushBackConditonalAction([]() {
+        Backend::ref().NeedToNewMemoryDatabase();
+        return true;
+    });
+}
+
+void Frontend::ActionMenuLoadDatabaseInMemory() {
+    m_actionsSystem.clear();
+    m_actionsSystem.pushBackConditonalAction([this]() {
+        IGFD::FileDialogConfig config;
+        config.countSelectionMax = 1;
+        config.flags = ImGuiFileDialogFlags_Modal;
+        ImGuiFileDialog::ref().OpenDialog("LoadDatabaseInMemoryDlg", "Load Database File in Memory", "Any files{((.*))}", config);
+        return true;
+    });
+    m_actionsSystem.pushBackConditonalAction([this]() { return m_displayLoadDatabaseInMemoryDialog(); });
+}
+
+void Frontend::ActionMenuSaveMemoryDatabase() {
+    m_actionsSystem.clear();
+    m_actionsSystem.pushBackConditonalAction([this]() {
+        IGFD::FileDialogConfig config;
+        config.countSelectionMax = 1;
+        config.flags = ImGuiFileDialogFlags_Modal | ImGuiFileDialogFlags_ConfirmOverwrite;
+        ImGuiFileDialog::ref().OpenDialog("SaveMemoryDatabaseDlg", "Save Memory Database in File", "Any files{((.*))}", config);
+        return true;
+    });
+    m_actionsSystem.pushBackConditonalAction([this]() { return m_displaySaveMemoryDatabaseDialog(); });
+}
+
 void Frontend::ActionMenuImportDatas() {
     m_actionsSystem.clear();
     m_actionsSystem.pushBackConditonalAction([this]() {
         IGFD::FileDialogConfig config;
-        config.countSelectionMax = 0;
+        config.countSelectionMax = 1;
         config.flags = ImGuiFileDialogFlags_Modal;
-        ImGuiFileDialog::ref().OpenDialog("Import Datas", "Import Datas from File", ".csv", config);
+        ImGuiFileDialog::ref().OpenDialog("ImportDatasDlg", "Import Datas from File", "CSV files{.csv,.tsv,.txt}", config);
         return true;
     });
-    m_actionsSystem.pushBackConditonalAction([this]() { return m_displayOpenDatabaseDialog(); });
+    m_actionsSystem.pushBackConditonalAction([this]() { return m_displayImportDatasDialog(); });
+}
+
+void Frontend::ActionMenuExportResults(const ResultExporter::Format vFormat) {
+    m_actionsSystem.clear();
+    m_actionsSystem.pushBackConditonalAction([vFormat]() {
+        IGFD::FileDialogConfig config;
+        config.countSelectionMax = 1;
+        config.flags = ImGuiFileDialogFlags_Modal | ImGuiFileDialogFlags_ConfirmOverwrite;
+        ImGuiFileDialog::ref().OpenDialog(  //
+            "ExportResultsDlg",
+            std::string("Export Results in ") + ResultExporter::getFormatName(vFormat),
+            ResultExporter::getFormatFilter(vFormat),
+            config);
+        return true;
+    });
+    m_actionsSystem.pushBackConditonalAction([this, vFormat]() { return m_displayExportResultsDialog(vFormat); });
+}
+
+void Frontend::ActionMenuSaveCellToFile(const BlobLocator& vLocator) {
+    m_actionsSystem.clear();
+    m_actionsSystem.pushBackConditonalAction([]() {
+        IGFD::FileDialogConfig config;
+        config.countSelectionMax = 1;
+        config.flags = ImGuiFileDialogFlags_Modal | ImGuiFileDialogFlags_ConfirmOverwrite;
+        ImGuiFileDialog::ref().OpenDialog("SaveCellToFileDlg", "Save Cell in File", "Any files{((.*))}", config);
+        return true;
+    });
+    m_actionsSystem.pushBackConditonalAction([this, vLocator]() { return m_displaySaveCellToFileDialog(vLocator); });
+}
+
+void Frontend::ActionMenuLoadFileIntoCell(const BlobLocator& vLocator) {
+    m_actionsSystem.clear();
+    m_actionsSystem.pushBackConditonalAction([]() {
+        IGFD::FileDialogConfig config;
+        config.countSelectionMax = 1;
+        config.flags = ImGuiFileDialogFlags_Modal;
+        ImGuiFileDialog::ref().OpenDialog("LoadFileIntoCellDlg", "Load File in Cell", "Any files{((.*))}", config);
+        return true;
+    });
+    m_actionsSystem.pushBackConditonalAction([this, vLocator]() { return m_displayLoadFileIntoCellDialog(vLocator); });
 }
 
 void Frontend::ActionMenuReOpenDatabase() {
@@ -521,6 +711,142 @@ bool Frontend::m_displayOpenDatabaseDialog() {
     return false;
 }
 
+bool Frontend::m_displayLoadDatabaseInMemoryDialog() {
+    // need to return false to continue to be displayed next frame
+
+    ImVec2 max = m_displayRect.GetSize();
+    ImVec2 min = max * 0.5f;
+
+    if (ImGuiFileDialog::ref().Display("LoadDatabaseInMemoryDlg", ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoDocking, min, max)) {
+        if (ImGuiFileDialog::ref().IsOk()) {
+            Backend::ref().NeedToLoadDatabaseInMemory(ImGuiFileDialog::ref().GetFilePathName());
+        } else {             // cancel
+            m_actionCancel();  // we interrupts all actions
+        }
+
+        ImGuiFileDialog::ref().Close();
+
+        return true;
+    }
+
+    return false;
+}
+
+bool Frontend::m_displaySaveMemoryDatabaseDialog() {
+    // need to return false to continue to be displayed next frame
+
+    ImVec2 max = m_displayRect.GetSize();
+    ImVec2 min = max * 0.5f;
+
+    if (ImGuiFileDialog::ref().Display("SaveMemoryDatabaseDlg", ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoDocking, min, max)) {
+        if (ImGuiFileDialog::ref().IsOk()) {
+            if (!DBManager::ref().saveMemoryDatabaseToFile(ImGuiFileDialog::ref().GetFilePathName())) {
+                LogVarError("Failed to start the save of the memory database");
+            }
+        } else {             // cancel
+            m_actionCancel();  // we interrupts all actions
+        }
+
+        ImGuiFileDialog::ref().Close();
+
+        return true;
+    }
+
+    return false;
+}
+
+bool Frontend::m_displayImportDatasDialog() {
+    // need to return false to continue to be displayed next frame
+
+    ImVec2 max = m_displayRect.GetSize();
+    ImVec2 min = max * 0.5f;
+
+    if (ImGuiFileDialog::ref().Display("ImportDatasDlg", ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoDocking, min, max)) {
+        if (ImGuiFileDialog::ref().IsOk()) {
+            if (!Controller::ref().importCsvFile(ImGuiFileDialog::ref().GetFilePathName())) {
+                LogVarError("An import is already running");
+            }
+        } else {             // cancel
+            m_actionCancel();  // we interrupts all actions
+        }
+
+        ImGuiFileDialog::ref().Close();
+
+        return true;
+    }
+
+    return false;
+}
+
+bool Frontend::m_displayExportResultsDialog(const ResultExporter::Format vFormat) {
+    // need to return false to continue to be displayed next frame
+
+    ImVec2 max = m_displayRect.GetSize();
+    ImVec2 min = max * 0.5f;
+
+    if (ImGuiFileDialog::ref().Display("ExportResultsDlg", ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoDocking, min, max)) {
+        if (ImGuiFileDialog::ref().IsOk()) {
+            if (!Controller::ref().exportResults(ImGuiFileDialog::ref().GetFilePathName(), vFormat)) {
+                LogVarError("An export is already running");
+            }
+        } else {             // cancel
+            m_actionCancel();  // we interrupts all actions
+        }
+
+        ImGuiFileDialog::ref().Close();
+
+        return true;
+    }
+
+    return false;
+}
+
+bool Frontend::m_displaySaveCellToFileDialog(const BlobLocator& vLocator) {
+    // need to return false to continue to be displayed next frame
+
+    ImVec2 max = m_displayRect.GetSize();
+    ImVec2 min = max * 0.5f;
+
+    if (ImGuiFileDialog::ref().Display("SaveCellToFileDlg", ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoDocking, min, max)) {
+        if (ImGuiFileDialog::ref().IsOk()) {
+            if (!Controller::ref().saveCellToFile(vLocator, ImGuiFileDialog::ref().GetFilePathName())) {
+                LogVarError("A cell transfer is already running");
+            }
+        } else {             // cancel
+            m_actionCancel();  // we interrupts all actions
+        }
+
+        ImGuiFileDialog::ref().Close();
+
+        return true;
+    }
+
+    return false;
+}
+
+bool Frontend::m_displayLoadFileIntoCellDialog(const BlobLocator& vLocator) {
+    // need to return false to continue to be displayed next frame
+
+    ImVec2 max = m_displayRect.GetSize();
+    ImVec2 min = max * 0.5f;
+
+    if (ImGuiFileDialog::ref().Display("LoadFileIntoCellDlg", ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoDocking, min, max)) {
+        if (ImGuiFileDialog::ref().IsOk()) {
+            if (!Controller::ref().loadFileIntoCell(vLocator, ImGuiFileDialog::ref().GetFilePathName())) {
+                LogVarError("A cell transfer is already running");
+            }
+        } else {             // cancel
+            m_actionCancel();  // we interrupts all actions
+        }
+
+        ImGuiFileDialog::ref().Close();
+
+        return true;
+    }
+
+    return false;
+}
+
 ///////////////////////////////////////////////////////
 //// APP CLOSING //////////////////////////////////////
 ///////////////////////////////////////////////////////
@@ -28,6 +28,9 @@
 #include <ezlibs/ezXmlConfig.hpp>
 #include <ezlibs/ezSingleton.hpp>
 
+#include <backend/helpers/dbHelper.h>
+#include <backend/helpers/resultExporter.h>
+
 #include <functional>
 #include <string>
 #include <vector>
@@ -65,7 +68,13 @@ public:
 
     void ActionMenuNewDatabase();
     void ActionMenuOpenDatabase();
+    void ActionMenuNewMemoryDatabase();
+    void ActionMenuLoadDatabaseInMemory();
+    void ActionMenuSaveMemoryDatabase();
     void ActionMenuImportDatas();
+    void ActionMenuExportResults(const ResultExporter::Format vFormat);
+    void ActionMenuSaveCellToFile(const BlobLocator& vLocator);
+    void ActionMenuLoadFileIntoCell(const BlobLocator& vLocator);
     void ActionMenuReOpenDatabase();
     void ActionMenuCloseDatabase();
     void ActionWindowCloseApp();
@@ -77,6 +86,12 @@ private:  // actions
     void m_actionCancel();
     bool m_displayNewDatabaseDialog();
     bool m_displayOpenDatabaseDialog();
+    bool m_displayLoadDatabaseInMemoryDialog();
+    bool m_displaySaveMemoryDatabaseDialog();
+    bool m_displayImportDatasDialog();
+    bool m_displayExportResultsDialog(const ResultExporter::Format vFormat);
+    bool m_displaySaveCellToFileDialog(const BlobLocator& vLocator);
+    bool m_displayLoadFileIntoCellDialog(const BlobLocator& vLocator);
     bool m_build();
     bool m_build_themes();
     void m_drawMainMenuBar();
@@ -31,7 +31,7 @@ typedef std::string DBFile;
 typedef uint32_t RowID;
 typedef int64_t DateEpoch;
 
-enum class SqliteType {  //
+enum class SqliteType : uint8_t {  //
     TYPE_INTEGER = 0,
     TYPE_REAL,
     TYPE_TEXT,